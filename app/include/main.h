@@ -30,6 +30,9 @@ struct NoiseLayer {
 	//Returns 0-scale
 	f32 sample(oi::Vec3 pos, f32 current);
 
+	//Applies the min value, scale and mask to a noise value
+	f32 apply(f32 value, f32 mask);
+
 	ose(NoiseLayer, 0, offset, octaves, persistence, roughness, scale, frequency, minValue, enabled, maskLand);
 
 };
@@ -45,6 +48,9 @@ struct Planet {
 	//Returns 0-1 for a point on the planet
 	f32 sample(oi::Vec3 pos);
 
+	//Samples count points at once; layer by layer with the bulk noise functions
+	void sample(const oi::Vec3 *pos, f32 *out, u32 count);
+
 	void seed();
 
 	ose(Planet, 0, minHeight, scale, coastSize, randomize, noiseLayer);
@@ -72,6 +78,9 @@ protected:
 	void readPlanets(bool fromResource, oi::gc::MeshAllocationInfo &mai);
 	void writePlanets();
 
+	//Times reading and writing a generated planets file with JSON and JSONStream
+	void benchmarkJSON();
+
 	void refreshPlanetMesh(bool fromResource);
 
 private:
@@ -89,6 +98,8 @@ private:
 	oi::gc::MaterialRef water, rock;
 	oi::gc::TextureRef twater, trock;
 
+	oi::gc::ShaderBufferHandle timeHandle, exposureHandle, gammaHandle;
+
 	float exposure = .15f, gamma = .85f, camSpeed = 0.5f;
 	oi::Vec2 prevMouse;
 
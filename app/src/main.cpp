@@ -1,5 +1,6 @@
 #include "main.h"
 #include "utils/random.h"
+#include "utils/jsonstream.h"
 #include "file/filemanager.h"
 #include "math/simplexnoise.h"
 #include "window/windowmanager.h"
@@ -27,7 +28,10 @@ void Application::instantiate(AppExt *param){
 //Set up the interface
 
 f32 NoiseLayer::sample(Vec3 pos, f32 mask) {
-	f32 value = SimplexNoise::noise(pos, offset, octaves, persistence, roughness, frequency);
+	return apply(SimplexNoise::noise(pos, offset, octaves, persistence, roughness, frequency), mask);
+}
+
+f32 NoiseLayer::apply(f32 value, f32 mask) {
 	return value > minValue ? (value - minValue) * scale * (maskLand ? mask : 1) : 0;
 }
 
@@ -43,6 +47,32 @@ f32 Planet::sample(Vec3 pos) {
 
 }
 
+void Planet::sample(const Vec3 *pos, f32 *out, u32 count) {
+
+	std::vector<Vec3> offsetPos(count);
+	std::vector<f32> value(count);
+
+	for (u32 i = 0; i < count; ++i) {
+		offsetPos[i] = pos[i] + offset;
+		out[i] = minHeight;
+	}
+
+	for (NoiseLayer &layer : noiseLayer) {
+
+		if (!layer.enabled)
+			continue;
+
+		SimplexNoise::noiseParallel(offsetPos.data(), value.data(), count, layer.offset, layer.octaves, layer.persistence, layer.roughness, layer.frequency);
+
+		for (u32 i = 0; i < count; ++i)
+			out[i] += layer.apply(value[i], std::clamp((out[i] + 0.5f) / coastSize, 0.f, 1.f));
+	}
+
+	for (u32 i = 0; i < count; ++i)
+		out[i] *= scale;
+
+}
+
 void Planet::seed() {
 	if (randomize)
 		offset = Random::randomize<3>(-50000.f, 50000.f);
@@ -90,6 +120,9 @@ void MainInterface::refreshPlanet(Planet planet, MeshAllocationInfo &mai) {
 	f32 *avertex = vertex.data();
 	u32 *aindex = index.data();
 
+	std::vector<Vec3> spherePos(vertices);
+	std::vector<f32> height(vertices);
+
 	planet.seed();
 
 	for (u32 i = 0; i < vertices; ++i) {
@@ -106,9 +139,8 @@ void MainInterface::refreshPlanet(Planet planet, MeshAllocationInfo &mai) {
 		Vec2 xy = uv * 2.f - 1.f;
 
 		Vec3 cpos = (up + tangent * xy.x + bitangent * xy.y);
-		Vec3 spos = cpos.normalize();
+		Vec3 spos = spherePos[i] = cpos.normalize();
 
-		*(Vec3*)(avertex + 8 * i) = spos * (1 + planet.sample(spos));		//Displacement on sphere
 		*(Vec2*)(avertex + 8 * i + 3) = uv;									//Temporary planar projection
 		*(Vec3*)(avertex + 8 * i + 5) = spos;								//Normal = position for a sphere
 
@@ -127,6 +159,13 @@ void MainInterface::refreshPlanet(Planet planet, MeshAllocationInfo &mai) {
 
 	}
 
+	//Displacement on sphere (sampled for all vertices at once)
+
+	planet.sample(spherePos.data(), height.data(), vertices);
+
+	for (u32 i = 0; i < vertices; ++i)
+		*(Vec3*)(avertex + 8 * i) = spherePos[i] * (1 + height[i]);
+
 	mai = MeshAllocationInfo("Planet", mesh3D, { Buffer((u8*)avertex, vertices * 32) }, Buffer((u8*)aindex, indices * 4));
 
 	t.stop();
@@ -136,9 +175,7 @@ void MainInterface::refreshPlanet(Planet planet, MeshAllocationInfo &mai) {
 
 void MainInterface::writePlanets() {
 
-	JSON json;
-	json.serialize(planets, true);
-	FileManager::get()->write("out/models/planets.json", json.toString());
+	FileManager::get()->write("out/models/planets.json", JSONStream::write(planets));
 
 	RMFile file = oiRM::convert(meshes[4]->getInfo());
 	oiRM::write(file, String("out/models/") + meshes[4]->getName() + ".oiRM", false);
@@ -148,14 +185,65 @@ void MainInterface::readPlanets(bool fromResource, MeshAllocationInfo &mai) {
 
 	String str;
 	FileManager::get()->read(String(fromResource ? "res/models/planets.json" : "out/models/planets.json"), str);
-	JSON json = str;
-	json.serialize(planets, false);
+	JSONStream::read(str, planets);
 
 	for(auto &elem : planets)
 		refreshPlanet(elem.second, mai);
 
 }
 
+void MainInterface::benchmarkJSON() {
+
+	//Generate a big planets file
+
+	std::unordered_map<String, Planet> generated;
+
+	for (u32 i = 0; i < 4096; ++i) {
+
+		Planet &planet = generated[String("planet") + i];
+		planet.minHeight = Random::randFloat(-1, 0);
+		planet.coastSize = Random::randFloat(0, 0.1f);
+		planet.noiseLayer.resize(8);
+
+		for (NoiseLayer &layer : planet.noiseLayer) {
+			layer.offset = Random::randomize<3>(-100, 100);
+			layer.octaves = Random::randInt(1, 8);
+			layer.persistence = Random::randFloat();
+			layer.roughness = Random::randFloat(1, 2);
+			layer.frequency = Random::randFloat(0.5f, 3);
+			layer.maskLand = Random::randInt(0, 1) != 0;
+		}
+	}
+
+	String str = JSONStream::write(generated);
+
+	//Compare the JSON tree with the streaming path
+
+	Timer t;
+
+	std::unordered_map<String, Planet> tree, stream;
+
+	JSON json = str;
+	json.serialize(tree, false);
+	t.lap("Read JSON (tree)");
+
+	JSONStream::read(str, stream);
+	t.lap("Read JSONStream");
+
+	JSON out;
+	out.serialize(generated, true);
+	String treeStr = out.toString();
+	t.lap("Write JSON (tree)");
+
+	String streamStr = JSONStream::write(generated);
+	t.lap("Write JSONStream");
+
+	t.stop();
+	t.print();
+
+	Log::println(String("Benchmarked ") + u32(generated.size()) + " planets (" + str.size() + " bytes); outputs are " + (treeStr == streamStr ? "equal" : "different"));
+}
+
 void MainInterface::refreshPlanetMesh(bool fromResource) {
 
 	MeshAllocationInfo mai;
@@ -302,6 +390,12 @@ void MainInterface::initScene() {
 	lightingPipeline->setValue("Global/power", 1.f);
 	lightingPipeline->setValue("Global/view", view->getHandle());
 
+	//Values that are set every frame
+
+	timeHandle = lightingPipeline->getHandle("Global/time");
+	exposureHandle = postProcessingPipeline->getHandle("PostProcessingSettings/exposure");
+	gammaHandle = postProcessingPipeline->getHandle("PostProcessingSettings/gamma");
+
 	postProcessingPipeline->setRegister("tex", lightingTarget->getTarget(0));
 }
 
@@ -364,6 +458,8 @@ void MainInterface::onInput(InputDevice*, Binding b, bool down) {
 			refreshPlanetMesh(true);
 		else if (b.toKey() == Key::Enter)
 			g.printObjects();
+		else if (b.toKey() == Key::B)
+			benchmarkJSON();
 
 	}
 
@@ -407,12 +503,12 @@ void MainInterface::update(f32 dt) {
 
 	//Update time
 
-	lightingPipeline->setValue("Global/time", (f32)getRuntime());
+	lightingPipeline->setValue(timeHandle, (f32)getRuntime());
 
 	//Setup post processing settings
 
-	postProcessingPipeline->setValue("PostProcessingSettings/exposure", exposure);
-	postProcessingPipeline->setValue("PostProcessingSettings/gamma", gamma);
+	postProcessingPipeline->setValue(exposureHandle, exposure);
+	postProcessingPipeline->setValue(gammaHandle, gamma);
 
 }
 
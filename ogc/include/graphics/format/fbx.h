@@ -2,6 +2,7 @@
 #include "types/buffer.h"
 #include "types/vector.h"
 #include "template/enum.h"
+#include "memory/arena.h"
 
 namespace oi {
 
@@ -22,13 +23,13 @@ namespace oi {
 
 			//0x001A
 			u16 getUnknown() {
-				return *(u16*)(data + 21);
+				u16 v; memcpy(&v, data + 21, 2); return v;
 			}
 
 			//7400 (0x1CE8) = 7.4 (32 bit)
 			//7500 = 7.5 (64 bit)
 			u32 getVersion() {
-				return *(u32*)(data + 23);
+				u32 v; memcpy(&v, data + 23, 4); return v;
 			}
 
 		};
@@ -49,19 +50,28 @@ namespace oi {
 
 			}
 
+			//Copy a T[] from (unaligned) data
+			static void copy(const u8 *data, std::vector<T> &arr) {
+				memcpy(arr.data(), data, arr.size() * sizeof(T));
+			}
+
 			static T *getPtr(std::vector<T> &arr) {
 				return arr.data();
 			}
 
+			static T *getPtr(T &t) {
+				return &t;
+			}
+
 		};
 
-		//Specialized for bool, because std::vector<bool>::reference is used instead of bool&
+		//Specialized for bool, because std::vector<bool> is a bitset
 		template<>
 		struct FbxPropertyHelper<bool> {
 
 			//sizeof(bool) isn't defined; it can be something different than 1
 			//We need to hardcode it as 1 byte
-			static bool readOne(Buffer &buf, u32 &offset, std::vector<bool>::reference dest) {
+			static bool readOne(Buffer &buf, u32 &offset, bool &dest) {
 
 				if (buf.size() == 0)
 					return Log::error("Couldn't read FbxProperty; Buffer didn't store the (full size) binary object");
@@ -73,14 +83,22 @@ namespace oi {
 
 			}
 
+			static void copy(const u8 *data, std::vector<bool> &arr) {
+				for (size_t i = 0; i < arr.size(); ++i)
+					arr[i] = data[i] != 0;
+			}
+
 			//There is no bool[] stored low-level, so nullptr
 			static bool *getPtr(std::vector<bool> &) { return nullptr; }
+			static bool *getPtr(bool &) { return nullptr; }
 
 		};
 
 		//Any regular dataType (bool; C, i16; Y, i32; I, i64; L, f32; F, f64; D) uses this header
 		struct FbxPropertyHeader {
 
+			static constexpr bool isArray = false;
+
 			u8 data[1];
 
 			static constexpr u32 size() { return (u32) sizeof(data); }
@@ -88,77 +106,82 @@ namespace oi {
 			char getType() { return (char) data[0]; }
 
 			template<typename T>
-			bool read(Buffer &buf, u32 &offset, std::vector<T> &vec) {
-				vec.resize(1);
-				return FbxPropertyHelper<T>::readOne(buf, offset, vec[0]);
+			bool read(Buffer &buf, u32 &offset, T &value) {
+				return FbxPropertyHelper<T>::readOne(buf, offset, value);
 			}
 
 		};
 
 		//Any array dataType (bool; b, i32; i, i64; l, f32; f, f64; d) uses this header
+		//Arrays aren't decoded when they're read; the (compressed) data is kept as a view into the fbx buffer and decoded on first access
 		struct FbxPropertyArrayHeader {
 
+			static constexpr bool isArray = true;
+
 			u8 data[13];
 
 			static constexpr u32 size() { return (u32) sizeof(data); }
 
 			char getType() { return (char)data[0]; }
-			u32 getArrayLength() { return *(u32*)(data + 1); }
-			u32 getEncoding() { return *(u32*)(data + 5); }
-			u32 getCompressedLength() { return *(u32*)(data + 9); }
+			u32 getArrayLength() { u32 v; memcpy(&v, data + 1, 4); return v; }
+			u32 getEncoding() { u32 v; memcpy(&v, data + 5, 4); return v; }
+			u32 getCompressedLength() { u32 v; memcpy(&v, data + 9, 4); return v; }
 
-			//This function loads data from a buffer like a T[] or a compressed T[], depending on this header
+			//Skips the array in the buffer and stores where it is
 			template<typename T>
-			bool read(Buffer &buf, u32 &offset, std::vector<T> &vec) {
+			bool read(Buffer &buf, u32 &offset, Buffer &view) {
 
-				vec.resize(getArrayLength());
+				//Bools are stored as 1 byte
+				u64 length = getEncoding() != 0 ? getCompressedLength() : u64(getArrayLength()) * (std::is_same<T, bool>::value ? 1 : sizeof(T));
 
-				if (getEncoding() != 0) {
+				if (buf.size() < length)
+					return Log::error("Couldn't read FbxPropertyArray; Buffer didn't store the (full size) array");
 
-					bool result = buf.subbuffer(0, getCompressedLength()).uncompress(Buffer::construct((u8*) vec.data(), getArrayLength() * (u32) sizeof(T) + 1));
+				view = buf.subbuffer(0, (u32) length);
+				buf = buf.offset((u32) length);
+				offset += (u32) length;
+				return true;
+			}
 
-					if (!result)
-						return Log::error("Couldn't read FbxPropertyArray; couldn't uncompress array");
+			//Loads the array from the view (T[] or compressed T[], depending on this header)
+			template<typename T>
+			bool decode(Buffer view, std::vector<T> &vec) {
 
-					buf = buf.offset(getCompressedLength());
-					offset += getCompressedLength();
-					return result;
-				}
+				constexpr u32 stride = std::is_same<T, bool>::value ? 1 : (u32) sizeof(T);
+				u32 length = getArrayLength();
 
-				for (u32 i = 0; i < getArrayLength(); ++i)
-					if (!FbxPropertyHelper<T>::readOne(buf, offset, vec[i]))
-						return Log::error("Couldn't read FbxPropertyArray; one of the elements was invalid");
+				if (getEncoding() == 0) {
+					vec.resize(length);
+					FbxPropertyHelper<T>::copy(view.addr(), vec);
+					return true;
+				}
 
-				return true;
-			}
+				//uncompress requires 1 byte more than the expected output
+				if constexpr (std::is_same<T, bool>::value) {
 
-			//This function loads data from a buffer like a char[] or a compressed char[], depending on this header
-			//Since a std::vector<bool> is implemented as a bitset (low level), it requires a different function
-			bool read(Buffer &buf, u32 &offset, std::vector<bool> &vec) {
+					CopyBuffer temp(length + 1);
 
-				vec.resize(getArrayLength());
+					if (!view.uncompress(temp)) {
+						vec.clear();
+						return Log::error("Couldn't read FbxPropertyArray; couldn't uncompress array");
+					}
 
-				if (getEncoding() != 0) {
+					vec.resize(length);
+					FbxPropertyHelper<T>::copy(temp.addr(), vec);
 
-					CopyBuffer tempVec((u32)vec.size());	//A vector that is dependable, and not a bitset
+				} else {
 
-					bool result = buf.subbuffer(0, getCompressedLength()).uncompress(Buffer::construct((u8*) tempVec.addr(), getArrayLength() + 1));
+					vec.resize(length + 1);
 
-					//Copy it into a bitset
-					for (u32 i = 0; i < (u32)tempVec.size(); ++i)
-						vec[i] = tempVec[i];
+					if (!view.uncompress(Buffer::construct((u8*) vec.data(), length * stride + 1))) {
+						vec.clear();
+						return Log::error("Couldn't read FbxPropertyArray; couldn't uncompress array");
+					}
 
-					buf = buf.offset(getCompressedLength());
-					offset += getCompressedLength();
-					return result;
+					vec.resize(length);
 				}
 
-				for (u32 i = 0; i < getArrayLength(); ++i)
-					if (!FbxPropertyHelper<bool>::readOne(buf, offset, vec[i]))
-						return Log::error("Couldn't read FbxPropertyArray; one of the elements was invalid");
-
 				return true;
-
 			}
 
 		};
@@ -166,22 +189,24 @@ namespace oi {
 		//Any data (String; S, Raw/Buffer; R) uses this header
 		struct FbxPropertyDataHeader {
 
+			static constexpr bool isArray = false;
+
 			u8 data[5];
 
 			static constexpr u32 size() { return (u32) sizeof(data); }
 
 			char getType() { return (char)data[0]; }
-			u32 getLength() { return *(u32*)(data + 1); }
+			u32 getLength() { u32 v; memcpy(&v, data + 1, 4); return v; }
 
-			//This function is used to parse the string(s) from a buffer
-			bool read(Buffer &buf, u32 &offset, std::vector<String> &vec) {
+			//This function is used to parse the string from a buffer
+			bool read(Buffer &buf, u32 &offset, String &value) {
 
 				if (buf.size() < getLength())
 					return Log::error("Couldn't read FbxProperty; Buffer didn't store the (full size) binary object");
 
 				///TODO: [ 0x00, 0x01 ] is used to seperate strings
 
-				vec.push_back(String((char*) buf.addr(), getLength()));
+				value = String((char*) buf.addr(), getLength());
 
 				offset += getLength();
 				buf = buf.offset(getLength());
@@ -189,12 +214,12 @@ namespace oi {
 			}
 
 			//This function is used to parse the subbuffer from a buffer
-			bool read(Buffer &buf, u32 &offset, std::vector<Buffer> &vec) {
+			bool read(Buffer &buf, u32 &offset, Buffer &value) {
 
 				if (buf.size() < getLength())
 					return Log::error("Couldn't read FbxProperty; Buffer didn't store the (full size) binary object");
 
-				vec.push_back(buf.subbuffer(0, getLength()));
+				value = buf.subbuffer(0, getLength());
 
 				offset += getLength();
 				buf = buf.offset(getLength());
@@ -241,6 +266,7 @@ namespace oi {
 		};
 
 		//The base class for all derived types
+		//Properties are allocated in the arena of the FbxFile they belong to
 		class FbxProperty {
 
 		public:
@@ -248,16 +274,22 @@ namespace oi {
 			FbxProperty() {}
 			virtual ~FbxProperty() {}
 
+			FbxProperty(const FbxProperty&) = delete;
+			FbxProperty &operator=(const FbxProperty&) = delete;
+
 			virtual char getCode() = 0;								//char identifier for the property
-			virtual FbxProperty *clone() = 0;					//Cloning the contents of a property
 			virtual bool read(Buffer &buf, u32 &offset) = 0;		//Reading the property from a buffer
 
-			//Allocate and fill a property from buffer
-			static FbxProperty *readProperty(Buffer &buffer, u32 &offset);
+			//Allocate (in the arena) and fill a property from buffer
+			static FbxProperty *readProperty(Arena &arena, Buffer &buffer, u32 &offset);
 
 			template<typename T>
 			T *cast();
 
+			//Returns nullptr instead of throwing if the type doesn't match
+			template<typename T>
+			T *tryCast();
+
 		};
 
 		typedef std::vector<FbxProperty*> FbxProperties;
@@ -279,12 +311,12 @@ namespace oi {
 			//Get a value from this property
 			//If this property has more values, you can use an index
 			T &get(u32 i = 0) {
-				return contents[i];
-			}
 
-			//Copy this property
-			FbxProperty *clone() override {
-				return (FbxProperty*) new TFbxProperty<Id, Header, T>(*this);
+				if constexpr (Header::isArray) {
+					decode();
+					return contents[i];
+				}
+				else return value;
 			}
 
 			TFbxProperty() {
@@ -301,38 +333,79 @@ namespace oi {
 				buf = buf.offset(Header::size());
 				offset += Header::size();
 
-				return header.read(buf, offset, contents);
+				if constexpr (Header::isArray)
+					return header.template read<T>(buf, offset, source);
+				else
+					return header.read(buf, offset, value);
+			}
+
+			//Decode an array property (if it wasn't already); returns false if the data is invalid
+			//Arrays are decoded on first access (get, getPtr, ==); this isn't thread safe for the same property
+			bool decode() {
+
+				if constexpr (Header::isArray) {
+
+					if (!decoded) {
+						decoded = true;
+						valid = header.decode(source, contents);
+					}
+
+					return valid;
+				}
+				else return true;
 			}
 
 			//Compare this property with a raw value (variable)
-			bool operator==(const T &other) const {
-				return contents.size() == 1 && contents[0] == other;
+			bool operator==(const T &other) {
+
+				if constexpr (Header::isArray)
+					return decode() && contents.size() == 1 && contents[0] == other;
+				else
+					return value == other;
 			}
 
 			//Compare this property with raw values (array)
-			bool operator==(const std::vector<T> &other) const {
-				return contents == other;
+			bool operator==(const std::vector<T> &other) {
+
+				if constexpr (Header::isArray)
+					return decode() && contents == other;
+				else
+					return other.size() == 1 && other[0] == value;
 			}
 
 			//For any other compare, it returns false (but it is needed to compile)
 			template<typename T2>
-			bool operator==(const T2 &) const {
+			bool operator==(const T2 &) {
 				return false;
 			}
 
 			//Returns nullptr for FbxBool or FbxBoolArray; because that's a bitset, not a C array
 			T *getPtr() {
-				return FbxPropertyHelper<T>::getPtr(contents);
+
+				if constexpr (Header::isArray)
+					return decode() ? FbxPropertyHelper<T>::getPtr(contents) : nullptr;
+				else
+					return FbxPropertyHelper<T>::getPtr(value);
 			}
 
+			//Doesn't require the array to be decoded
 			u32 size() {
-				return (u32) contents.size();
+
+				if constexpr (Header::isArray)
+					return header.getArrayLength();
+				else
+					return 1;
 			}
 
 		protected:
 
 			Header header;
-			std::vector<T> contents;
+
+			T value = T();					//Scalar or data value
+
+			Buffer source;					//Array data (compressed or T[]) in the fbx buffer
+			std::vector<T> contents;		//Decoded array
+			bool decoded = false, valid = false;
 
 		};
 
@@ -366,9 +439,9 @@ namespace oi {
 		struct FbxTypeCheck {
 
 			//Check if an FbxProperty's type matches the type code
-			template<char Id, typename Header, typename T>
-			static bool check(TFbxProperty<Id, Header, T> prop, char c) {
-				return c == Id;
+			template<typename T>
+			static bool check(char c) {
+				return c == T::getTypeCode();
 			}
 
 		};
@@ -376,24 +449,29 @@ namespace oi {
 		template<typename T>
 		T *FbxProperty::cast() {
 
-			if (FbxTypeCheck::template check(T{}, getCode()))
+			if (FbxTypeCheck::template check<T>(getCode()))
 				return (T*) this;
 
 			return (T*) Log::throwError<FbxProperty, 0x0>("Couldn't cast an FbxProperty");
 
 		}
 
+		template<typename T>
+		T *FbxProperty::tryCast() {
+			return FbxTypeCheck::template check<T>(getCode()) ? (T*) this : nullptr;
+		}
+
 		//Allocate a type from a type code (non-last recursion)
 		template<typename T, typename ...args>
 		struct TFbxTypeAlloc {
 
 			//Cascade down into the next if the type doesn't match
-			static FbxProperty *get(char type) {
+			static FbxProperty *get(Arena &arena, char type) {
 
-				if (FbxTypeCheck::template check(T{}, type))
-					return new T();
+				if (FbxTypeCheck::template check<T>(type))
+					return arena.create<T>();
 
-				return TFbxTypeAlloc<args...>::get(type);
+				return TFbxTypeAlloc<args...>::get(arena, type);
 			}
 
 		};
@@ -403,10 +481,10 @@ namespace oi {
 		struct TFbxTypeAlloc<T> {
 
 			//Return nullptr if the type doesn't match
-			static FbxProperty *get(char type) {
+			static FbxProperty *get(Arena &arena, char type) {
 
-				if (FbxTypeCheck::template check(T{}, type))
-					return new T();
+				if (FbxTypeCheck::template check<T>(type))
+					return arena.create<T>();
 
 				return nullptr;
 			}
@@ -418,13 +496,13 @@ namespace oi {
 
 			//Instantiate the template loop from types
 			template<typename ...args>
-			static FbxProperty *allocate(TFbxTypes<args...>, char type) {
-				return TFbxTypeAlloc<args...>::get(type);
+			static FbxProperty *allocate(Arena &arena, TFbxTypes<args...>, char type) {
+				return TFbxTypeAlloc<args...>::get(arena, type);
 			}
 
 			//Allocate by type code
-			static FbxProperty *allocate(char type) {
-				return FbxTypeAlloc::template allocate(FbxTypes{}, type);
+			static FbxProperty *allocate(Arena &arena, char type) {
+				return FbxTypeAlloc::template allocate(arena, FbxTypes{}, type);
 			}
 
 		};
@@ -436,55 +514,40 @@ namespace oi {
 
 		//A class to handle an fbx node
 		//A node contains subnodes and properties
+		//Nodes are allocated in the arena of the FbxFile they belong to; the name points into the fbx buffer
 		class FbxNode {
 
 		public:
 
-			//Clean up all children and properties
-			~FbxNode() {
-
-				for (FbxProperty *elem : properties)
-					delete elem;
-
-				for (FbxNode *elem : childs)
-					delete elem;
-
-			}
-
 			FbxNode() {}
-			FbxNode(FbxNodes nodes) : childs(nodes), name("Root") { }
-
-			FbxNode(const FbxNode &other) {
-				copy(other);
-			}
 
-			FbxNode &operator=(const FbxNode &other) {
-				copy(other);
-				return *this;
-			}
+			FbxNode(const FbxNode&) = delete;
+			FbxNode &operator=(const FbxNode&) = delete;
 
 			//Read a Buffer as an FbxNode and increment the Buffer by the required amount
-			static FbxNode *read(Buffer &buf, u32 &offset, bool is64bit);
+			//The stack is used as temporary storage for child nodes, so reading doesn't have to allocate per node
+			static FbxNode *read(Arena &arena, FbxNodes &stack, Buffer &buf, u32 &offset, bool is64bit);
 
-			//Read a Buffer's FbxNode(s)
-			static FbxNodes readAll(Buffer &buf, u32 &offset, bool is64bit);
+			//Read a Buffer's FbxNode(s) into a root node
+			static FbxNode *readAll(Arena &arena, Buffer &buf, u32 &offset, bool is64bit);
 
 			u32 getChildren();
 			FbxNode *getChild(u32 i);
 
-			FbxNodes::iterator getChildBegin();
-			FbxNodes::iterator getChildEnd();
-			const FbxNodes &getChildArray();
+			FbxNode **getChildBegin();
+			FbxNode **getChildEnd();
 
 			u32 getProperties();
 			FbxProperty *getProperty(u32 i);
 
-			FbxProperties::iterator getPropertyBegin();
-			FbxProperties::iterator getPropertyEnd();
-			const FbxProperties &getPropertyArray();
+			FbxProperty **getPropertyBegin();
+			FbxProperty **getPropertyEnd();
 
 			String getName();
 
+			//If the name of the node matches; compares the hash first
+			bool hasName(const char *str, u32 length, u64 hash);
+
 			//Path works just like file paths, but there can be nodes with the same path
 			//Objects/Model is the path for all object data
 			//Objects/Geometry is the path for all geometry data
@@ -501,31 +564,17 @@ namespace oi {
 		private:
 
 			//Find nodes with a path
-			void findNodes(String path, const FbxNodes &loc, FbxNodes &target);
-
-			//Copy all children and properties
-			void copy(const FbxNode &other) {
+			void findNodes(const char *path, u32 length, FbxNodes &target);
 
-				header = other.header;
-				name = other.name;
-
-				properties = other.properties;
-				
-				for (FbxProperty *&elem : properties)
-					elem = elem->clone();
-
-				childs = other.childs;
-
-				for (FbxNode *&elem : childs)
-					elem = new FbxNode(*elem);
+			FbxNodeHeader64 header;
 
-			}
+			const char *name = nullptr;
+			u64 nameHash = 0;
 
-			FbxNodeHeader64 header;
-			String name;
+			FbxProperty **properties = nullptr;
+			FbxNode **childs = nullptr;
 
-			FbxProperties properties;
-			FbxNodes childs;
+			u32 propertyCount = 0, childCount = 0;
 
 		};
 
@@ -537,7 +586,7 @@ namespace oi {
 			template<typename T2>
 			static bool check(FbxProperty *prop, T2 t) {
 
-				if (!FbxTypeCheck::template check(T{}, prop->getCode()))
+				if (!FbxTypeCheck::template check<T>(prop->getCode()))
 					return FbxCheckPropertyValue_inner<args...>::template check(prop, t);
 
 				T &castProperty = *(T*)prop;
@@ -555,7 +604,7 @@ namespace oi {
 			template<typename T2>
 			static bool check(FbxProperty *prop, T2 t) {
 
-				if (!FbxTypeCheck::template check(T{}, prop->getCode()))
+				if (!FbxTypeCheck::template check<T>(prop->getCode()))
 					return Log::error("FbxCheckPropertyValue couldn't find the requested type");
 
 				T &castProperty = *(T*)prop;
@@ -645,6 +694,8 @@ namespace oi {
 
 
 		//Class for storing and traversing fbx nodes
+		//All nodes and properties are stored in an arena that is owned by the file
+		//Array properties point into the fbx buffer, so it has to stay alive as long as the file (read(String) maps the file itself)
 		class FbxFile {
 
 		public:
@@ -662,19 +713,21 @@ namespace oi {
 			FbxNodes findCameras();
 			FbxNodes findGeometry();
 
-			FbxFile(const FbxFile &other);
-			FbxFile &operator=(const FbxFile &other);
+			FbxFile(const FbxFile&) = delete;
+			FbxFile &operator=(const FbxFile&) = delete;
 			~FbxFile();
 
 		protected:
 
-			FbxFile(FbxHeader header, FbxNodes nodes);
-			void copy(const FbxFile &other);
+			FbxFile(FbxHeader header);
 
 		private:
 
 			FbxHeader header;
-			FbxNode *root;
+			Arena arena;
+			FbxNode *root = nullptr;
+
+			Buffer mapped;
 
 		};
 
@@ -696,6 +749,9 @@ namespace oi {
 			static Vec3 getMaterialCol(FbxNode *nod, Vec3 def = {});
 			static f32 getMaterialNum(FbxNode *nod, f32 def = 0.f);
 
+			//Convert a geometry node to an oiRM file; only touches the node's own properties, so it can be called from multiple threads
+			static bool convertGeometry(FbxNode *node, const String &name, bool compression, Buffer &result, String &error);
+
 		};
 
 	}
@@ -0,0 +1,64 @@
+#pragma once
+#include "graphics/format/oirm.h"
+
+namespace oi {
+
+	namespace gc {
+
+		//Post-transform vertex cache statistics of an index buffer (simulated FIFO cache)
+		//ACMR = average cache miss ratio; transformed vertices per triangle (0.5 is the best case for big grids, 3 is the worst)
+		//ATVR = average transformed vertex ratio; transformed vertices per unique vertex (1 is optimal)
+		struct MeshCacheStats {
+			f32 acmr = 0, atvr = 0;
+		};
+
+		//Optimizes triangle lists before they're stored as oiRM
+		//Vertices are interleaved with a stride in bytes; indices are u32 triangle lists
+		struct MeshOptimizer {
+
+			static constexpr u32 cacheSize = 16;
+
+			//Default meshlet limits; 64 vertices and 124 triangles fit a mesh shader's output limits well
+			static constexpr u32 meshletVertices = 64, meshletTriangles = 124;
+
+			//Merges vertices that are byte-for-byte equal and remaps the indices; vertices are compacted in place
+			//Returns the new vertex count
+			static u32 weldVertices(Buffer vbo, u32 stride, Buffer ibo);
+
+			//Reorders the triangles so vertices are reused while they're still in the post-transform cache (Tipsify)
+			static void optimizeVertexCache(Buffer ibo, u32 vertices, u32 cache = cacheSize);
+
+			//Reorders the vertices in the order they're first used by the indices; unused vertices are removed
+			//Returns the new vertex count
+			static u32 optimizeVertexFetch(Buffer vbo, u32 stride, Buffer ibo);
+
+			static MeshCacheStats analyzeVertexCache(Buffer ibo, u32 vertices, u32 cache = cacheSize);
+
+			//Splits the triangles into meshlets of at most maxVertices vertices and maxTriangles triangles (both <= 255)
+			//Triangles are taken in index order (so run optimizeVertexCache first); the position has to be a Vec3 at the start of the vertex
+			//Fills the meshlets, meshletVertices, meshletTriangles and meshletHeader of the file
+			static bool buildMeshlets(Buffer vbo, u32 stride, Buffer ibo, RMFile &file, u32 maxVertices = meshletVertices, u32 maxTriangles = meshletTriangles);
+
+			//Simplifies the triangles with quadric error metrics by collapsing vertices into their neighbors, so every LOD uses the same vertices
+			//Seams (vertices with the same position but other attributes) and borders are kept in place
+			//Errors are relative to the size of the mesh; a LOD is added for every error (if it removes at least 10% of the previous LOD's triangles)
+			//Fills the lods, lodIndices and lodHeader of the file and reports the triangles per LOD (name is used to identify the mesh)
+			static bool buildLods(Buffer vbo, u32 stride, Buffer ibo, RMFile &file, const std::vector<f32> &errors, String name = "");
+
+			//The errors the LODs are generated with by oiRM::generate ({ 0.005, 0.02, 0.05 } by default, empty to disable LODs)
+			static void setLodErrors(const std::vector<f32> &errors);
+			static const std::vector<f32> &getLodErrors();
+
+			//Runs weldVertices, optimizeVertexCache and optimizeVertexFetch and returns the new vertex count
+			//If reporting is enabled, the vertex count and cache stats before and after are printed (name is used to identify the mesh)
+			static u32 optimize(Buffer vbo, u32 stride, Buffer ibo, String name = "");
+
+			//Print the stats of every mesh that is optimized (off by default)
+			static void setReporting(bool enabled);
+			static bool isReporting();
+
+		};
+
+	}
+
+}
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 #include "template/enum.h"
+#include "utils/compression.h"
 #include "format/oisl.h"
 #include "graphics/objects/texture/texture.h"
 
@@ -12,7 +13,7 @@ namespace oi {
 		struct MeshInfo;
 		struct MeshBufferInfo;
 
-		UEnum(RMHeaderVersion, Undefined = 0, V0_0_1 = 1);
+		UEnum(RMHeaderVersion, Undefined = 0, V0_0_1 = 1, V0_0_2 = 2, V0_0_3 = 3);		//V0_0_2 adds meshlets, V0_0_3 adds LODs
 		UEnum(RMHeaderFlag1, None = 0, Contains_materials = 1, Per_tri_materials = 2, Uses_compression = 4);
 
 		enum class RMOperationFlag {
@@ -124,6 +125,68 @@ namespace oi {
 
 		};
 
+		//V0_0_2; stored after the oiSL names
+		//Followed by RMMeshlet[meshlets], u32[vertices] and u8[triangles * 3]
+		//If Uses_compression is set, they're bitsets instead; ceil(log2(vertices)) bits per vertex and ceil(log2(maxVertices)) per triangle index
+		struct RMMeshletHeader {
+
+			u32 meshlets;
+			u32 vertices;			//Total of the meshlets' vertices
+			u32 triangles;			//Total of the meshlets' triangles
+
+			u8 maxVertices;			//Max vertices per meshlet
+			u8 maxTriangles;		//Max triangles per meshlet
+			u16 p0;
+
+		};
+
+		//A cluster of triangles that only use a few vertices (for cluster culling and mesh shaders)
+		//Triangles index into the meshlet's vertices (u8), which index into the mesh's vertices (u32)
+		struct RMMeshlet {
+
+			u32 vertexOffset;		//Into RMFile::meshletVertices
+			u32 triangleOffset;		//Into RMFile::meshletTriangles / 3
+
+			u8 vertices;
+			u8 triangles;
+			u16 p0 = 0;
+
+			//Bounding sphere of the meshlet's vertices
+
+			Vec3 center;
+			f32 radius;
+
+			//Normal cone; the meshlet is backfacing if dot(center - eye, coneAxis) >= coneCutoff * |center - eye| + radius
+			//coneCutoff is 1 if the triangles can't all be backfacing at once (so it's never culled)
+
+			Vec3 coneAxis;
+			f32 coneCutoff;
+
+			bool isBackfacing(Vec3 eye) const {
+				Vec3 dir = center - eye;
+				return dir.dot(coneAxis) >= coneCutoff * dir.magnitude() + radius;
+			}
+
+		};
+
+		//V0_0_3; stored after the meshlets
+		//Followed by RMLod[lods] and u32[indices] (bitset compressed like the meshlet vertices if Uses_compression is set)
+		struct RMLodHeader {
+
+			u32 lods;
+			u32 indices;			//Total of the LODs' indices
+
+		};
+
+		//A simplified version of the mesh; its indices use the same vertices as the full mesh (LOD 0)
+		struct RMLod {
+
+			u32 indexOffset;		//Into RMFile::lodIndices
+			u32 indices;
+			f32 error;				//Estimated distance from the full mesh (quadric error, in object space)
+
+		};
+
 		struct RMFile {
 
 			RMHeader header;
@@ -135,6 +198,15 @@ namespace oi {
 			std::vector<CopyBuffer> miscBuffer;			//Per misc data
 			SLFile names;
 
+			RMMeshletHeader meshletHeader = {};		//V0_0_2
+			std::vector<RMMeshlet> meshlets;
+			std::vector<u32> meshletVertices;
+			std::vector<u8> meshletTriangles;
+
+			RMLodHeader lodHeader = {};				//V0_0_3
+			std::vector<RMLod> lods;
+			std::vector<u32> lodIndices;
+
 			u32 size = 0;
 
 			RMFile(RMHeader header, std::vector<RMVBO> vbos, std::vector<RMAttribute> vbo, std::vector<RMMisc> miscs, std::vector<CopyBuffer> vertices, CopyBuffer indices, std::vector<CopyBuffer> miscBuffer, SLFile names) : header(header), vbos(vbos), vbo(vbo), miscs(miscs), vertices(vertices), indices(indices), miscBuffer(miscBuffer), names(names) {}
@@ -144,6 +216,7 @@ namespace oi {
 
 		struct oiRM {
 
+			//Files that are block compressed (see setBlockCompression) are uncompressed first
 			static bool read(String path, RMFile &file);
 			static bool read(Buffer data, RMFile &file);
 
@@ -159,6 +232,11 @@ namespace oi {
 			static Buffer write(RMFile &file, bool compression = true);					//Creates new buffer
 			static bool write(RMFile &file, String path, bool compression = true);
 
+			//The codec that written files are block compressed with (LZ4 by default, because it's the fastest to load; None writes plain files)
+			//This is separate from the compression flag, which bit packs the indices
+			static void setBlockCompression(CompressionCodec codec);
+			static CompressionCodec getBlockCompression();
+
 			//Generate a default oiRM file
 			//The layout is as follows:
 			//Vec3 inPosition (if hasPos)
@@ -166,7 +244,8 @@ namespace oi {
 			//Vec3 inNormal (if hasNrm)
 			//Meaning that vbo should be stride * vertices
 			//Ibo should be u8[indices], u16[indices] or u32[indices], depending on how many vertices are present.
-			static RMFile generate(Buffer vbo, Buffer ibo, bool hasPos, bool hasUv, bool hasNrm, u32 vertices, u32 indices);
+			//If there's a position and indices, meshlets (V0_0_2) and LODs (V0_0_3) are generated as well; name is used to report the LODs
+			static RMFile generate(Buffer vbo, Buffer ibo, bool hasPos, bool hasUv, bool hasNrm, u32 vertices, u32 indices, String name = "");
 
 			//static std::pair<MeshBufferInfo, MeshInfo> generate(Buffer vbo, Buffer ibo, bool hasPos, bool hasUv, bool hasNrm, u32 vertices, u32 indices, bool compression);
 		};
@@ -212,6 +212,11 @@ namespace oi {
 			static bool write(String path, SHFile &file);
 			static Buffer write(SHFile &file);
 
+			//The compiler's (glslang) state is shared by the whole process; it's set up by the first user and cleaned up by the last one
+			//compile and convert already do this, but keeping it alive around a batch of (multithreaded) compiles avoids setting it up every time
+			static void initCompiler();
+			static void destroyCompiler();
+
 		private:
 
 			static bool compileSource(ShaderSource &source, bool useFile, std::vector<String> &dependencies);	//Internal for compiling shader source files (GLSL/HLSL) to SPV
@@ -4,6 +4,7 @@
 #include "utils/timer.h"
 #include "graphics/generic.h"
 #include "memory/blockallocator.h"
+#include "memory/idallocator.h"
 #include "types/bitset.h"
 #include "template/enum.h"
 
@@ -37,7 +38,7 @@ namespace oi {
 
 			static constexpr u32 maxId = 0xFFFFFF;
 			
-			Graphics(u32 heapSize) : heapSize(heapSize), allocator(heapSize), features(false), idAllocator(false) { idAllocator[0] = true; }
+			Graphics(u32 heapSize) : heapSize(heapSize), allocator(heapSize), idAllocator(maxId + 1), features(false) { idAllocator.reserve(0); }
 			~Graphics();
 			
 			void init(oi::wc::Window *w);
@@ -77,7 +78,7 @@ namespace oi {
 			bool destroyObject(GraphicsObject *go);
 			void use(GraphicsObject *go);
 
-			GraphicsObject *get(u32 id);
+			GraphicsObject *get(u32 id);						//Returns nullptr if the id is invalid or stale (the object got destroyed)
 			bool contains(u32 id);
 			void use(u32 id);
 			void destroy(u32 id);
@@ -104,6 +105,9 @@ namespace oi {
 
 			bool remove(GraphicsObject *go);
 
+			u32 allocId();
+			void freeId(GraphicsObject *go);
+
 			void setupSurface(wc::Window *w);
 
 		private:
@@ -116,11 +120,11 @@ namespace oi {
 			RenderTarget *backBuffer = nullptr;
 
 			oi::BlockAllocator allocator;
-			oi::StaticBitset<maxId + 1> idAllocator;
+			oi::IdAllocator idAllocator;
 			GraphicsExt *ext;
 
 			std::unordered_map<size_t, std::vector<GraphicsObject*>> objects;
-			std::unordered_map<u32, GraphicsObject*> objectsById;
+			std::vector<GraphicsObject*> objectsById;
 
 			StaticBitset<GraphicsFeature::length> features;
 			
@@ -140,7 +144,13 @@ namespace oi {
 			if (it != o.end()) Log::warn("Graphics::add called on an already existing object");
 			else {
 				o.push_back(t);
-				objectsById[t->getId()] = (GraphicsObject*) t;
+
+				u32 index = IdAllocator::getIndex(t->getId());
+
+				if (index >= objectsById.size())
+					objectsById.resize(index + 1);
+
+				objectsById[index] = (GraphicsObject*) t;
 			}
 
 		}
@@ -164,19 +174,7 @@ namespace oi {
 			T *t = allocator.alloc<T, TInfo>(info);
 			t->g = this;
 
-			u32 id = maxId + 1;
-
-			for(u32 i = 0; i < maxId; ++i)
-				if (!idAllocator[i]) {
-					id = i;
-					idAllocator[i] = true;
-					break;
-				}
-
-			if(id == maxId + 1)
-				Log::throwError<Graphics, 0x2>("Couldn't init GraphicsObject; couldn't find a valid id");
-
-			t->id = id;
+			t->id = allocId();
 			t->name = name;
 			t->template setHash<T>();
 
@@ -206,8 +204,7 @@ namespace oi {
 
 			if (--go->refCount <= 0) {
 				vec.erase(itt);
-				objectsById.erase(go->getId());
-				idAllocator[go->getId()] = false;
+				freeId(go);
 				allocator.dealloc(go);
 				go = nullptr;
 			}
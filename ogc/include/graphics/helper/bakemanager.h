@@ -16,7 +16,10 @@ namespace oi {
 			u32 version;
 
 			//If any change is made to the baker; this increases
-			static const u32 getGlobalVersion() { return 5; }
+			static const u32 getGlobalVersion() { return 6; }
+
+			//Caches of this version don't store content hashes, but can still be migrated
+			static const u32 getLegacyVersion() { return 5; }
 
 		};
 		
@@ -29,6 +32,7 @@ namespace oi {
 		struct BakedFile {
 			String extension, file;
 			std::vector<String> outputs, inputs, dependencies;
+			std::vector<u64> outputHashes, inputHashes, dependencyHashes;		//xxHash of the contents; 0 if it couldn't be read
 		};
 
 		struct BakerFile {
@@ -72,6 +76,18 @@ namespace oi {
 			void cache(BakedFile &file);
 			bool shouldUpdate(BakedFile &file);
 
+			//Find the cached version of the file (nullptr if it isn't cached)
+			BakedFile *find(BakedFile &file);
+
+			//Hash of a file's contents; memoized for the staleness checks
+			u64 getHash(const String &path);
+
+			//Compare modification times; used for caches that don't have hashes yet
+			bool isOutdated(BakedFile &file);
+
+			static void hash(BakedFile &file);
+			static String makeKey(const BakedFile &file);
+
 			u16 makeFlags();
 
 			static bool bakeModel(BakedFile &file, bool stripDebug);
@@ -82,6 +98,9 @@ namespace oi {
 			std::vector<BakeOption> bakeOptions;
 			BakerFile file;
 			String location;
+
+			std::unordered_map<String, u32> index;		//Inputs -> file.files
+			std::unordered_map<String, u64> hashes;
 			bool changed = false, stripDebug;
 
 		};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "meshbuffer.h"
+#include "graphics/format/oirm.h"
 
 namespace oi {
 
@@ -8,6 +9,13 @@ namespace oi {
 
 		class Mesh;
 
+		struct MeshLod {
+
+			u32 baseIndex, indices;		//Relative to the mesh (MeshInfo) or to the MeshBuffer (Mesh::getLod)
+			f32 error;					//Estimated distance from the full mesh (in object space)
+
+		};
+
 		struct MeshInfo {
 
 			typedef Mesh ResourceType;
@@ -20,6 +28,15 @@ namespace oi {
 
 			MeshAllocation allocation;
 
+			//Meshlets (oiRM V0_0_2); triangles index into meshletVertices, which index into the vertices of this mesh
+			std::vector<RMMeshlet> meshlets;
+			std::vector<u32> meshletVertices;
+			std::vector<u8> meshletTriangles;
+
+			//LODs (oiRM V0_0_3); LOD 0 is the full mesh, the others are stored after it in the ibo and use the same vertices
+			//Empty if the mesh doesn't have LODs
+			std::vector<MeshLod> lods;
+
 			MeshInfo(MeshBuffer *buffer, u32 vertices, u32 indices, std::vector<Buffer> vbo, Buffer ibo = {}) : buffer(buffer), vbo(vbo), ibo(ibo), vertices(vertices), indices(indices) { }
 
 			MeshInfo() : MeshInfo(nullptr, 0, 0, {}) {}
@@ -38,6 +55,13 @@ namespace oi {
 			MeshBuffer *getBuffer() const;
 			MeshAllocation getAllocation() const;
 
+			u32 getLods() const;
+			MeshLod getLod(u32 i) const;
+
+			//The LOD with the least triangles that has an error below maxError (in object space)
+			//From screen space; maxError = maxPixels * distance / (0.5 * resolution.y * projection[1][1])
+			u32 selectLod(f32 maxError) const;
+
 		protected:
 
 			Mesh(MeshInfo info);
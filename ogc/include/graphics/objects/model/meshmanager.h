@@ -55,6 +55,13 @@ namespace oi {
 
 		class MeshManager;
 
+		//Time (in seconds) spent per stage of the last MeshManager::loadAll
+		//read, decompress and convert are summed over all threads; load is the time it took to get all files ready
+		struct MeshLoadTimings {
+			f32 read = 0, decompress = 0, convert = 0, load = 0, meshBuffers = 0, meshes = 0;
+			u32 files = 0, threads = 0;
+		};
+
 		struct MeshManagerInfo {
 
 			typedef MeshManager ResourceType;
@@ -85,9 +92,12 @@ namespace oi {
 			//Loads one mesh (multiple should be batched with loadAll)
 			Mesh *load(MeshAllocationInfo info);
 
-			//Loads all meshes (efficiently)
+			//Loads all meshes (efficiently); the files are read and converted in parallel
 			std::vector<Mesh*> loadAll(std::vector<MeshAllocationInfo> &info);
 
+			//Timing breakdown of the last loadAll
+			const MeshLoadTimings &getLoadTimings() const;
+
 			void unload(Mesh *mesh);
 			void unloadAll(MeshBuffer *meshBuffer);
 
@@ -108,6 +118,7 @@ namespace oi {
 		private:
 
 			MeshManagerInfo info;
+			MeshLoadTimings timings;
 			u32 mbId = 0;
 
 		};
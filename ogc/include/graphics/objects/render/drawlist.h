@@ -1,6 +1,7 @@
 #pragma once
 
 #include "types/matrix.h"
+#include "types/indexmap.h"
 #include "graphics/objects/graphicsobject.h"
 
 namespace oi {
@@ -13,6 +14,22 @@ namespace oi {
 
 		class DrawList;
 
+		//A mesh and how many instances of it to draw
+		//Draws are sorted by key (from low to high) when the DrawList is flushed; equal keys keep the order they were drawn in
+		//The instances keep the ids they were given when they were drawn, so per instance data is laid out in the order of the draw calls (not the keys)
+		struct DrawCall {
+
+			Mesh *mesh;
+			u32 instances;
+			u64 sortKey;
+
+			u32 firstInstance;		//Set by DrawList::draw; the number of instances that were drawn before this one
+
+			DrawCall(Mesh *mesh, u32 instances, u64 sortKey = 0) : mesh(mesh), instances(instances), sortKey(sortKey), firstInstance(0) {}
+			DrawCall() : DrawCall(nullptr, 0) {}
+
+		};
+
 		struct DrawListInfo {
 
 			typedef DrawList ResourceType;
@@ -23,7 +40,7 @@ namespace oi {
 			MeshBuffer *meshBuffer;
 			GPUBuffer *drawBuffer = nullptr;
 
-			std::vector<std::pair<Mesh*, u32>> objects;
+			std::vector<DrawCall> objects;
 
 			DrawListInfo(MeshBuffer *meshBuffer, u32 maxBatches, bool clearOnUse = true) : meshBuffer(meshBuffer), maxBatches(maxBatches), clearOnUse(clearOnUse) {}
 			DrawListInfo() : DrawListInfo(nullptr, 0) {}
@@ -49,7 +66,11 @@ namespace oi {
 
 			//Push instances into the draw list
 			//Try avoiding calling this every time, it's better to call this function just once per mesh
-			void draw(Mesh *m, u32 instances);
+			void draw(Mesh *m, u32 instances, u64 sortKey = 0);
+
+			//Push multiple draws at once
+			void draw(const DrawCall *draws, u32 count);
+			void draw(const std::vector<DrawCall> &draws);
 
 		protected:
 
@@ -69,6 +90,19 @@ namespace oi {
 
 			DrawListInfo info;
 
+			//The ids of the meshes in objects; so duplicate meshes can be found without looking through every draw
+			IndexMap<u32> meshIds;
+
+			//If the draws were pushed with increasing sort keys, they don't need to be sorted
+			bool sorted = true;
+
+			//Instances of all draws so far; the first instance of the next draw
+			u32 recordedInstances = 0;
+
+			//If the meshes are kept alive by the DrawList
+			//A list that is cleared on flush only lives until the frame is recorded, so it doesn't need to reference its meshes
+			bool retainsMeshes() const;
+
 		};
 
 	}
@@ -95,9 +95,18 @@ namespace oi {
 			template<typename T>
 			void setValue(String path, const T &value);
 
+			template<typename T>
+			void setValue(const ShaderBufferHandle &handle, const T &value);
+
 			template<typename T>
 			void getValue(String path, T &value);
 
+			template<typename T>
+			void getValue(const ShaderBufferHandle &handle, T &value);
+
+			//Resolve a path once (see ShaderData::getHandle), so setValue doesn't have to parse it every call
+			ShaderBufferHandle getHandle(String path);
+
 			void setRegister(String path, GraphicsResource *res);
 			
 			template<typename T>
@@ -130,11 +139,21 @@ namespace oi {
 			info.shaderData->setValue(path, value);
 		}
 
+		template<typename T>
+		void Pipeline::setValue(const ShaderBufferHandle &handle, const T &value) {
+			info.shaderData->setValue(handle, value);
+		}
+
 		template<typename T>
 		void Pipeline::getValue(String path, T &value) {
 			info.shaderData->getValue(path, value);
 		}
 
+		template<typename T>
+		void Pipeline::getValue(const ShaderBufferHandle &handle, T &value) {
+			info.shaderData->getValue(handle, value);
+		}
+
 		template<typename T>
 		T *Pipeline::getRegister(String path) {
 			return info.shaderData->get<T>(path);
@@ -29,11 +29,15 @@ namespace oi {
 			std::vector<ShaderBufferObject*> childs;
 			std::vector<u32> arr;
 
+			//Hash of the name of a child to its index in childs
+			std::unordered_map<u64, u32> childIndex;
+
 			ShaderBufferObject(ShaderBufferObject *parent, u32 offset, u32 length, std::vector<u32> arr, String name, TextureFormat format, SBOFlag flags);
 			ShaderBufferObject();
 
 			void addChild(ShaderBufferObject *obj);
 			ShaderBufferObject *find(String name);
+			ShaderBufferObject *find(const char *name, u32 length);
 
 			bool operator==(const ShaderBufferObject &other) const;
 
@@ -41,6 +45,25 @@ namespace oi {
 
 		class ShaderBuffer;
 
+		//A path into a ShaderBuffer that has been resolved (see ShaderBuffer::getHandle)
+		//Setting a value through a handle doesn't have to parse the path or look up any names
+		struct ShaderBufferHandle {
+
+			ShaderBuffer *buffer = nullptr;
+			ShaderBufferObject *obj = nullptr;
+
+			u32 offset = 0, length = 0;
+
+			//The array dimensions that weren't indexed by the path (outer to inner) and their strides in bytes
+			std::vector<u32> dimensions, strides;
+
+			bool isValid() const { return obj != nullptr; }
+
+			//Index into the next array dimension; the same as appending "/i" to the path
+			ShaderBufferHandle operator[](u32 i) const;
+
+		};
+
 		struct ShaderBufferInfo {
 
 			typedef ShaderBuffer ResourceType;
@@ -78,9 +101,9 @@ namespace oi {
 		};
 
 		template<typename T> struct ShaderBufferCast { static bool check(u32 size, TextureFormat format) { return size == (u32) sizeof(T); } };
-		template<> struct ShaderBufferCast<f32> { static bool check(u32, TextureFormat format) { return format == TextureFormat::R32f; } };
-		template<> struct ShaderBufferCast<u32> { static bool check(u32, TextureFormat format) { return format == TextureFormat::R32u; } };
-		template<> struct ShaderBufferCast<i32> { static bool check(u32, TextureFormat format) { return format == TextureFormat::R32i; } };
+		template<> struct ShaderBufferCast<f32> { static bool check(u32, TextureFormat format) { return format.getIndex() == TextureFormat::R32f.value; } };
+		template<> struct ShaderBufferCast<u32> { static bool check(u32, TextureFormat format) { return format.getIndex() == TextureFormat::R32u.value; } };
+		template<> struct ShaderBufferCast<i32> { static bool check(u32, TextureFormat format) { return format.getIndex() == TextureFormat::R32i.value; } };
 
 		template<typename T, u32 n> struct ShaderBufferCast<TVec<T, n>> { static bool check(u32, TextureFormat format) { 
 
@@ -89,7 +112,11 @@ namespace oi {
 
 			static_assert(fl || std::is_integral<T>::value, "Only supports vector of int/uint and float");
 
-			return format.getValue() >= TextureFormat::RGBA32f && format.getValue() <= TextureFormat::R64i && 4 - (format.getValue() - TextureFormat::RGBA32f) % 4 == n && (fl ? format.getName().endsWith("f") : (uns ? format.getName().endsWith("u") : format.getName().endsWith("i")));
+			const TextureFormatInfo &info = textureFormatInfo[format.getIndex()];
+			const TextureFormatStorage storage = fl ? TextureFormatStorage::FLOAT : (uns ? TextureFormatStorage::UINT : TextureFormatStorage::INT);
+
+			//Only 32-bit and 64-bit color formats
+			return info.channels == n && !info.isDepth && (info.channelSize == 4 || info.channelSize == 8) && (info.storage == storage || (fl && info.storage == TextureFormatStorage::DOUBLE));
 		} };
 
 		template<typename T, u32 w, u32 h> struct ShaderBufferCast<TMatrix<T, w, h>> {
@@ -132,8 +159,13 @@ namespace oi {
 			const ShaderBufferInfo &getInfo() const;
 
 			ShaderBufferVar get(String path);
+			ShaderBufferVar get(const ShaderBufferHandle &handle);
 			ShaderBufferVar get();
 
+			//Resolve a path once; so it can be used to get/set values without parsing it again
+			//Handles stay valid as long as the ShaderBuffer exists; but have to be resolved after the object count is set
+			ShaderBufferHandle getHandle(String path);
+
 			u32 getElements() const;
 			u32 getSize() const;
 
@@ -153,9 +185,15 @@ namespace oi {
 			template<typename T>
 			T &get(String path);
 
+			template<typename T>
+			T &get(const ShaderBufferHandle &handle);
+
 			template<typename T>
 			void set(String path, T t);
 
+			template<typename T>
+			void set(const ShaderBufferHandle &handle, T t);
+
 		protected:
 
 			ShaderBuffer(ShaderBufferInfo info);
@@ -163,7 +201,6 @@ namespace oi {
 
 			bool init();
 
-			void calculateArrayInfo(std::vector<u32> &off, std::vector<u32> &len, u32 stride, u32 &offset, u32 &count);
 			void setObjectCount(u32 count);
 
 		private:
@@ -179,16 +216,23 @@ namespace oi {
 			return get(path).cast<T>();
 		}
 
+		template<typename T>
+		T &ShaderBuffer::get(const ShaderBufferHandle &handle) {
+			return get(handle).cast<T>();
+		}
+
 		template<typename T>
 		void ShaderBuffer::set(String path, T t) {
+			set(getHandle(path), t);
+		}
 
-			ShaderBufferVar var = get(path);
-			var.cast<T>() = t;
+		template<typename T>
+		void ShaderBuffer::set(const ShaderBufferHandle &handle, T t) {
 
-			if (buffer != nullptr) {
-				u32 start = u32(var.getBuffer().addr() - buffer->getAddress());
-				buffer->flush(Vec2u(start, start + var.getBuffer().size()));
-			}
+			get(handle).cast<T>() = t;
+
+			if (buffer != nullptr)
+				buffer->flush(Vec2u(handle.offset, handle.offset + handle.length));
 		}
 
 	}
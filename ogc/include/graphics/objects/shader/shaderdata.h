@@ -39,12 +39,21 @@ namespace oi {
 			template<typename T>
 			void setValue(String path, const T &val);
 
+			template<typename T>
+			void setValue(const ShaderBufferHandle &handle, const T &val);
+
 			template<typename T>
 			T *get(String path);
 
 			template<typename T>
 			void getValue(String path, T &val);
 
+			template<typename T>
+			void getValue(const ShaderBufferHandle &handle, T &val);
+
+			//Resolve "<buffer>/<path>" once; returns an invalid handle if the buffer couldn't be found
+			ShaderBufferHandle getHandle(String path);
+
 			void update();
 
 			void requestUpdate();
@@ -83,44 +92,25 @@ namespace oi {
 
 		template<typename T>
 		void ShaderData::setValue(String path, const T &val) {
+			setValue(getHandle(path), val);
+		}
 
-			auto it = info.shaderData.find(path.untilFirst("/"));
-
-			if (it == info.shaderData.end() || it->second == nullptr) {
-				Log::warn(String("Shader::setValue(") + path.untilFirst("/") + ") failed; the path couldn't be found");
-				return;
-			}
-
-			ShaderBuffer *shaderBuffer = it->second->cast<ShaderBuffer>();
-
-			if (shaderBuffer == nullptr) {
-				Log::warn(String("Shader::setValue(") + path.untilFirst("/") + ") failed; the path didn't evaluate to a buffer");
-				return;
-			}
-
-			shaderBuffer->set(path.fromFirst("/"), val);
+		template<typename T>
+		void ShaderData::setValue(const ShaderBufferHandle &handle, const T &val) {
+			if (handle.isValid())
+				handle.buffer->set(handle, val);
 		}
 
 		template<typename T>
 		void ShaderData::getValue(String path, T &val) {
-
-			auto it = info.shaderData.find(path.untilFirst("/"));
-
-			if (it == info.shaderData.end() || it->second == nullptr) {
-				Log::warn(String("Shader::getValue(") + path.untilFirst("/") + ") failed; the path couldn't be found");
-				return;
-			}
-
-			ShaderBuffer *shaderBuffer = it->second->cast<ShaderBuffer>();
-
-			if (shaderBuffer == nullptr) {
-				Log::warn(String("Shader::getValue(") + path.untilFirst("/") + ") failed; the path didn't evaluate to a buffer");
-				return;
-			}
-
-			val = shaderBuffer->get<T>(path.fromFirst("/"));
+			getValue(getHandle(path), val);
 		}
 
+		template<typename T>
+		void ShaderData::getValue(const ShaderBufferHandle &handle, T &val) {
+			if (handle.isValid())
+				val = handle.buffer->get<T>(handle);
+		}
 
 	}
 
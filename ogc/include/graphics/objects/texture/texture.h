@@ -76,6 +76,105 @@ namespace oi {
 			sRGBA8 = 8
 		);
 
+		//Describes a TextureFormat, indexed by TextureFormat::getIndex (which is equal to the value)
+		//This allows querying format properties without having to look at the name of the format
+		struct TextureFormatInfo {
+
+			u8 channels, channelSize;				//channelSize is in bytes; 0 if it's picked by the implementation (Depth, Depth_stencil)
+			TextureFormatStorage storage;
+			u32 loadFormat;							//The TextureLoadFormat it can be loaded as; Undefined if it can't be loaded from a file
+			bool isDepth = false, hasStencil = false, isSRGB = false, isBGR = false;
+
+		};
+
+		inline constexpr TextureFormatInfo textureFormatInfo[] = {
+			{ 0, 0, TextureFormatStorage::FLOAT, TextureLoadFormat::Undefined.value },		//Undefined
+			{ 4, 1, TextureFormatStorage::FLOAT, TextureLoadFormat::RGBA8.value },		//RGBA8
+			{ 3, 1, TextureFormatStorage::FLOAT, TextureLoadFormat::RGB8.value },		//RGB8
+			{ 2, 1, TextureFormatStorage::FLOAT, TextureLoadFormat::RG8.value },		//RG8
+			{ 1, 1, TextureFormatStorage::FLOAT, TextureLoadFormat::R8.value },		//R8
+			{ 4, 1, TextureFormatStorage::FLOAT, TextureLoadFormat::Undefined.value },		//RGBA8s
+			{ 3, 1, TextureFormatStorage::FLOAT, TextureLoadFormat::Undefined.value },		//RGB8s
+			{ 2, 1, TextureFormatStorage::FLOAT, TextureLoadFormat::Undefined.value },		//RG8s
+			{ 1, 1, TextureFormatStorage::FLOAT, TextureLoadFormat::Undefined.value },		//R8s
+			{ 4, 1, TextureFormatStorage::UINT, TextureLoadFormat::Undefined.value },		//RGBA8u
+			{ 3, 1, TextureFormatStorage::UINT, TextureLoadFormat::Undefined.value },		//RGB8u
+			{ 2, 1, TextureFormatStorage::UINT, TextureLoadFormat::Undefined.value },		//RG8u
+			{ 1, 1, TextureFormatStorage::UINT, TextureLoadFormat::Undefined.value },		//R8u
+			{ 4, 1, TextureFormatStorage::INT, TextureLoadFormat::Undefined.value },		//RGBA8i
+			{ 3, 1, TextureFormatStorage::INT, TextureLoadFormat::Undefined.value },		//RGB8i
+			{ 2, 1, TextureFormatStorage::INT, TextureLoadFormat::Undefined.value },		//RG8i
+			{ 1, 1, TextureFormatStorage::INT, TextureLoadFormat::Undefined.value },		//R8i
+			{ 4, 2, TextureFormatStorage::FLOAT, TextureLoadFormat::Undefined.value },		//RGBA16
+			{ 3, 2, TextureFormatStorage::FLOAT, TextureLoadFormat::Undefined.value },		//RGB16
+			{ 2, 2, TextureFormatStorage::FLOAT, TextureLoadFormat::Undefined.value },		//RG16
+			{ 1, 2, TextureFormatStorage::FLOAT, TextureLoadFormat::Undefined.value },		//R16
+			{ 4, 2, TextureFormatStorage::FLOAT, TextureLoadFormat::Undefined.value },		//RGBA16s
+			{ 3, 2, TextureFormatStorage::FLOAT, TextureLoadFormat::Undefined.value },		//RGB16s
+			{ 2, 2, TextureFormatStorage::FLOAT, TextureLoadFormat::Undefined.value },		//RG16s
+			{ 1, 2, TextureFormatStorage::FLOAT, TextureLoadFormat::Undefined.value },		//R16s
+			{ 4, 2, TextureFormatStorage::UINT, TextureLoadFormat::Undefined.value },		//RGBA16u
+			{ 3, 2, TextureFormatStorage::UINT, TextureLoadFormat::Undefined.value },		//RGB16u
+			{ 2, 2, TextureFormatStorage::UINT, TextureLoadFormat::Undefined.value },		//RG16u
+			{ 1, 2, TextureFormatStorage::UINT, TextureLoadFormat::Undefined.value },		//R16u
+			{ 4, 2, TextureFormatStorage::INT, TextureLoadFormat::Undefined.value },		//RGBA16i
+			{ 3, 2, TextureFormatStorage::INT, TextureLoadFormat::Undefined.value },		//RGB16i
+			{ 2, 2, TextureFormatStorage::INT, TextureLoadFormat::Undefined.value },		//RG16i
+			{ 1, 2, TextureFormatStorage::INT, TextureLoadFormat::Undefined.value },		//R16i
+			{ 4, 2, TextureFormatStorage::FLOAT, TextureLoadFormat::Undefined.value },		//RGBA16f
+			{ 3, 2, TextureFormatStorage::FLOAT, TextureLoadFormat::Undefined.value },		//RGB16f
+			{ 2, 2, TextureFormatStorage::FLOAT, TextureLoadFormat::Undefined.value },		//RG16f
+			{ 1, 2, TextureFormatStorage::FLOAT, TextureLoadFormat::Undefined.value },		//R16f
+			{ 4, 4, TextureFormatStorage::FLOAT, TextureLoadFormat::Undefined.value },		//RGBA32f
+			{ 3, 4, TextureFormatStorage::FLOAT, TextureLoadFormat::Undefined.value },		//RGB32f
+			{ 2, 4, TextureFormatStorage::FLOAT, TextureLoadFormat::Undefined.value },		//RG32f
+			{ 1, 4, TextureFormatStorage::FLOAT, TextureLoadFormat::Undefined.value },		//R32f
+			{ 4, 4, TextureFormatStorage::UINT, TextureLoadFormat::Undefined.value },		//RGBA32u
+			{ 3, 4, TextureFormatStorage::UINT, TextureLoadFormat::Undefined.value },		//RGB32u
+			{ 2, 4, TextureFormatStorage::UINT, TextureLoadFormat::Undefined.value },		//RG32u
+			{ 1, 4, TextureFormatStorage::UINT, TextureLoadFormat::Undefined.value },		//R32u
+			{ 4, 4, TextureFormatStorage::INT, TextureLoadFormat::Undefined.value },		//RGBA32i
+			{ 3, 4, TextureFormatStorage::INT, TextureLoadFormat::Undefined.value },		//RGB32i
+			{ 2, 4, TextureFormatStorage::INT, TextureLoadFormat::Undefined.value },		//RG32i
+			{ 1, 4, TextureFormatStorage::INT, TextureLoadFormat::Undefined.value },		//R32i
+			{ 4, 8, TextureFormatStorage::DOUBLE, TextureLoadFormat::Undefined.value },		//RGBA64f
+			{ 3, 8, TextureFormatStorage::DOUBLE, TextureLoadFormat::Undefined.value },		//RGB64f
+			{ 2, 8, TextureFormatStorage::DOUBLE, TextureLoadFormat::Undefined.value },		//RG64f
+			{ 1, 8, TextureFormatStorage::DOUBLE, TextureLoadFormat::Undefined.value },		//R64f
+			{ 4, 8, TextureFormatStorage::UINT, TextureLoadFormat::Undefined.value },		//RGBA64u
+			{ 3, 8, TextureFormatStorage::UINT, TextureLoadFormat::Undefined.value },		//RGB64u
+			{ 2, 8, TextureFormatStorage::UINT, TextureLoadFormat::Undefined.value },		//RG64u
+			{ 1, 8, TextureFormatStorage::UINT, TextureLoadFormat::Undefined.value },		//R64u
+			{ 4, 8, TextureFormatStorage::INT, TextureLoadFormat::Undefined.value },		//RGBA64i
+			{ 3, 8, TextureFormatStorage::INT, TextureLoadFormat::Undefined.value },		//RGB64i
+			{ 2, 8, TextureFormatStorage::INT, TextureLoadFormat::Undefined.value },		//RG64i
+			{ 1, 8, TextureFormatStorage::INT, TextureLoadFormat::Undefined.value },		//R64i
+			{ 1, 2, TextureFormatStorage::FLOAT, TextureLoadFormat::Undefined.value, true },		//D16
+			{ 1, 4, TextureFormatStorage::FLOAT, TextureLoadFormat::Undefined.value, true },		//D32
+			{ 1, 3, TextureFormatStorage::FLOAT, TextureLoadFormat::Undefined.value, true, true },		//D16S8
+			{ 1, 4, TextureFormatStorage::FLOAT, TextureLoadFormat::Undefined.value, true, true },		//D24S8
+			{ 1, 5, TextureFormatStorage::FLOAT, TextureLoadFormat::Undefined.value, true, true },		//D32S8
+			{ 1, 0, TextureFormatStorage::FLOAT, TextureLoadFormat::Undefined.value, true },		//Depth
+			{ 1, 0, TextureFormatStorage::FLOAT, TextureLoadFormat::Undefined.value, true, true },		//Depth_stencil
+			{ 4, 1, TextureFormatStorage::FLOAT, TextureLoadFormat::sRGBA8.value, false, false, true },		//sRGBA8
+			{ 3, 1, TextureFormatStorage::FLOAT, TextureLoadFormat::sRGB8.value, false, false, true },		//sRGB8
+			{ 2, 1, TextureFormatStorage::FLOAT, TextureLoadFormat::sRG8.value, false, false, true },		//sRG8
+			{ 1, 1, TextureFormatStorage::FLOAT, TextureLoadFormat::sR8.value, false, false, true },		//sR8
+			{ 4, 1, TextureFormatStorage::FLOAT, TextureLoadFormat::RGBA8.value, false, false, false, true },		//BGRA8
+			{ 3, 1, TextureFormatStorage::FLOAT, TextureLoadFormat::RGB8.value, false, false, false, true },		//BGR8
+			{ 4, 1, TextureFormatStorage::FLOAT, TextureLoadFormat::Undefined.value, false, false, false, true },		//BGRA8s
+			{ 3, 1, TextureFormatStorage::FLOAT, TextureLoadFormat::Undefined.value, false, false, false, true },		//BGR8s
+			{ 4, 1, TextureFormatStorage::UINT, TextureLoadFormat::Undefined.value, false, false, false, true },		//BGRA8u
+			{ 3, 1, TextureFormatStorage::UINT, TextureLoadFormat::Undefined.value, false, false, false, true },		//BGR8u
+			{ 4, 1, TextureFormatStorage::INT, TextureLoadFormat::Undefined.value, false, false, false, true },		//BGRA8i
+			{ 3, 1, TextureFormatStorage::INT, TextureLoadFormat::Undefined.value, false, false, false, true },		//BGR8i
+			{ 4, 1, TextureFormatStorage::FLOAT, TextureLoadFormat::sRGBA8.value, false, false, true, true },		//sBGRA8
+			{ 3, 1, TextureFormatStorage::FLOAT, TextureLoadFormat::sRGB8.value, false, false, true, true } 		//sBGR8
+		};
+
+		static_assert(sizeof(textureFormatInfo) / sizeof(TextureFormatInfo) == TextureFormat::length, "textureFormatInfo should have an entry per TextureFormat");
+		static_assert(TextureFormat::sBGR8.value == TextureFormat::length - 1, "TextureFormat values should be equal to their index");
+
 		struct TextureInfo {
 
 			typedef Texture ResourceType;
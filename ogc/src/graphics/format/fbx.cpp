@@ -1,43 +1,43 @@
 #include "utils/log.h"
 #include "utils/timer.h"
+#include "utils/hash.h"
+#include "types/threadpool.h"
 #include "types/vector.h"
 #include "file/filemanager.h"
 #include "graphics/format/fbx.h"
 #include "graphics/format/oirm.h"
+#include "graphics/format/meshoptimizer.h"
 
 using namespace oi::gc;
 using namespace oi::wc;
 using namespace oi;
 
-FbxProperty *FbxProperty::readProperty(Buffer &buffer, u32 &offset) {
+FbxProperty *FbxProperty::readProperty(Arena &arena, Buffer &buffer, u32 &offset) {
 
 	if (buffer.size() == 0)
 		return (FbxProperty*) Log::error("Couldn't read FbxProperty; buffer was null");
 
 	char type = buffer[0];
 
-	FbxProperty *allocated = FbxTypeAlloc::allocate(type);
+	FbxProperty *allocated = FbxTypeAlloc::allocate(arena, type);
 
 	if(allocated == nullptr)
 		return (FbxProperty*) Log::error("Couldn't allocate FbxProperty; invalid type");
 
-	if (!allocated->read(buffer, offset)) {
-		delete allocated;
+	if (!allocated->read(buffer, offset))
 		return (FbxProperty*)Log::error("Couldn't read FbxProperty");
-	}
 
 	return allocated;
 }
 
-FbxNode *FbxNode::read(Buffer &buf, u32 &offset, bool is64bit) {
+FbxNode *FbxNode::read(Arena &arena, FbxNodes &stack, Buffer &buf, u32 &offset, bool is64bit) {
 
 	u32 headerSize = is64bit ? FbxNodeHeader64::size() : FbxNodeHeader32::size();
 
 	if (buf.size() < headerSize)
 		return (FbxNode*) Log::error("Couldn't read FbxNode; invalid buffer size");
 
-	FbxNode *node = new FbxNode();
-	node->childs.reserve(16);
+	FbxNode *node = arena.create<FbxNode>();
 
 	if (is64bit) {
 
@@ -64,118 +64,145 @@ FbxNode *FbxNode::read(Buffer &buf, u32 &offset, bool is64bit) {
 	if (buf.size() < node->header.nameLen)
 		return (FbxNode*) Log::error("Couldn't read FbxNode's name; invalid buffer size");
 
-	node->name = String((char*) buf.addr(), node->header.nameLen);
+	//The name isn't null terminated; so it points into the buffer with nameLen
+	node->name = (const char*) buf.addr();
+	node->nameHash = Hash::xx64(buf.addr(), node->header.nameLen);
 	buf = buf.offset(node->header.nameLen);
 	offset += node->header.nameLen;
 
-	u32 i = 0;
+	if (node->header.numProperties > buf.size())
+		return (FbxNode*) Log::error(String("Couldn't read FbxNode's properties (") + node->getName() + "); invalid property count");
 
-	while (i < node->header.numProperties) {
+	node->propertyCount = (u32) node->header.numProperties;
+	node->properties = arena.allocArray<FbxProperty*>(node->propertyCount);
 
-		FbxProperty *prop;
+	for (u32 i = 0; i < node->propertyCount; ++i)
+		if ((node->properties[i] = FbxProperty::readProperty(arena, buf, offset)) == nullptr)
+			return (FbxNode*) Log::error(String("Couldn't read FbxNode's properties (") + node->getName() + ")");
 
-		if((prop = FbxProperty::readProperty(buf, offset)) != nullptr)
-			node->properties.push_back(prop);
-		else 
-			return (FbxNode*) Log::error(String("Couldn't read FbxNode's properties (") + node->name + ")");
+	//Children are pushed onto the shared stack and moved into the arena once they're all known
 
-		++i;
-	}
+	size_t stackStart = stack.size();
 
 	while (offset < node->header.endOffset) {
 
-	FbxNode *subnode;
+		FbxNode *subnode;
 
-		if ((subnode = FbxNode::read(buf, offset, is64bit)) == nullptr)
-			return (FbxNode*) Log::error(String("Couldn't read FbxNode's child nodes (") + node->name + ")");
+		if ((subnode = FbxNode::read(arena, stack, buf, offset, is64bit)) == nullptr) {
+			stack.resize(stackStart);
+			return (FbxNode*) Log::error(String("Couldn't read FbxNode's child nodes (") + node->getName() + ")");
+		}
 
 		if (subnode->header.nameLen != 0)
-			node->childs.push_back(subnode);
+			stack.push_back(subnode);
 
 	}
 
+	node->childCount = (u32)(stack.size() - stackStart);
+	node->childs = arena.allocArray<FbxNode*>(node->childCount);
+
+	if (node->childCount != 0)
+		memcpy(node->childs, stack.data() + stackStart, sizeof(FbxNode*) * node->childCount);
+
+	stack.resize(stackStart);
 	return node;
 
 }
 
-FbxNodes FbxNode::readAll(Buffer &buf, u32 &offset, bool is64bit) {
+FbxNode *FbxNode::readAll(Arena &arena, Buffer &buf, u32 &offset, bool is64bit) {
 
 	FbxNode *node = nullptr;
-	FbxNodes nodes;
-	nodes.reserve(16);
+	FbxNodes stack;
+	stack.reserve(256);
 
 	while (buf.size() > 0) {
 
-		if ((node = read(buf, offset, is64bit)) == nullptr) {
-			Log::error("Couldn't read an fbx node");
-			return {};
-		}
+		if ((node = read(arena, stack, buf, offset, is64bit)) == nullptr)
+			return (FbxNode*) Log::error("Couldn't read an fbx node");
 
 		if (node->header.nameLen != 0)
-			nodes.push_back(node);
+			stack.push_back(node);
 		else
 			break;
 
 	}
 
-	return nodes;
+	FbxNode *root = arena.create<FbxNode>();
+
+	static constexpr char rootName[] = "Root";
+
+	root->header.nameLen = (u8)(sizeof(rootName) - 1);
+	root->name = rootName;
+	root->nameHash = Hash::xx64((const u8*) rootName, root->header.nameLen);
+
+	root->childCount = (u32) stack.size();
+	root->childs = arena.allocArray<FbxNode*>(root->childCount);
+
+	if (root->childCount != 0)
+		memcpy(root->childs, stack.data(), sizeof(FbxNode*) * root->childCount);
+
+	return root;
 
 }
 
-void FbxNode::findNodes(String path, const FbxNodes &loc, FbxNodes &target) {
+bool FbxNode::hasName(const char *str, u32 length, u64 hash) {
+	return nameHash == hash && header.nameLen == length && memcmp(name, str, length) == 0;
+}
 
-	String term = path.untilFirst("/");
-	String child = path.fromFirst("/");
+void FbxNode::findNodes(const char *path, u32 length, FbxNodes &target) {
 
-	for(FbxNode *node : loc)
-		if (node->getName() == term) {
-			if (child != "")
-				findNodes(child, node->getChildArray(), target);
+	u32 termLength = 0;
+
+	while (termLength < length && path[termLength] != '/')
+		++termLength;
+
+	const char *child = path + termLength + 1;
+	u32 childLength = termLength < length ? length - termLength - 1 : 0;
+
+	u64 hash = Hash::xx64((const u8*) path, termLength);
+
+	for (u32 i = 0; i < childCount; ++i) {
+
+		FbxNode *node = childs[i];
+
+		if (node->hasName(path, termLength, hash)) {
+			if (childLength != 0)
+				node->findNodes(child, childLength, target);
 			else
 				target.push_back(node);
 		}
+	}
 
 }
 
 FbxNodes FbxNode::findNodes(String path) {
 	FbxNodes result;
-	findNodes(path, childs, result);
+	findNodes(path.toCString(), path.size(), result);
 	return result;
 
 }
 
 FbxFile::~FbxFile() {
-	delete root;
-}
-
-void FbxFile::copy(const FbxFile &other) {
-
-	header = other.header;
-	root = new FbxNode(*other.root);
-
+	if (mapped.size() != 0)
+		FileManager::get()->unmap(mapped);
 }
 
-FbxFile::FbxFile(const FbxFile &other) { copy(other); }
-FbxFile &FbxFile::operator=(const FbxFile &other) { copy(other); return *this; }
-
 FbxNodes FbxFile::findMeshes() { return get()->findNodes("Objects/Model", { 2 }, String("Mesh")); }
 FbxNodes FbxFile::findLights() { return get()->findNodes("Objects/Model", { 2 }, String("Light")); }
 FbxNodes FbxFile::findCameras() { return get()->findNodes("Objects/Model", { 2 }, String("Camera")); }
 FbxNodes FbxFile::findGeometry() { return get()->findNodes("Objects/Geometry"); }
-FbxFile::FbxFile(FbxHeader header, FbxNodes nodes) : header(header), root(new FbxNode(nodes)) {}
+FbxFile::FbxFile(FbxHeader header) : header(header) {}
 
-u32 FbxNode::getChildren() { return (u32) childs.size(); }
+u32 FbxNode::getChildren() { return childCount; }
 FbxNode *FbxNode::getChild(u32 i) { return i >= getChildren() ? nullptr : childs[i]; }
-u32 FbxNode::getProperties(){ return (u32) properties.size(); }
+u32 FbxNode::getProperties(){ return propertyCount; }
 FbxProperty *FbxNode::getProperty(u32 i) { return i >= getProperties() ? nullptr : properties[i]; }
-String FbxNode::getName() { return name; }
+String FbxNode::getName() { return String((char*) name, (u32) header.nameLen); }
 
-FbxProperties::iterator FbxNode::getPropertyBegin() { return properties.begin(); }
-FbxProperties::iterator FbxNode::getPropertyEnd() { return properties.end(); }
-const FbxProperties &FbxNode::getPropertyArray() { return properties; }
-FbxNodes::iterator FbxNode::getChildBegin() { return childs.begin(); }
-FbxNodes::iterator FbxNode::getChildEnd() { return childs.end(); }
-const FbxNodes &FbxNode::getChildArray() { return childs; }
+FbxProperty **FbxNode::getPropertyBegin() { return properties; }
+FbxProperty **FbxNode::getPropertyEnd() { return properties + propertyCount; }
+FbxNode **FbxNode::getChildBegin() { return childs; }
+FbxNode **FbxNode::getChildEnd() { return childs + childCount; }
 
 u32 FbxFile::getVersion() { return header.getVersion(); }
 bool FbxFile::isValid() { return header.getHeader() == "Kaydara FBX Binary  " && header.getUnknown() == 0x1A; }
@@ -184,10 +211,6 @@ FbxNode *FbxFile::get() { return root; }
 
 FbxFile *FbxFile::read(Buffer buf) {
 
-	goto binary;
-
-binary:
-
 	if (buf.size() < FbxHeader::size())
 		return (FbxFile*) Log::error("Couldn't read Fbx; invalid buffer size");
 
@@ -197,28 +220,38 @@ binary:
 	memcpy(&head, buf.addr(), FbxHeader::size());
 
 	u32 offset = (u32)FbxHeader::size();
-	buf = buf.offset(offset);
+	buf = buf.subbuffer(offset, buf.size() - offset);
 
 	if (head.getHeader() != "Kaydara FBX Binary  " || head.getUnknown() != 0x001A)
 		return (FbxFile*) Log::error("Couldn't read Fbx; invalid header");
 
-	FbxNodes nodes = FbxNode::readAll(buf, offset, head.getVersion() >= 7500 /* Starting from version 7.5, they use 64-bit format for nodes*/);
+	FbxFile *file = new FbxFile(head);
 
-	return new FbxFile(head, nodes);
+	//Starting from version 7.5, they use 64-bit format for nodes
+	if ((file->root = FbxNode::readAll(file->arena, buf, offset, head.getVersion() >= 7500)) == nullptr) {
+		delete file;
+		return (FbxFile*) Log::error("Couldn't read Fbx; invalid nodes");
+	}
+
+	return file;
 }
 
 FbxFile *FbxFile::read(String fbxPath) {
 
 	Buffer buf;
-	FileManager::get()->read(fbxPath, buf);
 
-	if (buf.size() == 0) {
-		Log::error("Couldn't read from file");
-		return {};
+	if (!FileManager::get()->map(fbxPath, buf) || buf.size() == 0) {
+		FileManager::get()->unmap(buf);
+		return (FbxFile*) Log::error("Couldn't read from file");
 	}
 
 	FbxFile *file = read(buf);
-	buf.deconstruct();
+
+	if (file == nullptr)
+		FileManager::get()->unmap(buf);
+	else
+		file->mapped = buf;
+
 	return file;
 
 }
@@ -247,6 +280,11 @@ std::unordered_map<String, Buffer> Fbx::convertMeshes(Buffer buf, bool compressi
 
 	FbxFile *file = FbxFile::read(buf);
 
+	if (file == nullptr) {
+		Log::error("Couldn't convert fbx; the file couldn't be read");
+		return {};
+	}
+
 	const char *zeroNe = "\0\x1";
 	String zerone = String((char*)zeroNe, 2);
 
@@ -272,7 +310,7 @@ std::unordered_map<String, Buffer> Fbx::convertMeshes(Buffer buf, bool compressi
 		f32 shininessExponent = getMaterialNum(types["ShininessExponent"]);
 		Vec3 reflection = getMaterialCol(types["ReflectionColor"]) * getMaterialNum(types["ReflectionFactor"], 1);
 
-		Log::println(String("Material: ") + emissive + " " + diffuse + " " + transparency + " " + specular + " " + shininess + " " + shininessExponent + " " + reflection);
+		Log::format("Material: {} {} {} {} {} {} {}", emissive, diffuse, transparency, specular, shininess, shininessExponent, reflection);
 
 		//TODO: Save materials
 
@@ -281,192 +319,210 @@ std::unordered_map<String, Buffer> Fbx::convertMeshes(Buffer buf, bool compressi
 	std::unordered_map<String, Buffer> meshes;
 
 	FbxNodes geometry = file->findGeometry();
+	u32 geometries = (u32) geometry.size();
 
-	String lastError;
+	std::vector<String> names(geometries), errors(geometries);
+	std::vector<Buffer> results(geometries);
 
-	u32 id = 0;
+	//Names are resolved first; duplicates depend on the order of the geometry
+	//Only the geometry before the first invalid name has to be converted
 
-	for (FbxNode *node : geometry) {
+	u32 count = 0;
+	String lastError;
+
+	for (; count < geometries; ++count) {
 
-		FbxProperty *namep = node->getProperty(1);
+		FbxProperty *namep = geometry[count]->getProperty(1);
 
 		if (namep == nullptr || namep->getCode() != 'S') {
 			lastError = "Couldn't convert geometry object; there was no string object for name";
-			goto failed;
+			break;
 		}
 		
-		String name = namep->cast<FbxString>()->get().untilFirst(zerone);
+		String &name = names[count] = namep->cast<FbxString>()->get().untilFirst(zerone);
 
-		if (name == "") name = id;
-		if (geometry.size() == 1) name = "";
+		if (name == "") name = count;
+		if (geometries == 1) name = "";
 
-		FbxNodes vertices = node->findNodes("Vertices");						//Vec3d[]
-		FbxNodes vertexOrder = node->findNodes("PolygonVertexIndex");			//i32[]
-		FbxNodes normals = node->findNodes("LayerElementNormal");				//Vec3d[]
-		FbxNodes uvs = node->findNodes("LayerElementUV");						//Vec2d[] and i32[]
-		//FbxNodes materials = node->findNodes("LayerElementMaterial");
-
-		if (vertices.size() == 0 || vertexOrder.size() == 0 || vertices[0]->getProperties() == 0 || vertexOrder[0]->getProperties() == 0) {
-			lastError = String("Couldn't find the vertices of a geometry object (") + name + ")";
-			goto failed;
-		}
-
-		if (meshes.find(name) != meshes.end()) {
+		if (std::find(names.begin(), names.begin() + count, name) != names.begin() + count) {
 			lastError = String("The geometry object \"") + name + "\" is duplicated. This is not supported";
-			goto failed;
+			break;
 		}
 
-		FbxDoubleArray *pos = vertices[0]->getProperty(0)->cast<FbxDoubleArray>();
-		FbxIntArray *posOrder = vertexOrder[0]->getProperty(0)->cast<FbxIntArray>();
+	}
 
-		if (pos == nullptr || posOrder == nullptr) {
-			lastError = String("The geometry object \"") + name + "\" has invalid positional data";
-			goto failed;
-		}
+	//Every geometry is independent and only writes into its own slot
+	ThreadPool::get().parallelFor(0, count, 1, [&](u32 i) {
+		convertGeometry(geometry[i], names[i], compression, results[i], errors[i]);
+	});
 
-		//required Vec3 pos; optional Vec2 uv; optional Vec3 normal;
-		u32 posuv = 3 + (uvs.size() != 0 ? 2 : 0);
-		u32 stride = posuv + (normals.size() != 0 ? 3 : 0);
-		u32 vertCount = posOrder->size();
-		std::vector<f32> buffer(vertCount * stride);
+	//Report the first error in order of the geometry, just like a serial conversion would
 
-		std::vector<Vec2u> faces;
-		u32 prev = 0, indices = 0;
+	for (u32 i = count; i > 0; --i)
+		if (errors[i - 1] != "")
+			lastError = errors[i - 1];
 
-		//Vertex positions are only stored once, but referenced to by vertexOrder
-		Vec3d *vpos = (Vec3d*)&pos->get();
+	if (lastError == "")
+		for (u32 i = 0; i < count; ++i)
+			meshes[names[i].untilFirst(zerone)] = results[i];
+	else {
 
-		for (u32 i = 0; i < vertCount; ++i) {
+		for (Buffer &result : results)
+			result.deconstruct();
 
-			i32 j = posOrder->get(i);
-			i32 k = j < 0 ? (-j - 1) : j;
+		Log::error(lastError);
+	}
 
-			if ((u32)k >= pos->size() / 3) {
-				lastError = String("The geometry object \"") + name + "\" has invalid positional data";
-				goto failed;
-			}
+	delete file;
 
-			*(Vec3*)(buffer.data() + i * stride) = ((Vec3(vpos[k]) * 1000).round() / 1000).fix();
+	return meshes;
 
-			if (j < 0) {
-				indices += (i - prev - 1) * 3;
-				faces.push_back(Vec2u(prev, i));
-				prev = i + 1;
-			}
+}
 
-		}
+bool Fbx::convertGeometry(FbxNode *node, const String &name, bool compression, Buffer &result, String &error) {
 
-		//Normals are stored in a Vec3d[]
-		if (normals.size() > 0) {
+	FbxNodes vertices = node->findNodes("Vertices");						//Vec3d[]
+	FbxNodes vertexOrder = node->findNodes("PolygonVertexIndex");			//i32[]
+	FbxNodes normals = node->findNodes("LayerElementNormal");				//Vec3d[]
+	FbxNodes uvs = node->findNodes("LayerElementUV");						//Vec2d[] and i32[]
+	//FbxNodes materials = node->findNodes("LayerElementMaterial");
 
-			if (normals.size() != 1) {
-				lastError = String("The geometry object \"") + name + "\" has more than 1 normal set. This is not supported";
-				goto failed;
-			}
+	if (vertices.size() == 0 || vertexOrder.size() == 0 || vertices[0]->getProperties() == 0 || vertexOrder[0]->getProperties() == 0) {
+		error = String("Couldn't find the vertices of a geometry object (") + name + ")";
+		return false;
+	}
 
-			FbxNodes normalDat = normals[0]->findNodes("Normals");
+	FbxDoubleArray *pos = vertices[0]->getProperty(0)->tryCast<FbxDoubleArray>();
+	FbxIntArray *posOrder = vertexOrder[0]->getProperty(0)->tryCast<FbxIntArray>();
 
-			if (normalDat.size() != 1 || normalDat[0]->getProperties() == 0) {
-				lastError = String("The geometry object \"") + name + "\" doesn't have a valid normal set";
-				goto failed;
-			}
+	if (pos == nullptr || posOrder == nullptr || !pos->decode() || !posOrder->decode()) {
+		error = String("The geometry object \"") + name + "\" has invalid positional data";
+		return false;
+	}
 
-			FbxDoubleArray *normalp = normalDat[0]->getProperty(0)->cast<FbxDoubleArray>();
+	//required Vec3 pos; optional Vec2 uv; optional Vec3 normal;
+	u32 posuv = 3 + (uvs.size() != 0 ? 2 : 0);
+	u32 stride = posuv + (normals.size() != 0 ? 3 : 0);
+	u32 vertCount = posOrder->size();
+	std::vector<f32> buffer(vertCount * stride);
 
-			if (normalp == nullptr) {
-				lastError = String("The geometry object \"") + name + "\" doesn't have a valid normal set";
-				goto failed;
-			}
+	std::vector<Vec2u> faces;
+	u32 prev = 0, indices = 0;
+
+	//Vertex positions are only stored once, but referenced to by vertexOrder
+	Vec3d *vpos = (Vec3d*)&pos->get();
 
-			Vec3d *uvDat = (Vec3d*)normalp->getPtr();
+	for (u32 i = 0; i < vertCount; ++i) {
 
-			for (u32 i = 0; i < normalp->size() / 3; ++i)
-				*(Vec3*)(buffer.data() + i * stride + posuv) = ((Vec3(uvDat[i]) * 1000).round() / 1000).fix();
+		i32 j = posOrder->get(i);
+		i32 k = j < 0 ? (-j - 1) : j;
 
+		if ((u32)k >= pos->size() / 3) {
+			error = String("The geometry object \"") + name + "\" has invalid positional data";
+			return false;
 		}
 
-		//Uvs are stored in a Vec2d[] and duplicated uvs are not allowed
-		//so an index to a UV is used to avoid duplicating uvs
-		if (uvs.size() > 0) {
+		*(Vec3*)(buffer.data() + i * stride) = ((Vec3(vpos[k]) * 1000).round() / 1000).fix();
 
-			if (uvs.size() != 1) {
-				lastError = String("The geometry object \"") + name + "\" has more than 1 uv set. This is not supported";
-				goto failed;
-			}
+		if (j < 0) {
+			indices += (i - prev - 1) * 3;
+			faces.push_back(Vec2u(prev, i));
+			prev = i + 1;
+		}
 
-			FbxNodes uvDatn = uvs[0]->findNodes("UV");
-			FbxNodes uvIndn = uvs[0]->findNodes("UVIndex");
+	}
 
-			if (uvDatn.size() != 1 || uvIndn.size() != 1 || uvDatn[0]->getProperties() == 0 || uvIndn[0]->getProperties() == 0) {
-				lastError = String("The geometry object \"") + name + "\" had an invalid UV set";
-				goto failed;
-			}
+	//Normals are stored in a Vec3d[]
+	if (normals.size() > 0) {
 
-			FbxDoubleArray *uvData = uvDatn[0]->getProperty(0)->cast<FbxDoubleArray>();
+		if (normals.size() != 1) {
+			error = String("The geometry object \"") + name + "\" has more than 1 normal set. This is not supported";
+			return false;
+		}
 
-			if (uvData == nullptr) {
-				lastError = String("The geometry object \"") + name + "\" had an invalid UV set";
-				goto failed;
-			}
+		FbxNodes normalDat = normals[0]->findNodes("Normals");
 
-			Vec2d *uvDat = (Vec2d*)uvData->getPtr();
+		if (normalDat.size() != 1 || normalDat[0]->getProperties() == 0) {
+			error = String("The geometry object \"") + name + "\" doesn't have a valid normal set";
+			return false;
+		}
 
-			FbxIntArray *uvInd = uvIndn[0]->getProperty(0)->cast<FbxIntArray>();
+		FbxDoubleArray *normalp = normalDat[0]->getProperty(0)->tryCast<FbxDoubleArray>();
 
-			if (uvInd == nullptr) {
-				lastError = String("The geometry object \"") + name + "\" had an invalid UVIndex array.";
-				goto failed;
-			}
+		if (normalp == nullptr || !normalp->decode()) {
+			error = String("The geometry object \"") + name + "\" doesn't have a valid normal set";
+			return false;
+		}
 
-			for (u32 i = 0; i < uvInd->size(); ++i)
-				*(Vec2*)(buffer.data() + i * stride + 3) = ((Vec2(uvDat[uvInd->get(i)]) * 1000).round() / 1000).fix();
+		Vec3d *uvDat = (Vec3d*)normalp->getPtr();
 
-		}
+		for (u32 i = 0; i < normalp->size() / 3; ++i)
+			*(Vec3*)(buffer.data() + i * stride + posuv) = ((Vec3(uvDat[i]) * 1000).round() / 1000).fix();
+
+	}
 
-		u32 ind = 0;
-		std::vector<u32> index(indices);
+	//Uvs are stored in a Vec2d[] and duplicated uvs are not allowed
+	//so an index to a UV is used to avoid duplicating uvs
+	if (uvs.size() > 0) {
 
-		for (Vec2u face : faces) {
-			for (u32 x = 1; x < face.y - face.x; ++x) {
-				*(Vec3u*)(index.data() + ind) = { face.x + x + 1, face.x + x, face.x };
-				ind += 3;
-			}
+		if (uvs.size() != 1) {
+			error = String("The geometry object \"") + name + "\" has more than 1 uv set. This is not supported";
+			return false;
 		}
 
-		/*t.print();*/
+		FbxNodes uvDatn = uvs[0]->findNodes("UV");
+		FbxNodes uvIndn = uvs[0]->findNodes("UVIndex");
 
-		RMFile rfile = oiRM::generate(Buffer::construct((u8*) buffer.data(), vertCount * stride * 4), Buffer::construct((u8*)index.data(), indices * 4), true, uvs.size() != 0, normals.size() != 0, vertCount, indices);
-		Buffer obuf = oiRM::write(rfile, compression);
+		if (uvDatn.size() != 1 || uvIndn.size() != 1 || uvDatn[0]->getProperties() == 0 || uvIndn[0]->getProperties() == 0) {
+			error = String("The geometry object \"") + name + "\" had an invalid UV set";
+			return false;
+		}
 
-		if (obuf.size() == 0) {
-			lastError = String("The geometry object \"") + name + "\" couldn't be converted to oiRM.";
-			goto failed;
+		FbxDoubleArray *uvData = uvDatn[0]->getProperty(0)->tryCast<FbxDoubleArray>();
+
+		if (uvData == nullptr || !uvData->decode()) {
+			error = String("The geometry object \"") + name + "\" had an invalid UV set";
+			return false;
 		}
 
-		meshes[name.untilFirst(zerone)] = obuf;
+		Vec2d *uvDat = (Vec2d*)uvData->getPtr();
 
-		++id;
+		FbxIntArray *uvInd = uvIndn[0]->getProperty(0)->tryCast<FbxIntArray>();
 
-	}
+		if (uvInd == nullptr || !uvInd->decode()) {
+			error = String("The geometry object \"") + name + "\" had an invalid UVIndex array.";
+			return false;
+		}
 
-	goto success;
+		for (u32 i = 0; i < uvInd->size(); ++i)
+			*(Vec2*)(buffer.data() + i * stride + 3) = ((Vec2(uvDat[uvInd->get(i)]) * 1000).round() / 1000).fix();
 
-	failed:
+	}
 
-	for (auto &elem : meshes)
-		elem.second.deconstruct();
+	u32 ind = 0;
+	std::vector<u32> index(indices);
 
-	Log::error(lastError);
-	meshes.clear();
+	for (Vec2u face : faces) {
+		for (u32 x = 1; x < face.y - face.x; ++x) {
+			*(Vec3u*)(index.data() + ind) = { face.x + x + 1, face.x + x, face.x };
+			ind += 3;
+		}
+	}
 
-	success:
+	//Every polygon corner is a vertex; weld them and reorder for the vertex cache
+	vertCount = MeshOptimizer::optimize(Buffer::construct((u8*) buffer.data(), vertCount * stride * 4), stride * 4, Buffer::construct((u8*) index.data(), indices * 4), name);
 
-	delete file;
+	RMFile rfile = oiRM::generate(Buffer::construct((u8*) buffer.data(), vertCount * stride * 4), Buffer::construct((u8*)index.data(), indices * 4), true, uvs.size() != 0, normals.size() != 0, vertCount, indices, name);
+	result = oiRM::write(rfile, compression);
 
-	return meshes;
+	if (result.size() == 0) {
+		error = String("The geometry object \"") + name + "\" couldn't be converted to oiRM.";
+		return false;
+	}
 
-}
+	return true;
 
+}
 
 bool Fbx::convertMeshes(Buffer fbxBuffer, String outPath, bool compression) {
 
@@ -506,26 +562,29 @@ bool Fbx::convertMeshes(Buffer fbxBuffer, String outPath, bool compression) {
 std::unordered_map<String, Buffer> Fbx::convertMeshes(String fbxPath, bool compression) {
 
 	Buffer buf;
-	FileManager::get()->read(fbxPath, buf);
 
-	if (buf.size() == 0) {
+	if (!FileManager::get()->map(fbxPath, buf) || buf.size() == 0) {
+		FileManager::get()->unmap(buf);
 		Log::error("Couldn't read from file");
 		return {};
 	}
 
-	return convertMeshes(buf, compression);
+	std::unordered_map<String, Buffer> meshes = convertMeshes(buf, compression);
+	FileManager::get()->unmap(buf);
+	return meshes;
 
 }
 
 bool Fbx::convertMeshes(String fbxPath, String outPath, bool compression) {
 
 	Buffer buf;
-	FileManager::get()->read(fbxPath, buf);
 
-	if (buf.size() == 0)
+	if (!FileManager::get()->map(fbxPath, buf) || buf.size() == 0) {
+		FileManager::get()->unmap(buf);
 		return Log::error("Couldn't read from file");
+	}
 
 	bool converted = convertMeshes(buf, outPath, compression);
-	buf.deconstruct();
+	FileManager::get()->unmap(buf);
 	return converted;
 }
\ No newline at end of file
@@ -0,0 +1,723 @@
+#include "utils/log.h"
+#include "utils/hash.h"
+#include "utils/timer.h"
+#include "graphics/format/meshoptimizer.h"
+#include <atomic>
+#include <cstring>
+#include <algorithm>
+#include <unordered_map>
+
+using namespace oi::gc;
+using namespace oi;
+
+static std::atomic<bool> meshReporting{ false };
+static std::vector<f32> lodErrors = { .005f, .02f, .05f };
+
+//Check if the buffers are triangle lists that only reference existing vertices
+static bool isValidMesh(Buffer ibo, u32 vertices, const char *func) {
+
+	if (ibo.size() % 12 != 0)
+		return Log::error(String(func) + " failed; the ibo has to be a triangle list (u32)");
+
+	const u32 *ind = (const u32*) ibo.addr();
+
+	for (u32 i = 0, j = ibo.size() / 4; i < j; ++i)
+		if (ind[i] >= vertices)
+			return Log::error(String(func) + " failed; the ibo references a vertex that doesn't exist");
+
+	return true;
+}
+
+u32 MeshOptimizer::weldVertices(Buffer vbo, u32 stride, Buffer ibo) {
+
+	if (stride == 0 || vbo.size() % stride != 0) {
+		Log::error("MeshOptimizer::weldVertices failed; the vbo isn't a multiple of the stride");
+		return 0;
+	}
+
+	u32 vertices = vbo.size() / stride;
+
+	if (!isValidMesh(ibo, vertices, "MeshOptimizer::weldVertices"))
+		return vertices;
+
+	u32 tableSize = 16;
+
+	while (tableSize < vertices * 2)
+		tableSize *= 2;
+
+	//Open addressing table of unique vertices; unique vertex j is moved to position j, so it can be compared in place
+
+	std::vector<u32> table(tableSize, u32_MAX), remap(vertices);
+	std::vector<u64> hashes;
+	hashes.reserve(vertices);
+
+	u8 *dat = vbo.addr();
+	u32 mask = tableSize - 1, unique = 0;
+
+	for (u32 i = 0; i < vertices; ++i) {
+
+		const u8 *vert = dat + (size_t) i * stride;
+		u64 h = Hash::xx64(vert, stride);
+
+		for (u32 j = u32(h) & mask;; j = (j + 1) & mask) {
+
+			u32 &slot = table[j];
+
+			if (slot == u32_MAX) {
+
+				if (unique != i)
+					memmove(dat + (size_t) unique * stride, vert, stride);
+
+				hashes.push_back(h);
+				slot = remap[i] = unique++;
+				break;
+			}
+
+			if (hashes[slot] == h && memcmp(dat + (size_t) slot * stride, vert, stride) == 0) {
+				remap[i] = slot;
+				break;
+			}
+		}
+	}
+
+	u32 *ind = (u32*) ibo.addr();
+
+	for (u32 i = 0, j = ibo.size() / 4; i < j; ++i)
+		ind[i] = remap[ind[i]];
+
+	return unique;
+}
+
+void MeshOptimizer::optimizeVertexCache(Buffer ibo, u32 vertices, u32 cache) {
+
+	if (!isValidMesh(ibo, vertices, "MeshOptimizer::optimizeVertexCache"))
+		return;
+
+	u32 *ind = (u32*) ibo.addr();
+	u32 triangles = ibo.size() / 12;
+
+	if (triangles == 0)
+		return;
+
+	//Triangles per vertex (offsets + list)
+
+	std::vector<u32> live(vertices), offsets(vertices + 1), adjacency(triangles * 3);
+
+	for (u32 i = 0; i < triangles * 3; ++i)
+		++live[ind[i]];
+
+	for (u32 i = 0; i < vertices; ++i)
+		offsets[i + 1] = offsets[i] + live[i];
+
+	std::vector<u32> fill(offsets.begin(), offsets.end() - 1);
+
+	for (u32 i = 0; i < triangles * 3; ++i)
+		adjacency[fill[ind[i]]++] = i / 3;
+
+	//Tipsify; fan around a vertex that's in the cache and pick the next one by how long it will stay in the cache
+
+	std::vector<u32> timestamps(vertices), deadEnd, candidates;
+	std::vector<bool> emitted(triangles);
+	std::vector<u32> result(triangles * 3);
+
+	deadEnd.reserve(triangles * 3);
+	candidates.reserve(64);
+
+	u32 time = cache + 1, cursor = 0, out = 0;
+	u32 fanning = 0;
+
+	while (fanning != u32_MAX) {
+
+		candidates.clear();
+
+		for (u32 i = offsets[fanning]; i < offsets[fanning + 1]; ++i) {
+
+			u32 tri = adjacency[i];
+
+			if (emitted[tri])
+				continue;
+
+			for (u32 j = 0; j < 3; ++j) {
+
+				u32 v = ind[tri * 3 + j];
+				result[out++] = v;
+
+				deadEnd.push_back(v);
+				candidates.push_back(v);
+				--live[v];
+
+				if (time - timestamps[v] > cache)
+					timestamps[v] = time++;
+			}
+
+			emitted[tri] = true;
+		}
+
+		//Pick the candidate that will still be in the cache after its remaining triangles are emitted and that entered the cache first
+
+		u32 next = u32_MAX;
+		i32 best = -1;
+
+		for (u32 v : candidates)
+			if (live[v] != 0) {
+
+				i32 priority = 0;
+
+				if (time - timestamps[v] + 2 * live[v] <= cache)
+					priority = i32(time - timestamps[v]);
+
+				if (priority > best) {
+					best = priority;
+					next = v;
+				}
+			}
+
+		//Dead end; use the most recently emitted vertex that still has triangles, otherwise the next vertex in input order
+
+		while (next == u32_MAX && deadEnd.size() != 0) {
+
+			u32 v = deadEnd[deadEnd.size() - 1];
+			deadEnd.pop_back();
+
+			if (live[v] != 0)
+				next = v;
+		}
+
+		while (next == u32_MAX && cursor < vertices) {
+
+			if (live[cursor] != 0)
+				next = cursor;
+
+			++cursor;
+		}
+
+		fanning = next;
+	}
+
+	memcpy(ind, result.data(), ibo.size());
+}
+
+u32 MeshOptimizer::optimizeVertexFetch(Buffer vbo, u32 stride, Buffer ibo) {
+
+	if (stride == 0 || vbo.size() % stride != 0) {
+		Log::error("MeshOptimizer::optimizeVertexFetch failed; the vbo isn't a multiple of the stride");
+		return 0;
+	}
+
+	u32 vertices = vbo.size() / stride;
+
+	if (!isValidMesh(ibo, vertices, "MeshOptimizer::optimizeVertexFetch"))
+		return vertices;
+
+	std::vector<u32> remap(vertices, u32_MAX);
+	std::vector<u8> copy(vbo.size());
+
+	u32 *ind = (u32*) ibo.addr();
+	u32 used = 0;
+
+	for (u32 i = 0, j = ibo.size() / 4; i < j; ++i) {
+
+		u32 &v = remap[ind[i]];
+
+		if (v == u32_MAX) {
+			v = used++;
+			memcpy(copy.data() + (size_t) v * stride, vbo.addr() + (size_t) ind[i] * stride, stride);
+		}
+
+		ind[i] = v;
+	}
+
+	memcpy(vbo.addr(), copy.data(), (size_t) used * stride);
+	return used;
+}
+
+MeshCacheStats MeshOptimizer::analyzeVertexCache(Buffer ibo, u32 vertices, u32 cache) {
+
+	if (vertices == 0 || ibo.size() == 0 || !isValidMesh(ibo, vertices, "MeshOptimizer::analyzeVertexCache"))
+		return {};
+
+	//A vertex is in the FIFO cache if it missed less than 'cache' misses ago
+
+	std::vector<u32> missedAt(vertices, u32_MAX);
+
+	const u32 *ind = (const u32*) ibo.addr();
+	u32 misses = 0;
+
+	for (u32 i = 0, j = ibo.size() / 4; i < j; ++i) {
+
+		u32 &v = missedAt[ind[i]];
+
+		if (v == u32_MAX || misses - v >= cache)
+			v = misses++;
+	}
+
+	MeshCacheStats stats;
+	stats.acmr = f32(misses) / (ibo.size() / 12);
+	stats.atvr = f32(misses) / vertices;
+	return stats;
+}
+
+//Bounding sphere and normal cone of a meshlet that has been filled in
+static void computeMeshletBounds(RMFile &file, RMMeshlet &meshlet, const u8 *dat, u32 stride) {
+
+	auto position = [&](u32 local) -> Vec3 {
+		Vec3 pos;
+		memcpy(pos.arr, dat + (size_t) file.meshletVertices[meshlet.vertexOffset + local] * stride, sizeof(pos));
+		return pos;
+	};
+
+	//Sphere around the center of the AABB
+
+	Vec3 mi = position(0), ma = mi;
+
+	for (u32 i = 1; i < meshlet.vertices; ++i) {
+		Vec3 pos = position(i);
+		mi = mi.min(pos);
+		ma = ma.max(pos);
+	}
+
+	meshlet.center = (mi + ma) / 2.f;
+	meshlet.radius = 0;
+
+	for (u32 i = 0; i < meshlet.vertices; ++i)
+		meshlet.radius = std::max(meshlet.radius, (position(i) - meshlet.center).magnitude());
+
+	//Cone around the average triangle normal (CCW)
+
+	std::vector<Vec3> normals;
+	normals.reserve(meshlet.triangles);
+
+	const u8 *tris = file.meshletTriangles.data() + (size_t) meshlet.triangleOffset * 3;
+	Vec3 axis;
+
+	for (u32 i = 0; i < meshlet.triangles; ++i) {
+
+		Vec3 a = position(tris[i * 3]), b = position(tris[i * 3 + 1]), c = position(tris[i * 3 + 2]);
+		Vec3 nrm = (b - a).cross(c - a);
+		f32 len = nrm.magnitude();
+
+		if (len == 0)
+			continue;
+
+		normals.push_back(nrm / len);
+		axis += normals[normals.size() - 1];
+	}
+
+	meshlet.coneAxis = Vec3();
+	meshlet.coneCutoff = 1;
+
+	f32 len = axis.magnitude();
+
+	if (normals.size() == 0 || len == 0)
+		return;
+
+	meshlet.coneAxis = axis / len;
+
+	f32 minDot = 1;
+
+	for (Vec3 &nrm : normals)
+		minDot = std::min(minDot, nrm.dot(meshlet.coneAxis));
+
+	//If the normals are spread over more than a hemisphere, there's always a triangle facing the camera
+
+	if (minDot > 0)
+		meshlet.coneCutoff = std::sqrt(1 - minDot * minDot);
+}
+
+bool MeshOptimizer::buildMeshlets(Buffer vbo, u32 stride, Buffer ibo, RMFile &file, u32 maxVertices, u32 maxTriangles) {
+
+	if (stride < 12 || vbo.size() % stride != 0)
+		return Log::error("MeshOptimizer::buildMeshlets failed; the vbo isn't a multiple of the stride or doesn't have a position");
+
+	if (maxVertices < 3 || maxVertices > 255 || maxTriangles == 0 || maxTriangles > 255)
+		return Log::error("MeshOptimizer::buildMeshlets failed; the meshlet limits have to be in range [3, 255] and [1, 255]");
+
+	u32 vertices = vbo.size() / stride;
+
+	if (!isValidMesh(ibo, vertices, "MeshOptimizer::buildMeshlets"))
+		return false;
+
+	const u32 *ind = (const u32*) ibo.addr();
+	u32 triangles = ibo.size() / 12;
+
+	file.meshlets.clear();
+	file.meshletVertices.clear();
+	file.meshletTriangles.clear();
+
+	file.meshletVertices.reserve(vertices + vertices / 4);
+	file.meshletTriangles.reserve(triangles * 3);
+
+	//Index of the vertex in the current meshlet (u32_MAX if it isn't in there)
+
+	std::vector<u32> local(vertices, u32_MAX);
+	RMMeshlet meshlet = {};
+
+	auto flush = [&]() {
+
+		computeMeshletBounds(file, meshlet, vbo.addr(), stride);
+		file.meshlets.push_back(meshlet);
+
+		for (u32 i = 0; i < meshlet.vertices; ++i)
+			local[file.meshletVertices[meshlet.vertexOffset + i]] = u32_MAX;
+
+		meshlet = {};
+		meshlet.vertexOffset = (u32) file.meshletVertices.size();
+		meshlet.triangleOffset = (u32) file.meshletTriangles.size() / 3;
+	};
+
+	for (u32 i = 0; i < triangles; ++i) {
+
+		u32 a = ind[i * 3], b = ind[i * 3 + 1], c = ind[i * 3 + 2];
+
+		u32 added = u32(local[a] == u32_MAX) + u32(b != a && local[b] == u32_MAX) + u32(c != a && c != b && local[c] == u32_MAX);
+
+		if (meshlet.vertices + added > maxVertices || meshlet.triangles == maxTriangles)
+			flush();
+
+		for (u32 v : { a, b, c }) {
+
+			if (local[v] == u32_MAX) {
+				local[v] = meshlet.vertices++;
+				file.meshletVertices.push_back(v);
+			}
+
+			file.meshletTriangles.push_back((u8) local[v]);
+		}
+
+		++meshlet.triangles;
+	}
+
+	if (meshlet.triangles != 0)
+		flush();
+
+	file.meshletHeader = { (u32) file.meshlets.size(), (u32) file.meshletVertices.size(), (u32) file.meshletTriangles.size() / 3, (u8) maxVertices, (u8) maxTriangles, 0 };
+	return true;
+}
+
+//Sum of area weighted squared distances to planes; xx, xy, xz, yy, yz, zz, x, y, z, w (symmetric 4x4)
+struct Quadric {
+
+	f64 m[10] = {}, weight = 0;
+
+	Quadric() {}
+
+	Quadric(Vec3 p0, Vec3 p1, Vec3 p2) {
+
+		Vec3 nrm = (p1 - p0).cross(p2 - p0);
+		f64 area = nrm.magnitude();
+
+		if (area == 0)
+			return;
+
+		f64 x = nrm.x / area, y = nrm.y / area, z = nrm.z / area;
+		f64 w = -(x * p0.x + y * p0.y + z * p0.z);
+		f64 plane[] = { x, y, z, w };
+
+		for (u32 i = 0, k = 0; i < 4; ++i)
+			for (u32 j = i; j < 4; ++j, ++k)
+				m[k] = plane[i] * plane[j] * area;
+
+		weight = area;
+	}
+
+	Quadric &operator+=(const Quadric &other) {
+
+		for (u32 i = 0; i < 10; ++i)
+			m[i] += other.m[i];
+
+		weight += other.weight;
+		return *this;
+	}
+
+	//Mean squared distance of p to the planes
+	f64 error(Vec3 p) const {
+
+		if (weight == 0)
+			return 0;
+
+		f64 x = p.x, y = p.y, z = p.z;
+		f64 e = m[0] * x * x + m[4] * y * y + m[7] * z * z + m[9] + 2 * (m[1] * x * y + m[2] * x * z + m[5] * y * z + m[3] * x + m[6] * y + m[8] * z);
+		return std::max(e, 0.0) / weight;
+	}
+
+};
+
+bool MeshOptimizer::buildLods(Buffer vbo, u32 stride, Buffer ibo, RMFile &file, const std::vector<f32> &errors, String name) {
+
+	if (stride < 12 || vbo.size() % stride != 0)
+		return Log::error("MeshOptimizer::buildLods failed; the vbo isn't a multiple of the stride or doesn't have a position");
+
+	u32 vertices = vbo.size() / stride;
+
+	if (!isValidMesh(ibo, vertices, "MeshOptimizer::buildLods"))
+		return false;
+
+	file.lods.clear();
+	file.lodIndices.clear();
+	file.lodHeader = {};
+
+	if (errors.size() == 0 || vertices == 0 || ibo.size() == 0)
+		return true;
+
+	Timer t;
+
+	//Positions relative to the size of the mesh, so errors don't depend on the unit
+
+	std::vector<Vec3> pos(vertices);
+
+	for (u32 i = 0; i < vertices; ++i)
+		memcpy(pos[i].arr, vbo.addr() + (size_t) i * stride, sizeof(Vec3));
+
+	Vec3 mi = pos[0], ma = mi;
+
+	for (Vec3 &p : pos) {
+		mi = mi.min(p);
+		ma = ma.max(p);
+	}
+
+	Vec3 dif = ma - mi;
+	f32 extent = std::max(dif.x, std::max(dif.y, dif.z));
+
+	if (extent == 0)
+		return true;
+
+	for (Vec3 &p : pos)
+		p = (p - mi) / extent;
+
+	//Vertices with the same position share a quadric (wedge); wedges with multiple vertices are seams and can't be moved
+
+	std::vector<u32> wedge(vertices), wedgeCount(vertices);
+	std::unordered_map<u64, u32> firstAt;
+	firstAt.reserve(vertices);
+
+	for (u32 i = 0; i < vertices; ++i) {
+
+		u64 h = Hash::xx64((const u8*) pos[i].arr, sizeof(Vec3));
+		auto it = firstAt.find(h);
+
+		//Hash collisions of different positions just don't share a wedge
+
+		if (it == firstAt.end())
+			it = firstAt.insert({ h, i }).first;
+		else if (memcmp(pos[it->second].arr, pos[i].arr, sizeof(Vec3)) != 0)
+			it->second = i;
+
+		wedge[i] = it->second;
+		++wedgeCount[wedge[i]];
+	}
+
+	std::vector<bool> locked(vertices);
+
+	for (u32 i = 0; i < vertices; ++i)
+		locked[i] = wedgeCount[wedge[i]] != 1;
+
+	//Edges that aren't shared by exactly two triangles are borders (or non manifold)
+
+	std::vector<u32> ind((const u32*) ibo.addr(), (const u32*) (ibo.addr() + ibo.size()));
+	std::unordered_map<u64, u32> edges;
+	edges.reserve(ind.size());
+
+	for (u32 i = 0; i < (u32) ind.size(); ++i) {
+		u32 a = wedge[ind[i]], b = wedge[ind[i - i % 3 + (i + 1) % 3]];
+		++edges[(u64(std::min(a, b)) << 32) | std::max(a, b)];
+	}
+
+	for (u32 i = 0; i < (u32) ind.size(); ++i) {
+
+		u32 a = wedge[ind[i]], b = wedge[ind[i - i % 3 + (i + 1) % 3]];
+
+		if (edges[(u64(std::min(a, b)) << 32) | std::max(a, b)] != 2)
+			locked[ind[i]] = locked[ind[i - i % 3 + (i + 1) % 3]] = true;
+	}
+
+	std::vector<Quadric> quadrics(vertices);
+
+	for (u32 i = 0; i < (u32) ind.size(); i += 3) {
+
+		Quadric q(pos[ind[i]], pos[ind[i + 1]], pos[ind[i + 2]]);
+
+		for (u32 j = 0; j < 3; ++j)
+			quadrics[wedge[ind[i + j]]] += q;
+	}
+
+	//Collapse the cheapest edges in passes; a vertex can only be touched once per pass
+
+	struct Collapse {
+		u32 from, to;
+		f64 cost;
+	};
+
+	std::vector<Collapse> collapses;
+	std::vector<u32> remap(vertices), offsets(vertices + 1), adjacency, fill;
+	std::vector<bool> touched(vertices);
+
+	u32 prevTriangles = (u32) ind.size() / 3;
+	f64 maxCost = 0;
+
+	for (f32 target : errors) {
+
+		f64 limit = f64(target) * target;
+
+		for (bool changed = true; changed;) {
+
+			changed = false;
+
+			u32 triangles = (u32) ind.size() / 3;
+
+			std::fill(offsets.begin(), offsets.end(), 0);
+
+			for (u32 v : ind)
+				++offsets[v + 1];
+
+			for (u32 i = 0; i < vertices; ++i)
+				offsets[i + 1] += offsets[i];
+
+			fill.assign(offsets.begin(), offsets.end() - 1);
+			adjacency.resize(ind.size());
+
+			for (u32 i = 0; i < (u32) ind.size(); ++i)
+				adjacency[fill[ind[i]]++] = i / 3;
+
+			collapses.clear();
+
+			for (u32 i = 0; i < (u32) ind.size(); ++i) {
+
+				u32 a = ind[i], b = ind[i - i % 3 + (i + 1) % 3];
+
+				for (u32 j = 0; j < 2; ++j, std::swap(a, b))
+					if (!locked[a]) {
+
+						Quadric q = quadrics[a];
+						q += quadrics[wedge[b]];
+
+						f64 cost = q.error(pos[b]);
+
+						if (cost <= limit)
+							collapses.push_back({ a, b, cost });
+					}
+			}
+
+			std::sort(collapses.begin(), collapses.end(), [](const Collapse &a, const Collapse &b) -> bool { return a.cost < b.cost; });
+
+			for (u32 i = 0; i < vertices; ++i)
+				remap[i] = i;
+
+			std::fill(touched.begin(), touched.end(), false);
+
+			for (Collapse &c : collapses) {
+
+				if (touched[c.from] || touched[c.to])
+					continue;
+
+				//The triangles around the vertex can't flip (or get too thin)
+
+				bool flips = false;
+
+				for (u32 i = offsets[c.from]; i < offsets[c.from + 1] && !flips; ++i) {
+
+					u32 tri = adjacency[i] * 3;
+					u32 v[] = { remap[ind[tri]], remap[ind[tri + 1]], remap[ind[tri + 2]] };
+
+					if (v[0] == c.to || v[1] == c.to || v[2] == c.to)
+						continue;
+
+					Vec3 n0 = (pos[v[1]] - pos[v[0]]).cross(pos[v[2]] - pos[v[0]]);
+
+					for (u32 &k : v)
+						if (k == c.from)
+							k = c.to;
+
+					Vec3 n1 = (pos[v[1]] - pos[v[0]]).cross(pos[v[2]] - pos[v[0]]);
+
+					flips = n0.dot(n1) <= .25f * n0.magnitude() * n1.magnitude();
+				}
+
+				if (flips)
+					continue;
+
+				remap[c.from] = c.to;
+				touched[c.from] = touched[c.to] = true;
+				quadrics[wedge[c.to]] += quadrics[c.from];
+				maxCost = std::max(maxCost, c.cost);
+				changed = true;
+			}
+
+			if (!changed)
+				break;
+
+			//Remove the triangles that collapsed
+
+			u32 j = 0;
+
+			for (u32 i = 0; i < triangles * 3; i += 3) {
+
+				u32 a = remap[ind[i]], b = remap[ind[i + 1]], c = remap[ind[i + 2]];
+
+				if (a == b || b == c || c == a)
+					continue;
+
+				ind[j] = a;
+				ind[j + 1] = b;
+				ind[j + 2] = c;
+				j += 3;
+			}
+
+			ind.resize(j);
+		}
+
+		u32 triangles = (u32) ind.size() / 3;
+
+		if (triangles == 0 || triangles > prevTriangles * 9 / 10)
+			continue;
+
+		RMLod lod = { (u32) file.lodIndices.size(), triangles * 3, f32(std::sqrt(maxCost)) * extent };
+		file.lodIndices.insert(file.lodIndices.end(), ind.begin(), ind.end());
+		file.lods.push_back(lod);
+
+		optimizeVertexCache(Buffer::construct((u8*) (file.lodIndices.data() + lod.indexOffset), lod.indices * 4), vertices);
+
+		prevTriangles = triangles;
+	}
+
+	file.lodHeader = { (u32) file.lods.size(), (u32) file.lodIndices.size() };
+
+	String report = String("Generated ") + u32(file.lods.size()) + " LODs for " + (name == "" ? String("mesh") : name) + "; " + u32(ibo.size() / 12);
+
+	for (RMLod &lod : file.lods)
+		report += String(" -> ") + (lod.indices / 3);
+
+	Log::println(report + " triangles in " + t.getDuration() + "s");
+	return true;
+}
+
+u32 MeshOptimizer::optimize(Buffer vbo, u32 stride, Buffer ibo, String name) {
+
+	if (stride == 0)
+		return 0;
+
+	u32 original = vbo.size() / stride;
+	bool report = isReporting();
+
+	MeshCacheStats before;
+
+	if (report)
+		before = analyzeVertexCache(ibo, original);
+
+	u32 vertices = weldVertices(vbo, stride, ibo);
+	optimizeVertexCache(ibo, vertices);
+	vertices = optimizeVertexFetch(Buffer::construct(vbo.addr(), vertices * stride), stride, ibo);
+
+	if (report) {
+
+		MeshCacheStats after = analyzeVertexCache(ibo, vertices);
+
+		Log::println(String("Optimized mesh ") + name + ": " + original + " -> " + vertices + " vertices, ACMR " + before.acmr + " -> " + after.acmr + ", ATVR " + before.atvr + " -> " + after.atvr);
+	}
+
+	return vertices;
+}
+
+void MeshOptimizer::setReporting(bool enabled) { meshReporting = enabled; }
+void MeshOptimizer::setLodErrors(const std::vector<f32> &errors) { lodErrors = errors; }
+const std::vector<f32> &MeshOptimizer::getLodErrors() { return lodErrors; }
+bool MeshOptimizer::isReporting() { return meshReporting; }
\ No newline at end of file
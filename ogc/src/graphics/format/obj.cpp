@@ -2,161 +2,237 @@
 #include "file/filemanager.h"
 #include "graphics/graphics.h"
 #include "graphics/format/obj.h"
+#include "graphics/format/meshoptimizer.h"
+#include "types/indexmap.h"
 
 using namespace oi::gc;
 using namespace oi::wc;
 using namespace oi;
 
+//Obj is parsed straight from the file's bytes; these helpers never allocate
+
+static inline bool isObjSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+static inline const char *skipObjSpaces(const char *c, const char *end) {
+	while (c < end && isObjSpace(*c)) ++c;
+	return c;
+}
+
+static inline const char *skipObjLine(const char *c, const char *end) {
+	while (c < end && *c != '\n') ++c;
+	return c;
+}
+
+//Parses a float the same way String::toFloat does (StringView::toFloat; from_chars), 0 if it isn't a number
+static const char *parseObjFloat(const char *c, const char *end, f32 &f) {
+
+	c = skipObjSpaces(c, end);
+
+	const char *start = c;
+
+	while (c < end && !isObjSpace(*c) && *c != '\n')
+		++c;
+
+	f = StringView(start, u32(c - start)).toFloat();
+	return c;
+}
+
+template<u32 n>
+static const char *parseObjVector(const char *c, const char *end, f32 *v) {
+
+	for (u32 i = 0; i < n; ++i)
+		c = parseObjFloat(c, end, v[i]);
+
+	return c;
+}
+
+//Parses an obj index (1-based or negative; relative to the end) into a 0-based index, missing indices are 0
+static const char *parseObjIndex(const char *c, const char *end, u32 count, u32 &index, bool &valid) {
+
+	index = 0;
+
+	bool negative = c < end && *c == '-';
+
+	if (negative)
+		++c;
+
+	if (c == end || *c < '0' || *c > '9')
+		return c;
+
+	u64 i = 0;
+
+	for (; c < end && *c >= '0' && *c <= '9'; ++c)
+		i = i * 10 + u64(*c - '0');
+
+	if (negative ? i > count : (i == 0 || i > count))
+		valid = false;
+	else
+		index = negative ? u32(count - i) : u32(i - 1);
+
+	return c;
+}
+
+//A vertex with all attributes padded with zero; so vertices can be compared by their bytes (just like the oiRM data)
+struct ObjVertex {
+
+	f32 data[8];
+
+	bool operator==(const ObjVertex &other) const { return memcmp(data, other.data, sizeof(data)) == 0; }
+
+};
+
 Buffer Obj::convert(Buffer objBuffer, bool compression) {
 
 	Timer t;
 
-	//Convert obj to oiRM
-	String str((char*) objBuffer.addr(), objBuffer.size());
+	const char *c = (const char*) objBuffer.addr(), *end = c + objBuffer.size();
 
-	//Find all locations of objects
-	std::vector<Vec2u> objects = str.find("\no ", "\no ", 1);
+	//Approx 30 bytes per line and 1/4 of the lines for every attribute, so reserve that to minimize resizing as much as possible
+	u32 estimate = objBuffer.size() / 30 / 4;
 
-	if(objects.size() == 0){
-		Log::error("Couldn't convert Obj; missing an object");
-		return {};
-	}
+	std::vector<Vec3> positions, normals;
+	std::vector<Vec2> uvs;
 
-	bool hasPos = false, hasUv = false, hasNrm = false;
-	u32 vertexCount = 0;
+	positions.reserve(estimate);
+	normals.reserve(estimate);
+	uvs.reserve(estimate);
 
-	std::vector<f32> vertices;
-	std::vector<u32> indices;
-	std::vector<f32> perVert;
+	//Unique vertices in the order they're first used; looked up by (pos, uv, nrm) index first and by value if that index combination is new
+	//This matches welding by comparing the vertex data against every vertex that was already emitted
+	IndexMap<Vec3u> corners(estimate);
+	std::vector<u32> cornerVertex;
+	IndexMap<ObjVertex> vertices(estimate);
 
-	f32 *aperVert = nullptr, *avertices = nullptr;
+	cornerVertex.reserve(estimate);
 
-	u32 avertexSiz = 0;
+	std::vector<u32> indices;
+	indices.reserve(estimate * 3);
 
 	std::vector<u32> polind;
 	polind.reserve(32);
 
-	u32 stride = 0;
+	bool hasPos = false, hasUv = false, hasNrm = false, hasLayout = false;
+	u32 stride = 0, line = 0;
 
-	for (u32 i = 0; i < (u32)objects.size(); ++i) {
+	for (; c < end; ++line) {
 
-		Vec2u object = objects[i];
-		String s = str.substring(object.x, object.y);
+		c = skipObjSpaces(c, end);
 
-		std::vector<Vec2u> lines = s.find("\n", "\n", 1);
+		const char *id = c;
 
-		std::vector<Vec3> positions, normals;
-		std::vector<Vec2> uvs;
+		while (c < end && !isObjSpace(*c) && *c != '\n')
+			++c;
 
-		u32 lineCount = (u32) lines.size();
+		u32 idLen = u32(c - id);
 
-		//Approx 1/4 goes to every attribute, so reserve that to minimize resizing as much as possible
-		positions.reserve(lineCount / 4);
-		normals.reserve(lineCount / 4);
-		uvs.reserve(lineCount / 4);
-		vertices.reserve(vertices.size() + lineCount / 4 * 5);
-		indices.reserve(indices.size() + lineCount / 4 * 5);
-
-		for (u32 j = 0; j < lineCount; ++j) {
+		if (idLen == 1 && *id == 'v') {
+			positions.push_back({});
+			c = parseObjVector<3>(c, end, positions[positions.size() - 1].arr);
+			hasPos |= !hasLayout;
+		}
+		else if (idLen == 2 && id[0] == 'v' && id[1] == 't') {
+			uvs.push_back({});
+			c = parseObjVector<2>(c, end, uvs[uvs.size() - 1].arr);
+			hasUv |= !hasLayout;
+		}
+		else if (idLen == 2 && id[0] == 'v' && id[1] == 'n') {
+			normals.push_back({});
+			c = parseObjVector<3>(c, end, normals[normals.size() - 1].arr);
+			hasNrm |= !hasLayout;
+		}
+		else if (idLen == 1 && *id == 'f') {
 
-			String line = s.substring(lines[j].x, lines[j].y);
+			//The vertex layout is decided by the attributes that are declared before the first face; attributes after that are only used for indexing
+			if (!hasLayout) {
+				stride = (hasPos ? 3 : 0) + (hasUv ? 2 : 0) + (hasNrm ? 3 : 0);
+				hasLayout = true;
+			}
 
-			if (!line.contains(' '))
-				continue;
+			polind.clear();
 
-			u32 modifier = line.find(' ')[0];
-			String identifier = line.cutEnd(modifier);
+			while ((c = skipObjSpaces(c, end)) < end && *c != '\n') {
 
-			if (identifier == "v") {
-				positions.push_back(line.cutBegin(modifier + 1).toVector<f32, 3>());
-				hasPos = true;
-			} else if (identifier == "vt"){
-				uvs.push_back(line.cutBegin(modifier + 1).toVector<f32, 2>()); 
-				hasUv = true;
-			} else if (identifier == "vn"){
-				normals.push_back(line.cutBegin(modifier + 1).toVector<f32, 3>());
-				hasNrm = true;
-			} else if (identifier == "f") {
+				Vec3u vert;
+				bool valid = true;
 
-				std::vector<String> parts = line.split(' ');
-				stride = (hasPos ? 3 : 0) + (hasUv ? 2 : 0) + (hasNrm ? 3 : 0);
+				c = parseObjIndex(c, end, (u32) positions.size(), vert.x, valid);
 
-				if ((u32)perVert.size() == 0) {
-					perVert.resize(stride);
-					aperVert = perVert.data();
-				}
+				if (c < end && *c == '/')
+					c = parseObjIndex(c + 1, end, (u32) uvs.size(), vert.y, valid);
 
-				polind.resize(parts.size() - 1);
-				u32 poli = 0;
+				if (c < end && *c == '/')
+					c = parseObjIndex(c + 1, end, (u32) normals.size(), vert.z, valid);
 
-				for (u32 k = 1; k < (u32) parts.size(); ++k) {
+				if (!hasPos) vert.x = 0;
+				if (!hasUv) vert.y = 0;
+				if (!hasNrm) vert.z = 0;
 
-					std::vector<String> part = parts[k].split('/');
+				if (!valid || (hasPos && vert.x >= positions.size()) || (hasUv && vert.y >= uvs.size()) || (hasNrm && vert.z >= normals.size())) {
+					Log::error(String("Couldn't convert Obj; face on line ") + (line + 1) + " uses an attribute that doesn't exist");
+					return {};
+				}
 
-					Vec3u vert;
-					u32 m = 0;
+				//Skip anything that isn't part of the index (garbage at the end of the corner)
+				while (c < end && !isObjSpace(*c) && *c != '\n')
+					++c;
 
-					for (u32 l = 0; l < 3 && l < (u32)part.size(); ++l) {
+				bool inserted;
+				u32 corner = corners.insert(vert, inserted);
 
-						String p = part[l];
-						if (p != "")
-							vert[l] = (u32) p.toLong() - 1;
+				if (inserted) {
 
-					}
+					ObjVertex v = {};
+					u32 m = 0;
 
 					if (hasPos) {
-						*(Vec3*)(aperVert + m) = positions[vert.x];
+						*(Vec3*)(v.data + m) = positions[vert.x];
 						m += 3;
 					}
 
 					if (hasUv) {
-						*(Vec2*)(aperVert + m) = uvs[vert.y];
+						*(Vec2*)(v.data + m) = uvs[vert.y];
 						m += 2;
 					}
 
 					if (hasNrm)
-						*(Vec3*)(aperVert + m) = normals[vert.z];
+						*(Vec3*)(v.data + m) = normals[vert.z];
 
-					u32 next = (u32) avertexSiz / stride;
-					u32 index = next;
-
-					//TODO: memcmp
+					cornerVertex.push_back(vertices.insert(v));
+				}
 
-					for (u32 n = 0; n < (u32) avertexSiz / stride; ++n)
-						if (memcmp(avertices + n * stride, aperVert, stride * 4) == 0) {
-							index = n;
-							break;
-						}
+				polind.push_back(cornerVertex[corner]);
+			}
 
-					if (index == next) {
-						vertices.insert(vertices.end(), perVert.begin(), perVert.end());
-						avertices = vertices.data();
-						avertexSiz = (u32) vertices.size();
-						++vertexCount;
-					}
+			for (u32 x = 1; x + 1 < (u32) polind.size(); ++x) {
+				indices.push_back(polind[0]);
+				indices.push_back(polind[x]);
+				indices.push_back(polind[x + 1]);
+			}
 
-					polind[poli] = index;
-					++poli;
-				}
+		}
 
-				u32 indlen = (poli - 2) * 3;
-				u32 *ind = new u32[indlen];
+		if ((c = skipObjLine(c, end)) < end)
+			++c;
+	}
 
-				for (u32 x = 1; x < poli - 1; ++x)
-					*(Vec3u*)(ind + (x - 1) * 3) = Vec3u(polind[0], polind[x], polind[x + 1]);
+	if (!hasLayout || indices.size() == 0) {
+		Log::error("Couldn't convert Obj; missing faces");
+		return {};
+	}
 
-				indices.insert(indices.end(), ind, ind + indlen);
-				delete[] ind;
+	u32 vertexCount = vertices.size();
+	std::vector<f32> vbo((size_t) vertexCount * stride);
 
-			}
-		}
+	for (u32 i = 0; i < vertexCount; ++i)
+		memcpy(vbo.data() + (size_t) i * stride, vertices[i].data, stride * 4);
 
-	}
+	//Reorder for the vertex cache (vertices are already welded while parsing, so welding won't find anything new)
+	vertexCount = MeshOptimizer::optimize(Buffer::construct((u8*) vbo.data(), vertexCount * stride * 4), stride * 4, Buffer::construct((u8*) indices.data(), (u32) indices.size() * 4), "obj");
 
 	t.stop();
 	t.print();
 
-	RMFile file = oiRM::generate(Buffer::construct((u8*) avertices, vertexCount * stride * 4), Buffer::construct((u8*) indices.data(), (u32) indices.size() * 4), hasPos, hasUv, hasNrm, vertexCount, (u32) indices.size());
+	RMFile file = oiRM::generate(Buffer::construct((u8*) vbo.data(), vertexCount * stride * 4), Buffer::construct((u8*) indices.data(), (u32) indices.size() * 4), hasPos, hasUv, hasNrm, vertexCount, (u32) indices.size(), "obj");
 	return oiRM::write(file, compression);
 }
 
@@ -179,24 +255,28 @@ bool Obj::convert(Buffer objBuffer, String outPath, bool compression) {
 Buffer Obj::convert(String objPath, bool compression) {
 
 	Buffer buf;
-	FileManager::get()->read(objPath, buf);
 
-	if (buf.size() == 0)
+	if (!FileManager::get()->map(objPath, buf) || buf.size() == 0) {
+		FileManager::get()->unmap(buf);
 		return Log::error("Couldn't read from file");
+	}
 
-	return convert(buf, compression);
+	Buffer converted = convert(buf, compression);
+	FileManager::get()->unmap(buf);
+	return converted;
 
 }
 
 bool Obj::convert(String objPath, String outPath, bool compression) {
 	
 	Buffer buf;
-	FileManager::get()->read(objPath, buf);
 
-	if (buf.size() == 0) 
+	if (!FileManager::get()->map(objPath, buf) || buf.size() == 0) {
+		FileManager::get()->unmap(buf);
 		return Log::error("Couldn't read from file");
+	}
 
 	bool converted = convert(buf, outPath, compression);
-	buf.deconstruct();
+	FileManager::get()->unmap(buf);
 	return converted;
 }
\ No newline at end of file
@@ -1,13 +1,20 @@
 #include "file/filemanager.h"
 #include "types/bitset.h"
+#include "types/indexmap.h"
 #include "utils/timer.h"
 #include "graphics/format/oirm.h"
+#include "graphics/format/meshoptimizer.h"
 #include "graphics/objects/model/mesh.h"
 using namespace oi::gc;
 using namespace oi::wc;
 using namespace oi;
 
-RMFile oiRM::generate(Buffer vbo, Buffer bibo, bool hasPos, bool hasUv, bool hasNrm, u32 vertices, u32 indices) {
+static CompressionCodec blockCompression = CompressionCodec::LZ4;
+
+void oiRM::setBlockCompression(CompressionCodec codec) { blockCompression = codec; }
+CompressionCodec oiRM::getBlockCompression() { return blockCompression; }
+
+RMFile oiRM::generate(Buffer vbo, Buffer bibo, bool hasPos, bool hasUv, bool hasNrm, u32 vertices, u32 indices, String name) {
 
 	u32 stride = (hasPos ? 12 : 0) + (hasUv ? 8 : 0) + (hasNrm ? 12 : 0);
 
@@ -51,7 +58,7 @@ RMFile oiRM::generate(Buffer vbo, Buffer bibo, bool hasPos, bool hasUv, bool has
 		(u16)attributeCount
 	);
 
-	return RMFile(
+	RMFile file(
 
 		//Header
 		{
@@ -81,25 +88,45 @@ RMFile oiRM::generate(Buffer vbo, Buffer bibo, bool hasPos, bool hasUv, bool has
 		{},
 		SLFile(String::getDefaultCharset(), names)
 	);
+
+	if (hasPos && indices != 0 && MeshOptimizer::buildMeshlets(vbo, stride, bibo, file))
+		file.header.version = RMHeaderVersion::V0_0_2;
+
+	if (hasPos && indices != 0 && MeshOptimizer::buildLods(vbo, stride, bibo, file, MeshOptimizer::getLodErrors(), name) && file.lods.size() != 0)
+		file.header.version = RMHeaderVersion::V0_0_3;
+
+	return file;
 }
 
 bool oiRM::read(String path, RMFile &file) {
 
 	Buffer buf;
-	FileManager::get()->read(path, buf);
+	FileManager::get()->map(path, buf);
 
 	if (buf.size() == 0)
 		return Log::error("Couldn't open file");
 
-	if (!read(buf, file))
+	if (!read(buf, file)) {
+		FileManager::get()->unmap(buf);
 		return Log::error("Couldn't read file");
+	}
 
-	buf.deconstruct();
+	FileManager::get()->unmap(buf);
 	return true;
 }
 
 bool oiRM::read(Buffer data, RMFile &file) {
 
+	if (BlockCompression::isCompressed(data)) {
+
+		CopyBuffer uncompressed(BlockCompression::getSize(data));
+
+		if (!BlockCompression::uncompress(data, uncompressed))
+			return Log::error("Couldn't read oiRM file; couldn't uncompress blocks");
+
+		return read(uncompressed, file);
+	}
+
 	Timer t;
 
 	const char magicNumber[] = { 'o', 'i', 'R', 'M' };
@@ -114,6 +141,8 @@ bool oiRM::read(Buffer data, RMFile &file) {
 	switch (v.getValue()) {
 
 	case RMHeaderVersion::V0_0_1.value:
+	case RMHeaderVersion::V0_0_2.value:
+	case RMHeaderVersion::V0_0_3.value:
 		goto V0_0_1;
 
 	default:
@@ -288,13 +317,20 @@ V0_0_1:
 					u32 *aindices = file.indices.addr<u32>();
 					u32 *aindOps = indOps.data();
 
-					u32 i = 0, j = 0;
+					//i = index, j = operation data, k = operation
+					u32 i = 0, j = 0, k = 0;
 					while (i < file.header.indices) {
 
-						bool b0 = ops[j * 2];
-						bool b1 = ops[j * 2 + 1];
+						if (k >= file.header.indexOperations || j >= opLen)
+							return Log::error("Couldn't read oiRM file; invalid index operations");
+
+						bool b0 = ops[k * 2];
+						bool b1 = ops[k * 2 + 1];
 						u32 n = aindOps[j];
 
+						if (i + (!b0 && b1 ? 6 : 3) > file.header.indices)
+							return Log::error("Couldn't read oiRM file; invalid index operations");
+
 						if (!b0 && b1) {				//Quad
 							aindices[i] = n + 2;
 							aindices[i + 1] = n + 1;
@@ -312,12 +348,17 @@ V0_0_1:
 							aindices[i + 1] = n + 2;
 							aindices[i + 2] = n;
 						} else {
+
+							if (j + 3 > opLen)
+								return Log::error("Couldn't read oiRM file; invalid index operations");
+
 							memcpy(aindices + i, aindOps + j, 12);
 							j += 2;
 						}
 
 						i += 3;
 						++j;
+						++k;
 					}
 				
 				}
@@ -342,6 +383,114 @@ V0_0_1:
 			return Log::error("Couldn't read oiRM file; invalid oiSL");
 
 		read = read.offset(file.names.size);
+
+		if (v.getValue() >= RMHeaderVersion::V0_0_2.value)
+			goto V0_0_2;
+
+		goto end;
+	}
+
+V0_0_2:
+	{
+
+		RMMeshletHeader &header = file.meshletHeader;
+
+		if (!read.read(header) || (header.maxVertices == 0 && (header.meshlets != 0 || header.vertices != 0 || header.triangles != 0)))
+			return Log::error("Couldn't read oiRM file; invalid meshlet header");
+
+		u32 perIndexb = (u32) std::ceil(std::log2(file.header.vertices));
+		bool compression = isSet((RMHeaderFlag1_s) file.header.flags, RMHeaderFlag1::Uses_compression);
+
+		u64 meshletLength = (u64) header.meshlets * sizeof(RMMeshlet);
+		u64 vertexLength = compression ? ((u64) header.vertices * perIndexb + 7) / 8 : (u64) header.vertices * 4;
+		u32 perLocalb = header.maxVertices == 0 ? 0 : (u32) std::ceil(std::log2(header.maxVertices));
+		u64 triangleLength = compression ? ((u64) header.triangles * 3 * perLocalb + 7) / 8 : (u64) header.triangles * 3;
+
+		if (meshletLength + vertexLength + triangleLength > read.size())
+			return Log::error("Couldn't read oiRM file; invalid meshlet length");
+
+		read.read(file.meshlets, header.meshlets);
+
+		if (compression) {
+
+			Bitset bitset;
+			read.read(bitset, header.vertices * perIndexb);
+
+			file.meshletVertices.resize(header.vertices);
+			bitset.read(file.meshletVertices, perIndexb);
+
+			std::vector<u32> triangles(header.triangles * 3);
+			read.read(bitset, header.triangles * 3 * perLocalb);
+			bitset.read(triangles, perLocalb);
+
+			file.meshletTriangles.assign(triangles.begin(), triangles.end());
+
+		} else {
+			read.read(file.meshletVertices, header.vertices);
+			read.read(file.meshletTriangles, header.triangles * 3);
+		}
+
+		//Meshlets have to stay inside of the buffers and only reference existing vertices
+
+		for (u32 vert : file.meshletVertices)
+			if (vert >= file.header.vertices)
+				return Log::error("Couldn't read oiRM file; invalid meshlets");
+
+		for (RMMeshlet &meshlet : file.meshlets) {
+
+			if (meshlet.vertices > header.maxVertices || meshlet.triangles > header.maxTriangles || (u64) meshlet.vertexOffset + meshlet.vertices > header.vertices || (u64) meshlet.triangleOffset + meshlet.triangles > header.triangles)
+				return Log::error("Couldn't read oiRM file; invalid meshlets");
+
+			const u8 *tris = file.meshletTriangles.data() + (size_t) meshlet.triangleOffset * 3;
+
+			for (u32 i = 0; i < meshlet.triangles * 3u; ++i)
+				if (tris[i] >= meshlet.vertices)
+					return Log::error("Couldn't read oiRM file; invalid meshlets");
+		}
+
+		if (v.getValue() >= RMHeaderVersion::V0_0_3.value)
+			goto V0_0_3;
+
+		goto end;
+	}
+
+V0_0_3:
+	{
+
+		RMLodHeader &header = file.lodHeader;
+
+		if (!read.read(header))
+			return Log::error("Couldn't read oiRM file; invalid LOD header");
+
+		u32 perIndexb = (u32) std::ceil(std::log2(file.header.vertices));
+		bool compression = isSet((RMHeaderFlag1_s) file.header.flags, RMHeaderFlag1::Uses_compression);
+
+		u64 lodLength = (u64) header.lods * sizeof(RMLod);
+		u64 indexLength = compression ? ((u64) header.indices * perIndexb + 7) / 8 : (u64) header.indices * 4;
+
+		if (lodLength + indexLength > read.size())
+			return Log::error("Couldn't read oiRM file; invalid LOD length");
+
+		read.read(file.lods, header.lods);
+
+		if (compression) {
+
+			Bitset bitset;
+			read.read(bitset, header.indices * perIndexb);
+
+			file.lodIndices.resize(header.indices);
+			bitset.read(file.lodIndices, perIndexb);
+
+		} else read.read(file.lodIndices, header.indices);
+
+		for (u32 index : file.lodIndices)
+			if (index >= file.header.vertices)
+				return Log::error("Couldn't read oiRM file; invalid LODs");
+
+		for (RMLod &lod : file.lods)
+			if (lod.indices % 3 != 0 || (u64) lod.indexOffset + lod.indices > header.indices)
+				return Log::error("Couldn't read oiRM file; invalid LODs");
+
 		goto end;
 	}
 
@@ -379,11 +528,32 @@ std::pair<MeshBufferInfo, MeshInfo> oiRM::convert(RMFile file) {
 		++i;
 	}
 
-	if (file.header.indices != 0)
-		ib = Buffer(file.indices.addr(), file.header.indices * 4);
+	//LODs are stored after the full mesh's indices
 
-	result.first = MeshBufferInfo(file.header.vertices, file.header.indices, vbos, file.header.topologyMode, file.header.fillMode);
-	result.second = MeshInfo(nullptr, file.header.vertices, file.header.indices, vb, ib);
+	u32 indices = file.header.indices + (u32) file.lodIndices.size();
+
+	if (file.header.indices != 0) {
+		ib = Buffer(indices * 4);
+		memcpy(ib.addr(), file.indices.addr(), file.header.indices * 4);
+
+		if (file.lodIndices.size() != 0)
+			memcpy(ib.addr() + file.header.indices * 4, file.lodIndices.data(), file.lodIndices.size() * 4);
+	}
+
+	result.first = MeshBufferInfo(file.header.vertices, indices, vbos, file.header.topologyMode, file.header.fillMode);
+	result.second = MeshInfo(nullptr, file.header.vertices, indices, vb, ib);
+
+	if (file.lods.size() != 0 && file.header.indices != 0) {
+
+		result.second.lods.push_back({ 0, file.header.indices, 0 });
+
+		for (RMLod &lod : file.lods)
+			result.second.lods.push_back({ file.header.indices + lod.indexOffset, lod.indices, lod.error });
+	}
+
+	result.second.meshlets = file.meshlets;
+	result.second.meshletVertices = file.meshletVertices;
+	result.second.meshletTriangles = file.meshletTriangles;
 	
 	return result;
 }
@@ -425,7 +595,11 @@ RMFile oiRM::convert(const MeshInfo &info) {
 
 	std::vector<RMMisc> miscs;
 
-	return {
+	//Indices of the LODs are stored after the full mesh's (LOD 0)
+
+	u32 indices = info.lods.size() != 0 ? info.lods[0].indices : info.indices;
+
+	RMFile file = {
 
 		{
 			{ 'o', 'i', 'R', 'M' },
@@ -444,56 +618,59 @@ RMFile oiRM::convert(const MeshInfo &info) {
 
 			info.vertices,
 
-			info.indices
+			indices
 		},
 
 		vbos,
 		attributes,
 		miscs,
 		vertices,
-		info.ibo,
+		Buffer::construct(info.ibo.addr(), indices * 4),
 		{},
 		SLFile(String::getDefaultCharset(), names)
 
 	};
-}
 
-u32 findChannel(u8 *data, u32 totalSize, u8 *c, u32 bpc) {
+	file.meshlets = info.meshlets;
+	file.meshletVertices = info.meshletVertices;
+	file.meshletTriangles = info.meshletTriangles;
 
-	for (u32 i = 0; i < totalSize; i += bpc)
-		if (memcmp(data + i, c, bpc) == 0)
-			return i / bpc;
+	const u32 *ibo = (const u32*) info.ibo.addr();
 
-	return totalSize / bpc;
+	for (u32 i = 1; i < (u32) info.lods.size(); ++i) {
+		const MeshLod &lod = info.lods[i];
+		file.lods.push_back({ (u32) file.lodIndices.size(), lod.indices, lod.error });
+		file.lodIndices.insert(file.lodIndices.end(), ibo + lod.baseIndex, ibo + lod.baseIndex + lod.indices);
+	}
 
+	return file;
 }
 
-u32 findAttribute(u32 *attributes, u32 totalSize, u32 *channels, u32 channelCount) {
-
-	for (u32 i = 0; i < totalSize / channelCount; ++i)
-		if (memcmp(attributes + i * channelCount, channels, 4 * channelCount) == 0)
-			return i;
+Buffer oiRM::write(RMFile &file, bool compression) {
 
-	return totalSize / channelCount;
-}
+	Timer t;
 
-bool addChannel(CopyBuffer &buf, u32 bpc, u8 *addr, u32 *channel) {
+	RMHeader &header = file.header;
 
-	*channel = findChannel(buf.addr(), buf.size(), addr, bpc);
+	//Files made by convert(MeshInfo) don't know the limits the meshlets were built with; use the biggest meshlet instead
 
-	if (*channel == buf.size() / bpc) {
-		buf += CopyBuffer(addr, bpc);
-		return true;
-	}
+	RMMeshletHeader &mheader = file.meshletHeader;
 
-	return false;
-}
+	if (mheader.maxVertices == 0 || mheader.maxTriangles == 0)
+		for (RMMeshlet &meshlet : file.meshlets) {
 
-Buffer oiRM::write(RMFile &file, bool compression) {
+			if (meshlet.vertices > mheader.maxVertices)
+				mheader.maxVertices = meshlet.vertices;
 
-	Timer t;
+			if (meshlet.triangles > mheader.maxTriangles)
+				mheader.maxTriangles = meshlet.triangles;
+		}
 
-	RMHeader &header = file.header;
+	//ceil(log2(maxVertices)) is the number of bits per meshlet triangle index
+	if (file.meshlets.size() != 0 && mheader.maxVertices == 0) {
+		Log::error("Couldn't write oiRM file; the meshlets don't have any vertices");
+		return {};
+	}
 
 	u32 perIndexb = (u32) std::ceil(std::log2(file.header.vertices));
 
@@ -504,7 +681,7 @@ Buffer oiRM::write(RMFile &file, bool compression) {
 	CopyBuffer ind;
 
 	Buffer b = oiSL::write(file.names);
-	CopyBuffer vertices;
+	CopyBuffer vertices, sections;
 
 	u32 miscBufLen = 0;
 	for (CopyBuffer &cb : file.miscBuffer)
@@ -540,44 +717,44 @@ Buffer oiRM::write(RMFile &file, bool compression) {
 				u32 channels = Graphics::getChannels(format);
 				u32 bpc = Graphics::getChannelSize(format);
 
-				std::vector<u32> uniqueChannels;
-				uniqueChannels.reserve(channels * file.header.vertices);
-				u32 *auniqueChannels = uniqueChannels.data(), auniqueChannelC = 0;
+				//Channels and attributes (combinations of channels) get an index in the order they first appear
 
-				std::vector<u32> currentChannel(channels);
-				u32 *acurrentChannel = currentChannel.data();
+				IndexMap<u64> uniqueChannel(file.header.vertices);
+				IndexMap<Vec4u> uniqueAttribute(file.header.vertices);
 
 				std::vector<u32> attributes(file.header.vertices);
 				u32 *aattributes = attributes.data();
 
-				CopyBuffer chan;
-
 				for (u32 k = 0; k < file.header.vertices; ++k) {
 
 					u8 *ptr = avbo + offset + k * vb.stride;
 
-					bool modified = false;
+					Vec4u currentChannel;
 
-					//Add channels (if the channel is new, the attribute is)
-					for (u32 l = 0; l < channels; ++l)
-						modified = addChannel(chan, bpc, ptr + l * bpc, acurrentChannel + l) || modified;
+					for (u32 l = 0; l < channels; ++l) {
+						u64 channel = 0;
+						memcpy(&channel, ptr + l * bpc, bpc);
+						currentChannel[l] = uniqueChannel.insert(channel);
+					}
 
-					u32 attrib = auniqueChannelC / channels;
+					aattributes[k] = uniqueAttribute.insert(currentChannel);
 
-					//Check if the combinations of channels is new
-					if (!modified) {
-						attrib = findAttribute(auniqueChannels, auniqueChannelC, acurrentChannel, channels);
-						modified = attrib == auniqueChannelC / channels;
-					}
+				}
 
-					//Push attribute
-					if (modified) {
-						uniqueChannels.insert(uniqueChannels.end(), currentChannel.begin(), currentChannel.end());
-						auniqueChannelC = (u32)uniqueChannels.size();
-					}
+				CopyBuffer chan(uniqueChannel.size() * bpc);
+				u8 *achan = chan.addr();
+
+				for (const u64 &channel : uniqueChannel.getKeys()) {
+					memcpy(achan, &channel, bpc);
+					achan += bpc;
+				}
 
-					aattributes[k] = attrib;
+				std::vector<u32> uniqueChannels(uniqueAttribute.size() * channels);
+				u32 *auniqueChannels = uniqueChannels.data();
 
+				for (const Vec4u &attribute : uniqueAttribute.getKeys()) {
+					memcpy(auniqueChannels, attribute.arr, channels * 4);
+					auniqueChannels += channels;
 				}
 
 				u32 channelKey = chan.size() / bpc;
@@ -647,6 +824,18 @@ Buffer oiRM::write(RMFile &file, bool compression) {
 						}
 					} else if (curr.x == curr.y + 1 && curr.y == curr.z + 2) {
 
+						//The previous triangle can only form a quad with this one if it is [n + 2, n + 1, n]
+						if (prev && aindices[(i - 1) * 3 + 2] != curr.z) {
+							ops[2 * opOff] = true;
+							ops[2 * opOff + 1] = false;
+							start[opOff] = (i - 1) * 3 + 2;		//Save the base index
+							++opOff;
+							++i10;
+							++totalInd;
+							test += 3;
+							prev = false;
+						}
+
 						//RevIndInc2
 						if (!prev) {
 							ops[2 * opOff] = true;
@@ -777,7 +966,57 @@ Buffer oiRM::write(RMFile &file, bool compression) {
 
 	}
 
-	file.size = (u32) sizeof(header) + vertexBuffer + vertexAttribute + misc + vertices.size() + ind.size() + miscBuf.size() + file.names.size;
+	//Meshlets are only stored from V0_0_2 and LODs from V0_0_3; otherwise the file stays readable as V0_0_1
+
+	if (file.lods.size() != 0)
+		header.version = RMHeaderVersion::V0_0_3;
+	else if (file.meshlets.size() != 0)
+		header.version = RMHeaderVersion::V0_0_2;
+	else
+		header.version = RMHeaderVersion::V0_0_1;
+
+	if (header.version >= RMHeaderVersion::V0_0_2.value) {
+
+		mheader.meshlets = (u32) file.meshlets.size();
+		mheader.vertices = (u32) file.meshletVertices.size();
+		mheader.triangles = (u32) file.meshletTriangles.size() / 3;
+
+		sections = CopyBuffer((u8*) &mheader, (u32) sizeof(mheader));
+
+		if (mheader.meshlets != 0 && compression) {
+
+			//Vertices use as many bits as the indices, triangles as many as the max vertex of a meshlet
+
+			u32 perLocalb = (u32) std::ceil(std::log2(mheader.maxVertices));
+			std::vector<u32> triangles(file.meshletTriangles.begin(), file.meshletTriangles.end());
+
+			Bitset vertexBits(perIndexb * mheader.vertices), triangleBits(perLocalb * mheader.triangles * 3);
+			vertexBits.write(file.meshletVertices, perIndexb);
+			triangleBits.write(triangles, perLocalb);
+
+			sections += CopyBuffer((u8*) file.meshlets.data(), mheader.meshlets * (u32) sizeof(RMMeshlet)) + vertexBits.toBuffer() + triangleBits.toBuffer();
+
+		} else if (mheader.meshlets != 0)
+			sections += CopyBuffer((u8*) file.meshlets.data(), mheader.meshlets * (u32) sizeof(RMMeshlet)) + CopyBuffer((u8*) file.meshletVertices.data(), mheader.vertices * 4) + CopyBuffer(file.meshletTriangles.data(), mheader.triangles * 3);
+	}
+
+	if (header.version >= RMHeaderVersion::V0_0_3.value) {
+
+		RMLodHeader &lheader = file.lodHeader;
+		lheader.lods = (u32) file.lods.size();
+		lheader.indices = (u32) file.lodIndices.size();
+
+		sections += CopyBuffer((u8*) &lheader, (u32) sizeof(lheader)) + CopyBuffer((u8*) file.lods.data(), lheader.lods * (u32) sizeof(RMLod));
+
+		if (compression) {
+			Bitset bitset(perIndexb * lheader.indices);
+			bitset.write(file.lodIndices, perIndexb);
+			sections += bitset.toBuffer();
+		} else
+			sections += CopyBuffer((u8*) file.lodIndices.data(), lheader.indices * 4);
+	}
+
+	file.size = (u32) sizeof(header) + vertexBuffer + vertexAttribute + misc + vertices.size() + ind.size() + miscBuf.size() + file.names.size + sections.size();
 
 	Buffer output(file.size);
 	Buffer write = output;
@@ -809,8 +1048,21 @@ Buffer oiRM::write(RMFile &file, bool compression) {
 	write = write.offset(b.size());
 	b.deconstruct();
 
+	memcpy(write.addr(), sections.addr(), sections.size());
+	write = write.offset(sections.size());
+
 	/*t.print();*/
 
+	if (blockCompression != CompressionCodec::None) {
+
+		Buffer compressed = BlockCompression::compress(output, blockCompression);
+
+		if (compressed.size() != 0) {
+			output.deconstruct();
+			return compressed;
+		}
+	}
+
 	return output;
 
 }
@@ -285,13 +285,15 @@ bool oiSH::read(String path, SHFile &file) {
 
 	Buffer buf;
 
-	if(!FileManager::get()->read(path, buf))
+	if(!FileManager::get()->map(path, buf))
 		return Log::error("Couldn't open file");
 
-	if (!read(buf, file))
+	if (!read(buf, file)) {
+		FileManager::get()->unmap(buf);
 		return Log::error("Couldn't read file");
+	}
 
-	buf.deconstruct();
+	FileManager::get()->unmap(buf);
 	return true;
 }
 
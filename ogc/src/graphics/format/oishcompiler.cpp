@@ -5,10 +5,31 @@
 #include "graphics/helper/spvhelper.h"
 #include "graphics/format/oish.h"
 #include "graphics/objects/shader/shader.h"
+#include <mutex>
 using namespace oi::gc;
 using namespace oi::wc;
 using namespace oi;
 
+//glslang::InitializeProcess and FinalizeProcess can't be called concurrently
+static std::mutex compilerMutex;
+static u32 compilerUsers = 0;
+
+void oiSH::initCompiler() {
+
+	std::lock_guard<std::mutex> lock(compilerMutex);
+
+	if (compilerUsers++ == 0)
+		glslang::InitializeProcess();
+}
+
+void oiSH::destroyCompiler() {
+
+	std::lock_guard<std::mutex> lock(compilerMutex);
+
+	if (compilerUsers != 0 && --compilerUsers == 0)
+		glslang::FinalizeProcess();
+}
+
 SHFile oiSH::convert(ShaderSource &source, bool stripDebug) {
 	std::vector<String> deps;
 	return convert(source, deps, stripDebug);
@@ -105,6 +126,12 @@ bool oiSH::compileSource(ShaderSource &source, bool useFile, std::vector<String>
 	constexpr u32 vulkanVersion = 100;
 	const String shaderVersion = "450";
 
+	//Released on every return; after the program and shaders are destroyed
+	struct CompilerScope {
+		CompilerScope() { initCompiler(); }
+		~CompilerScope() { destroyCompiler(); }
+	} compilerScope;
+
 	glslang::SpvOptions spvOptions;
 	spvOptions.disableOptimizer = false;
 	spvOptions.optimizeSize = true;
@@ -120,8 +147,6 @@ bool oiSH::compileSource(ShaderSource &source, bool useFile, std::vector<String>
 	if (lang == ShaderSourceType::HLSL)
 		compileFlags = EShMessages(compileFlags | EShMsgReadHlsl | EShMsgHlslOffsets | EShMsgHlslEnable16BitTypes | EShMsgHlslLegalization);
 
-	glslang::InitializeProcess();
-
 	u32 len = (u32)(useFile ? source.files.size() : source.src.size());
 	auto it = source.src.begin();
 
@@ -297,8 +322,6 @@ bool oiSH::compileSource(ShaderSource &source, bool useFile, std::vector<String>
 	for (glslang::TShader *stage : shaderStages)
 		delete stage;
 
-	glslang::FinalizeProcess();
-
 	return true;
 }
 
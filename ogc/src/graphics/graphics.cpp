@@ -4,63 +4,32 @@ using namespace oi::gc;
 using namespace oi;
 
 bool Graphics::isDepthFormat(TextureFormat format) {
-	return format.getValue() >= TextureFormat::D16 && format.getValue() <= TextureFormat::Depth_stencil;
+	return textureFormatInfo[format.getIndex()].isDepth;
 }
 
 bool Graphics::hasStencil(TextureFormat format) {
-	return format.getName().contains("S");
+	return textureFormatInfo[format.getIndex()].hasStencil;
 }
 
 TextureLoadFormat Graphics::getLoadFormat(TextureFormat format) {
-
-	if (format.getValue() >= TextureFormat::BGRA8)
-		return format.getName().replace("BGR", "RGB");
-
-	if (isDepthFormat(format))
-		return format.getName().replace("D", "R");
-
-	return format.getName();
+	return TextureLoadFormat(textureFormatInfo[format.getIndex()].loadFormat);
 }
 
 u32 Graphics::getChannelSize(TextureFormat format) {
-
-	const TextureFormat_s &val = format.getValue();
-
-	if (val == TextureFormat::Undefined || val == TextureFormat::Depth || val == TextureFormat::Depth_stencil)
-		return 0U;
-
-	if (val < TextureFormat::RGBA16) return 1U;
-	if (val < TextureFormat::RGBA32f || val == TextureFormat::D16) return 2U;
-	if (val == TextureFormat::D16S8) return 3U;
-	if (val < TextureFormat::RGBA64f || val == TextureFormat::D32 || val == TextureFormat::D24S8) return 4U;
-	if (val < TextureFormat::D16) return 8U;
-	if (val == TextureFormat::D32S8) return 5U;
-
-	return 1U;
+	return textureFormatInfo[format.getIndex()].channelSize;
 }
 
 u32 Graphics::getChannels(TextureFormat format) {
-
-	u32 val = format.getValue();
-
-	if (val == 0) return 0U;
-	if (val < TextureFormat::D16) return 4U - (val - 1U) % 4U;
-	if (val < TextureFormat::sRGBA8) return 1U;
-	if(val < TextureFormat::BGRA8) return 4U - (val - TextureFormat::sRGBA8);
-
-	return 4 - (val - TextureFormat::BGRA8) % 2U;
+	return textureFormatInfo[format.getIndex()].channels;
 }
 
 TextureFormatStorage Graphics::getFormatStorage(TextureFormat format) {
-
-	if (format.getName().endsWith("u")) return TextureFormatStorage::UINT;
-	if (format.getName().endsWith("i")) return TextureFormatStorage::INT;
-
-	return format.getName().endsWith("64f") ? TextureFormatStorage::DOUBLE : TextureFormatStorage::FLOAT;
+	return textureFormatInfo[format.getIndex()].storage;
 }
 
 bool Graphics::isCompatible(TextureFormat a, TextureFormat b) {
-	return getFormatStorage(a) == getFormatStorage(b) && getChannels(a) == getChannels(b);
+	const TextureFormatInfo &ia = textureFormatInfo[a.getIndex()], &ib = textureFormatInfo[b.getIndex()];
+	return ia.storage == ib.storage && ia.channels == ib.channels;
 }
 
 
@@ -77,7 +46,10 @@ Vec4d Graphics::convertColor(Vec4d cl, TextureFormat format) {
 
 }
 
-u32 Graphics::getFormatSize(TextureFormat format) { return getChannelSize(format) * getChannels(format); }
+u32 Graphics::getFormatSize(TextureFormat format) {
+	const TextureFormatInfo &info = textureFormatInfo[format.getIndex()];
+	return u32(info.channelSize) * info.channels;
+}
 
 RenderTarget *Graphics::getBackBuffer() { return backBuffer; }
 u32 Graphics::getBuffering() { return buffering; }
@@ -138,6 +110,7 @@ bool Graphics::destroyObject(GraphicsObject *go) {
 
 	if (--go->refCount <= 0) {
 		vec.erase(itt);
+		freeId(go);
 		allocator.dealloc(go);
 	}
 
@@ -150,12 +123,27 @@ void Graphics::use(GraphicsObject *go) {
 		++go->refCount;
 }
 
+u32 Graphics::allocId() {
+
+	u32 id = idAllocator.alloc();
+
+	if (id == IdAllocator::invalidId)
+		Log::throwError<Graphics, 0x2>("Couldn't init GraphicsObject; couldn't find a valid id");
+
+	return id;
+}
+
+void Graphics::freeId(GraphicsObject *go) {
+	objectsById[IdAllocator::getIndex(go->getId())] = nullptr;
+	idAllocator.dealloc(go->getId());
+}
+
 GraphicsObject *Graphics::get(u32 id) {
-	return contains(id) ? objectsById[id] : nullptr;
+	return contains(id) ? objectsById[IdAllocator::getIndex(id)] : nullptr;
 }
 
 bool Graphics::contains(u32 id) {
-	return idAllocator[id];
+	return idAllocator.contains(id) && IdAllocator::getIndex(id) < objectsById.size();
 }
 
 void Graphics::use(u32 id) {
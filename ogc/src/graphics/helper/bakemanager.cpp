@@ -1,4 +1,7 @@
+#include <map>
 #include "file/filemanager.h"
+#include "types/threadpool.h"
+#include "utils/hash.h"
 #include "graphics/format/obj.h"
 #include "graphics/format/fbx.h"
 #include "graphics/format/oish.h"
@@ -16,7 +19,7 @@ bool BakeManager::bakeModel(BakedFile &file, bool) {
 		file.outputs[0] = file.file + ".oiRM";
 
 		if (!Obj::convert(file.file + "." + file.extension, file.outputs[0], true))
-			return Log::error(file.inputs[0] + " couldn't bake obj model");
+			return Log::format<LogLevel::ERROR>("{} couldn't bake obj model", file.inputs[0]);
 
 		return true;
 
@@ -25,7 +28,7 @@ bool BakeManager::bakeModel(BakedFile &file, bool) {
 	std::unordered_map<String, Buffer> res;
 
 	if ((res = Fbx::convertMeshes(file.inputs[0], true)).size() == 0)
-		return Log::error(file.inputs[0] + " couldn't bake fbx model");
+		return Log::format<LogLevel::ERROR>("{} couldn't bake fbx model", file.inputs[0]);
 
 	file.outputs.resize(res.size());
 
@@ -43,7 +46,7 @@ bool BakeManager::bakeModel(BakedFile &file, bool) {
 
 		if (!FileManager::get()->write(current, elem.second)) {
 			complete = false;
-			Log::error(current + " couldn't bake fbx model");
+			Log::format<LogLevel::ERROR>("{} couldn't bake fbx model", current);
 		}
 
 		elem.second.deconstruct();
@@ -64,10 +67,10 @@ bool BakeManager::bakeShader(BakedFile &file, bool stripDebug) {
 
 	SHFile info = oiSH::convert(source, file.dependencies, stripDebug);
 	if (info.bytecode.size() == 0)
-		return Log::error(file.outputs[0] + " couldn't compile shader");
+		return Log::format<LogLevel::ERROR>("{} couldn't compile shader", file.outputs[0]);
 
 	if (!oiSH::write(file.outputs[0], info))
-		return Log::error(file.outputs[0] + " couldn't write oiSH file");
+		return Log::format<LogLevel::ERROR>("{} couldn't write oiSH file", file.outputs[0]);
 
 	return true;
 
@@ -201,8 +204,11 @@ void BakeManager::load() {
 		if (memcmp(header.header, "oiBM", 4) != 0)
 			Log::throwError<BakeManager, 0x1>("Invalid BakeManager file header");
 
+		//Legacy caches are migrated by checking modification times once
+		bool hashed = header.version == BMHeader::getGlobalVersion();
+
 		//The file format isn't valid anymore; rebake
-		if (header.version != BMHeader::getGlobalVersion())
+		if (!hashed && header.version != BMHeader::getLegacyVersion())
 			return;
 
 		//Different flags; rebake
@@ -228,6 +234,13 @@ void BakeManager::load() {
 
 		u16 *bakedInfop = bakedInfo.data();
 
+		std::vector<u64> bakedHashes;
+
+		if (hashed && !write.read(bakedHashes, ushorts))
+			Log::throwError<BakeManager, 0x5>("Invalid BakeManager's hash size");
+
+		u64 *bakedHashesp = bakedHashes.data();
+
 		if (!oiSL::read(write, file.strings))
 			Log::throwError<BakeManager, 0x4>("Invalid BakeManager strings");
 
@@ -255,6 +268,20 @@ void BakeManager::load() {
 				out.dependencies[j] = file.strings.names[bakedInfop[j]];
 
 			bakedInfop += bmbf.dependencies;
+
+			if (hashed) {
+
+				out.inputHashes.assign(bakedHashesp, bakedHashesp + bmbf.inputs);
+				bakedHashesp += bmbf.inputs;
+
+				out.outputHashes.assign(bakedHashesp, bakedHashesp + bmbf.outputs);
+				bakedHashesp += bmbf.outputs;
+
+				out.dependencyHashes.assign(bakedHashesp, bakedHashesp + bmbf.dependencies);
+				bakedHashesp += bmbf.dependencies;
+			}
+
+			index[makeKey(out)] = i;
 			++i;
 		}
 
@@ -269,9 +296,15 @@ int BakeManager::run() {
 
 	Log::println("BakingManager started...");
 
+	hashes.clear();
+
+	//Find all files that have to be baked
+
+	std::vector<std::pair<BakeOption*, BakedFile>> stale;
+
 	for (BakeOption &bo : bakeOptions) {
 
-		std::unordered_map<String, std::vector<String>> paths;
+		std::map<String, std::vector<String>> paths;
 		std::unordered_map<String, String> types;
 
 		FileManager::get()->foreachFileRecurse(bo.path, [&](const FileInfo &fi) -> bool {
@@ -291,7 +324,7 @@ int BakeManager::run() {
 							if (it == types.end())
 								types[origin] = elem.first;
 							else if (it->second != elem.first) {
-								Log::println(String("There was already an entry named \"") + origin.replaceFirst("mod/", "res/") + "\" but the types didn't match (" + elem.first + " vs " + types[origin] + ")");
+								Log::format("There was already an entry named \"{}\" but the types didn't match ({} vs {})", origin.replaceFirst("mod/", "res/"), elem.first, types[origin]);
 								return false;
 							}
 
@@ -318,45 +351,134 @@ int BakeManager::run() {
 			bf.extension = types[elem.first];
 
 			if (!shouldUpdate(bf)) {
-				Log::println(bf.file.replaceFirst("mod/", "res/") + " is already updated");
+				Log::format("{} is already updated", bf.file.replaceFirst("mod/", "res/"));
 				continue;
 			}
 
-			bo.bake(bf, stripDebug);
-			cache(bf);
-			Log::println(bf.file.replaceFirst("mod/", "res/") + " has been updated");
+			stale.push_back({ &bo, bf });
 
 		}
 
 	}
 
+	//Bake every file as a job; a job waits for the jobs that produce the files it depends on
+
+	JobGraph graph;
+	std::unordered_map<String, u32> owners;
+
+	for (auto &elem : stale) {
+
+		u32 job = graph.add([&elem, this]() {
+
+			BakedFile &bf = elem.second;
+
+			//A failed bake stores invalid (0) hashes; so it is retried the next time
+			if (elem.first->bake(bf, stripDebug))
+				hash(bf);
+			else {
+				bf.inputHashes.assign(bf.inputs.size(), 0);
+				bf.outputHashes.assign(bf.outputs.size(), 0);
+				bf.dependencyHashes.assign(bf.dependencies.size(), 0);
+			}
+
+		});
+
+		for (String &in : elem.second.inputs)
+			owners[in] = job;
+
+		if (BakedFile *cached = find(elem.second))
+			for (String &out : cached->outputs)
+				owners[out] = job;
+	}
+
+	for (u32 i = 0, j = (u32) stale.size(); i < j; ++i)
+		if (BakedFile *cached = find(stale[i].second))
+			for (String &dep : cached->dependencies) {
+
+				auto it = owners.find(dep);
+
+				if (it != owners.end() && it->second != i)
+					graph.addEdge(it->second, i);
+			}
+
+	//Shaders are compiled on multiple threads; glslang has to be set up once before that (and not by every compile)
+	oiSH::initCompiler();
+	graph.run();
+	oiSH::destroyCompiler();
+
+	//Merge the results into the cache in the order they were found in
+
+	for (auto &elem : stale) {
+		cache(elem.second);
+		Log::format("{} has been updated", elem.second.file.replaceFirst("mod/", "res/"));
+	}
+
 	write();
 	Log::println("Baking finished");
 	return 0;
 
 }
 
-bool BakeManager::shouldUpdate(BakedFile &bf) {
+String BakeManager::makeKey(const BakedFile &bf) {
+	return String::combine(bf.inputs, "|");
+}
 
-	BakedFile *which = nullptr;
+BakedFile *BakeManager::find(BakedFile &bf) {
 
-	for (BakedFile &bf0 : file.files)
-		if (bf0.inputs == bf.inputs) {
-			which = &bf0;
-			break;
-		}
+	auto it = index.find(makeKey(bf));
 
-	if (which == nullptr)
-		return true;
+	if (it == index.end())
+		return nullptr;
 
-	for (String &out : which->outputs) {
+	return &file.files[it->second];
+}
+
+static u64 hashFile(const String &path) {
+
+	Buffer buf;
+
+	if (!FileManager::get()->read(path, buf))
+		return 0;
+
+	u64 h = Hash::xx64(buf);
+	buf.deconstruct();
+	return h;
+}
+
+static void hashFiles(const std::vector<String> &paths, std::vector<u64> &hashes) {
+
+	hashes.resize(paths.size());
+
+	for (size_t i = 0; i < paths.size(); ++i)
+		hashes[i] = hashFile(paths[i]);
+}
+
+void BakeManager::hash(BakedFile &bf) {
+	hashFiles(bf.inputs, bf.inputHashes);
+	hashFiles(bf.outputs, bf.outputHashes);
+	hashFiles(bf.dependencies, bf.dependencyHashes);
+}
+
+u64 BakeManager::getHash(const String &path) {
+
+	auto it = hashes.find(path);
+
+	if (it != hashes.end())
+		return it->second;
+
+	return hashes[path] = hashFile(path);
+}
+
+bool BakeManager::isOutdated(BakedFile &bf) {
+
+	for (String &out : bf.outputs) {
 
 		if (!FileManager::get()->fileExists(out))
 			return true;
 
 		FileInfo oinfo = FileManager::get()->getFile(out);
 
-		for (String &in : which->inputs) {
+		for (String &in : bf.inputs) {
 
 			FileInfo iinfo = FileManager::get()->getFile(in);
 
@@ -365,7 +487,7 @@ bool BakeManager::shouldUpdate(BakedFile &bf) {
 
 		}
 
-		for (String &in : which->dependencies) {
+		for (String &in : bf.dependencies) {
 
 			FileInfo dinfo = FileManager::get()->getFile(in);
 
@@ -379,17 +501,52 @@ bool BakeManager::shouldUpdate(BakedFile &bf) {
 	return false;
 }
 
+bool BakeManager::shouldUpdate(BakedFile &bf) {
+
+	BakedFile *which = find(bf);
+
+	if (which == nullptr)
+		return true;
+
+	//Migrated from a cache without hashes; trust the modification times and store the hashes
+
+	if (which->inputHashes.size() != which->inputs.size()) {
+
+		if (isOutdated(*which))
+			return true;
+
+		hash(*which);
+		changed = true;
+		return false;
+	}
+
+	//Only rebake if the contents of any input, output or dependency changed
+
+	for (size_t i = 0; i < which->outputs.size(); ++i)
+		if (which->outputHashes[i] == 0 || getHash(which->outputs[i]) != which->outputHashes[i])
+			return true;
+
+	for (size_t i = 0; i < which->inputs.size(); ++i)
+		if (which->inputHashes[i] == 0 || getHash(which->inputs[i]) != which->inputHashes[i])
+			return true;
+
+	for (size_t i = 0; i < which->dependencies.size(); ++i)
+		if (which->dependencyHashes[i] == 0 || getHash(which->dependencies[i]) != which->dependencyHashes[i])
+			return true;
+
+	return false;
+}
+
 void BakeManager::cache(BakedFile &bf) {
 
 	changed = true;
 
-	for (BakedFile &bf0 : file.files)
-		if (bf0.inputs == bf.inputs) {
-			bf0 = bf;
-			return;
-		}
-
-	file.files.push_back(bf);
+	if (BakedFile *which = find(bf))
+		*which = bf;
+	else {
+		index[makeKey(bf)] = u32(file.files.size());
+		file.files.push_back(bf);
+	}
 
 }
 
@@ -401,7 +558,7 @@ void BakeManager::write() {
 
 	if (changed) {
 
-		u32 size = u32(sizeof(BMHeader) + file.files.size() * sizeof(BMBakedFile));
+		u32 size = u32(sizeof(BMHeader) + file.files.size() * sizeof(BMBakedFile)), references = 0;
 
 		memcpy(file.header.header, "oiBM", 4);
 		file.header.files = (u16)file.files.size();
@@ -413,7 +570,7 @@ void BakeManager::write() {
 
 		for (BakedFile &bmbf : file.files) {
 
-			size += u32(bmbf.inputs.size() + bmbf.outputs.size() + bmbf.dependencies.size()) * 2;
+			references += u32(bmbf.inputs.size() + bmbf.outputs.size() + bmbf.dependencies.size());
 
 			std::vector<String> strings = bmbf.inputs;
 			strings.insert(strings.end(), bmbf.outputs.begin(), bmbf.outputs.end());
@@ -431,6 +588,8 @@ void BakeManager::write() {
 
 		}
 
+		size += references * u32(sizeof(u16) + sizeof(u64));
+
 		Buffer buf = oiSL::write(file.strings);
 
 		Buffer output(size + buf.size());
@@ -445,6 +604,7 @@ void BakeManager::write() {
 		u32 siz = u32(file.files.size() * sizeof(BMBakedFile));
 
 		u16 *ptr = (u16*)(write.addr() + siz);
+		u8 *hptr = write.addr() + siz + references * sizeof(u16);
 		BMBakedFile *bptr = (BMBakedFile*)write.addr();
 
 		for (BakedFile &bmbf : file.files) {
@@ -458,6 +618,15 @@ void BakeManager::write() {
 				++ptr;
 			}
 
+			//Files that were never hashed store 0; so they're rebaked
+			std::vector<u64> contentHashes = bmbf.inputHashes;
+			contentHashes.insert(contentHashes.end(), bmbf.outputHashes.begin(), bmbf.outputHashes.end());
+			contentHashes.insert(contentHashes.end(), bmbf.dependencyHashes.begin(), bmbf.dependencyHashes.end());
+			contentHashes.resize(strings.size());
+
+			memcpy(hptr, contentHashes.data(), contentHashes.size() * sizeof(u64));
+			hptr += contentHashes.size() * sizeof(u64);
+
 			bptr->inputs = (u8)bmbf.inputs.size();
 			bptr->outputs = (u8)bmbf.outputs.size();
 			bptr->dependencies = (u16)bmbf.dependencies.size();
@@ -466,9 +635,9 @@ void BakeManager::write() {
 		}
 
 		if (!FileManager::get()->write(location, output))
-			Log::error(String("Couldn't write cache to \"") + location.replaceFirst("mod/", "res/") + "\"");
+			Log::format<LogLevel::ERROR>("Couldn't write cache to \"{}\"", location.replaceFirst("mod/", "res/"));
 		else {
-			Log::println(String("Wrote cache to \"") + location.replaceFirst("mod/", "res/") + "\"");
+			Log::format("Wrote cache to \"{}\"", location.replaceFirst("mod/", "res/"));
 			changed = false;
 		}
 
@@ -8,6 +8,30 @@ const MeshInfo &Mesh::getInfo() const { return info; }
 MeshBuffer *Mesh::getBuffer() const { return info.buffer; }
 MeshAllocation Mesh::getAllocation() const { return info.allocation; }
 
+u32 Mesh::getLods() const { return info.lods.size() == 0 ? 1 : (u32) info.lods.size(); }
+
+MeshLod Mesh::getLod(u32 i) const {
+
+	if (i >= getLods())
+		Log::throwError<Mesh, 0x0>("Couldn't get LOD; out of bounds");
+
+	if (info.lods.size() == 0)
+		return { info.allocation.baseIndex, info.allocation.indices, 0 };
+
+	const MeshLod &lod = info.lods[i];
+	return { info.allocation.baseIndex + lod.baseIndex, lod.indices, lod.error };
+}
+
+u32 Mesh::selectLod(f32 maxError) const {
+
+	u32 i = 0;
+
+	while (i + 1 < (u32) info.lods.size() && info.lods[i + 1].error <= maxError)
+		++i;
+
+	return i;
+}
+
 Mesh::Mesh(MeshInfo info) : info(info) {}
 
 Mesh::~Mesh() { 
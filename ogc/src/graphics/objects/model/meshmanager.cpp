@@ -1,9 +1,13 @@
+#include <algorithm>
 #include "utils/timer.h"
+#include "types/threadpool.h"
+#include "file/filemanager.h"
 #include "graphics/format/oirm.h"
 #include "graphics/objects/model/meshmanager.h"
 #include "graphics/objects/model/meshbuffer.h"
 #include "graphics/objects/model/mesh.h"
 using namespace oi::gc;
+using namespace oi::wc;
 using namespace oi;
 
 MeshManager::MeshManager(MeshManagerInfo info) : info(info) { }
@@ -43,7 +47,7 @@ Mesh *MeshManager::get(String path) const {
 	auto it = info.meshAllocations.find(path);
 
 	if (it == info.meshAllocations.end())
-		return (Mesh*) Log::error(String("Couldn't get Mesh by path \"") + path + "\"");
+		return (Mesh*) Log::format<LogLevel::ERROR>("Couldn't get Mesh by path \"{}\"", path);
 
 	return it->second.mesh;
 
@@ -93,7 +97,7 @@ Mesh *MeshManager::load(MeshAllocationInfo minfo) {
 
 			RMFile file;
 			if (!oiRM::read(minfo.path, file))
-				return (Mesh*)Log::error(String("Couldn't read mesh from file \"") + minfo.name + "\"");
+				return (Mesh*)Log::format<LogLevel::ERROR>("Couldn't read mesh from file \"{}\"", minfo.name);
 
 			auto rmdat = oiRM::convert(file);
 
@@ -102,10 +106,10 @@ Mesh *MeshManager::load(MeshAllocationInfo minfo) {
 				minfo.meshBuffer = findBuffer(rmdat.first, minfo);
 
 				if (minfo.meshBuffer == nullptr)
-					return (Mesh*)Log::error(String("Couldn't write mesh into meshBuffer \"") + minfo.name + "\" couldn't find or allocate MeshBuffer");
+					return (Mesh*)Log::format<LogLevel::ERROR>("Couldn't write mesh into meshBuffer \"{}\" couldn't find or allocate MeshBuffer", minfo.name);
 
 			} else if (!validateBuffer(minfo, rmdat.first))
-				return (Mesh*)Log::error(String("Couldn't write mesh into meshBuffer \"") + minfo.name + "\" (" + minfo.meshBuffer->getName() + ")");
+				return (Mesh*)Log::format<LogLevel::ERROR>("Couldn't write mesh into meshBuffer \"{}\" ({})", minfo.name, minfo.meshBuffer->getName());
 
 			MeshInfo mi = rmdat.second;
 			mi.buffer = minfo.meshBuffer;
@@ -136,7 +140,7 @@ Mesh *MeshManager::load(MeshAllocationInfo minfo) {
 			mbinfo.maxIndices = minfo.ibo.size() / 4;
 
 			if(!validateBuffer(minfo, mbinfo))
-				return (Mesh*)Log::error(String("Couldn't write mesh into meshBuffer \"") + minfo.name + "\" (" + minfo.meshBuffer->getName() + ")");
+				return (Mesh*)Log::format<LogLevel::ERROR>("Couldn't write mesh into meshBuffer \"{}\" ({})", minfo.name, minfo.meshBuffer->getName());
 
 			MeshInfo mi;
 			mi.buffer = minfo.meshBuffer;
@@ -161,103 +165,151 @@ Mesh *MeshManager::load(MeshAllocationInfo minfo) {
 std::vector<Mesh*> MeshManager::loadAll(std::vector<MeshAllocationInfo> &minfo) {
 
 	Timer t;
+	timings = {};
 
-	//Get all loaded meshes or load them from disk
+	//Get all loaded meshes and validate raw data; the files are loaded afterwards
 
-	std::vector<Mesh*> meshes(minfo.size());
-	memset(meshes.data(), 0, sizeof(Mesh*) * meshes.size());
+	u32 count = (u32) minfo.size();
 
-	std::vector<std::pair<MeshBufferInfo, MeshInfo>> oiRMs(minfo.size());
-	
-	u32 i = 0;
-	for (const MeshAllocationInfo &mai : minfo) {
+	std::vector<Mesh*> meshes(count, nullptr);
+	std::vector<std::pair<MeshBufferInfo, MeshInfo>> oiRMs(count);
+	std::vector<u32> files;
+
+	for (u32 i = 0; i < count; ++i) {
+
+		MeshAllocationInfo &mai = minfo[i];
 
 		auto it = info.meshAllocations.find(mai.name);
 
-		if (it == info.meshAllocations.end()) {
+		if (it != info.meshAllocations.end()) {
+			meshes[i] = it->second.mesh;
+			continue;
+		}
+
+		if (mai.path != "") {
+			files.push_back(i);
+			continue;
+		}
+
+		if (mai.meshBuffer == nullptr) {
+			Log::error("Couldn't write mesh into meshBuffer; when submitting raw data, be sure to use a valid buffer");
+			continue;
+		}
+
+		MeshBufferInfo mbinfo = mai.meshBuffer->getInfo();
 
-			if (mai.path == "") {
+		if (mai.vbos.size() != mbinfo.vbos.size() || (mai.ibo.size() == 0) != (mbinfo.ibo == nullptr)) {
+			Log::error("Couldn't write mesh into meshBuffer; when submitting raw data, the number of buffers (vbos, ibo) has to be the same");
+			continue;
+		}
 
-				if (mai.meshBuffer == nullptr) {
-					Log::error("Couldn't write mesh into meshBuffer; when submitting raw data, be sure to use a valid buffer");
-					continue;
-				}
+		u32 j = 0;
+		bool invalidVbo = false;
 
-				MeshBufferInfo mbinfo = mai.meshBuffer->getInfo();
+		for (Buffer b : mai.vbos) {
 
-				if (mai.vbos.size() != mbinfo.vbos.size() || (mai.ibo.size() == 0) != (mbinfo.ibo == nullptr)) {
-					Log::error("Couldn't write mesh into meshBuffer; when submitting raw data, the number of buffers (vbos, ibo) has to be the same");
-					continue;
-				}
+			if (b.size() % mbinfo.vboStrides[j] != 0) {
+				Log::error("Couldn't write mesh into meshBuffer; when submitting raw data, the vbo layouts have to be the same");
+				invalidVbo = true;
+				break;
+			}
 
-				u32 j = 0;
-				bool invalidVbo = false;
+			++j;
+		}
 
-				for (Buffer b : mai.vbos) {
+		if (invalidVbo) continue;
 
-					if (b.size() % mbinfo.vboStrides[j] != 0) {
-						Log::error("Couldn't write mesh into meshBuffer; when submitting raw data, the vbo layouts have to be the same");
-						invalidVbo = true;
-						break;
-					}
+		mbinfo.maxVertices = mai.vbos[0].size() / mbinfo.vboStrides[0];
+		mbinfo.maxIndices = mai.ibo.size() / 4;
 
-					++j;
-				}
+		MeshInfo mi;
+		mi.buffer = mai.meshBuffer;
+		mi.indices = mbinfo.maxIndices;
+		mi.vertices = mbinfo.maxVertices;
+		mi.vbo = mai.vbos;
+		mi.ibo = mai.ibo;
 
-				if (invalidVbo) continue;
+		oiRMs[i] = { mbinfo, mi };
+	}
 
-				mbinfo.maxVertices = mai.vbos[0].size() / mbinfo.vboStrides[0];
-				mbinfo.maxIndices = mai.ibo.size() / 4;
-				
-				MeshInfo mi;
-				mi.buffer = mai.meshBuffer;
-				mi.indices = mbinfo.maxIndices;
-				mi.vertices = mbinfo.maxVertices;
-				mi.vbo = mai.vbos;
-				mi.ibo = mai.ibo;
+	//Read, decompress and convert the files in parallel; every file only writes into its own slot
 
-				oiRMs[i] = { mbinfo, mi };
-				continue;
-			}
+	std::vector<MeshLoadTimings> fileTimings(files.size());
 
-			RMFile file;
-			if (!oiRM::read(mai.path, file)) {
-				Log::error(String("Couldn't load model \"") + mai.name + "\"");
-				continue;
-			}
+	ThreadPool::get().parallelFor(0, (u32) files.size(), 1, [&](u32 j) {
 
-			oiRMs[i] = oiRM::convert(file);
+		u32 i = files[j];
+		const MeshAllocationInfo &mai = minfo[i];
+		MeshLoadTimings &ft = fileTimings[j];
 
-		} else 
-			meshes[i] = it->second.mesh;
+		Timer stage;
+		Buffer buf;
 
-		++i;
+		if (!FileManager::get()->map(mai.path, buf) || buf.size() == 0) {
+			Log::format<LogLevel::ERROR>("Couldn't load model \"{}\"", mai.name);
+			return;
+		}
+
+		ft.read = stage.getDuration();
+
+		RMFile file;
+		bool success = oiRM::read(buf, file);
+		FileManager::get()->unmap(buf);
+
+		ft.decompress = stage.getDuration() - ft.read;
+
+		if (!success) {
+			Log::format<LogLevel::ERROR>("Couldn't load model \"{}\"", mai.name);
+			return;
+		}
+
+		oiRMs[i] = oiRM::convert(file);
+		ft.convert = stage.getDuration() - ft.read - ft.decompress;
+		ft.files = 1;
+	});
+
+	for (MeshLoadTimings &ft : fileTimings) {
+		timings.read += ft.read;
+		timings.decompress += ft.decompress;
+		timings.convert += ft.convert;
+		timings.files += ft.files;
 	}
 
+	timings.threads = ThreadPool::get().getThreads();
+	timings.load = t.getDuration();
+
 	t.lap("Load models from disk");
 
-	//Create MeshBuffers
+	//Create MeshBuffers; in the order of the input, so the placement is deterministic
 
-	std::unordered_map<MeshBuffer*, std::vector<std::pair<u32, MeshInfo*>>> batches;
+	std::vector<std::pair<MeshBuffer*, std::vector<u32>>> batches;
 
-	for (i = 0; i < (u32)minfo.size(); ++i) {
+	for (u32 i = 0; i < count; ++i) {
 		
 		if (meshes[i] != nullptr || oiRMs[i].second.vbo.size() == 0) continue;
 
-		MeshAllocationInfo &mai = minfo[i];	//What if oiRM not loaded?
-
-		if (mai.meshBuffer == nullptr) {
+		MeshAllocationInfo &mai = minfo[i];
 
+		if (mai.meshBuffer == nullptr)
 			mai.meshBuffer = findBuffer(oiRMs[i].first, mai);
-			batches[mai.meshBuffer].push_back({ i, &oiRMs[i].second });
+		else if (!validateBuffer(mai, oiRMs[i].first)) {
+			Log::format<LogLevel::ERROR>("Couldn't write mesh into meshBuffer \"{}\" ({})", mai.name, mai.meshBuffer->getName());
+			continue;
+		}
+
+		if (mai.meshBuffer == nullptr)
+			continue;
 
-		} else if (validateBuffer(mai, oiRMs[i].first))
-			batches[mai.meshBuffer].push_back({ i, &oiRMs[i].second });
+		auto it = std::find_if(batches.begin(), batches.end(), [&mai](const std::pair<MeshBuffer*, std::vector<u32>> &batch) -> bool { return batch.first == mai.meshBuffer; });
+
+		if (it == batches.end())
+			batches.push_back({ mai.meshBuffer, { i } });
 		else
-			Log::error(String("Couldn't write mesh into meshBuffer \"") + mai.name + "\" (" + mai.meshBuffer->getName() + ")");
+			it->second.push_back(i);
 
 	}
 
+	timings.meshBuffers = t.getDuration() - timings.load;
 	t.lap("Load MeshBuffers");
 
 	//Create Meshes
@@ -266,29 +318,32 @@ std::vector<Mesh*> MeshManager::loadAll(std::vector<MeshAllocationInfo> &minfo)
 
 		MeshBuffer *meshBuffer = elem.first;
 
-		for (auto &elem0 : elem.second) {
-
-			i = elem0.first;
+		for (u32 i : elem.second) {
 
-			MeshInfo *mi = elem0.second;
-			mi->buffer = meshBuffer;
+			MeshInfo &mi = oiRMs[i].second;
+			mi.buffer = meshBuffer;
 
 			MeshAllocationInfo &mai = minfo[i];
-			mai.mesh = meshes[i] = g->create(mai.name, *mi);
+			mai.mesh = meshes[i] = g->create(mai.name, mi);
 			info.meshAllocations[mai.name] = mai;
 
 		}
 
 	}
 
+	timings.meshes = t.getDuration() - timings.load - timings.meshBuffers;
 	t.lap("Load Meshes");
 	t.print();
 
+	Log::format("Loaded {} models on {} threads in {}s (read {}s, decompress {}s, convert {}s summed over all threads)", timings.files, timings.threads, timings.load, timings.read, timings.decompress, timings.convert);
+
 	return meshes;
 
 
 }
 
+const MeshLoadTimings &MeshManager::getLoadTimings() const { return timings; }
+
 void MeshManager::unload(Mesh *mesh) {
 
 	if (mesh == nullptr) return;
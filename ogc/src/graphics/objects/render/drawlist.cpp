@@ -10,8 +10,15 @@ u32 DrawList::getBatches() { return (u32) info.objects.size(); }
 u32 DrawList::getMaxBatches() { return info.maxBatches; }
 GPUBuffer *DrawList::getBuffer() { return info.drawBuffer; }
 
+bool DrawList::retainsMeshes() const { return !info.clearOnUse; }
+
 void DrawList::flush() {
 
+	if (!sorted) {
+		std::stable_sort(info.objects.begin(), info.objects.end(), [](const DrawCall &a, const DrawCall &b) -> bool { return a.sortKey < b.sortKey; });
+		sorted = true;
+	}
+
 	prepareDrawList();
 
 	if (info.clearOnUse)
@@ -20,34 +27,60 @@ void DrawList::flush() {
 
 void DrawList::clear() {
 
-	for (auto &elem : info.objects)
-		g->destroy(elem.first);
+	if (retainsMeshes())
+		for (auto &elem : info.objects)
+			g->destroy(elem.mesh);
 
 	info.objects.clear();
+	meshIds.clear();
+	sorted = true;
+	recordedInstances = 0;
 }
 
-void DrawList::draw(Mesh *m, u32 instances) {
+void DrawList::draw(Mesh *m, u32 instances, u64 sortKey) {
 
 	if (m->getInfo().buffer != info.meshBuffer) {
 		Log::error("Every MeshBuffer requires a different DrawList. The drawcall mentioned a Mesh that wasn't in the same MeshBuffer");
 		return;
 	}
 
-	auto it = std::find_if(info.objects.begin(), info.objects.end(), [m](const std::pair<Mesh*, u32> &m0) -> bool { return m0.first == m; });
+	if (meshIds.find(m->getId()) != meshIds.size())
+		Log::throwError<DrawList, 0x0>("Grouping the meshes by instance is required!");
 
-	if (it == info.objects.end()) {
+	if (getBatches() == getMaxBatches()) {
+		Log::error("The batches exceeded the maximum amount. Please increase this or decrease draw calls");
+		return;
+	}
+
+	if (!info.objects.empty() && sortKey < info.objects.back().sortKey)
+		sorted = false;
 
-		if (getBatches() == getMaxBatches()) {
-			Log::error("The batches exceeded the maximum amount. Please increase this or decrease draw calls");
-			return;
-		}
+	DrawCall call(m, instances, sortKey);
+	call.firstInstance = recordedInstances;
+	recordedInstances += instances;
 
-		info.objects.push_back({ m, instances });
+	meshIds.insert(m->getId());
+	info.objects.push_back(call);
+
+	if (retainsMeshes())
 		g->use(m);
+
+}
+
+void DrawList::draw(const DrawCall *draws, u32 count) {
+
+	if (count > getMaxBatches() - getBatches()) {
+		Log::error("The batches exceeded the maximum amount. Please increase this or decrease draw calls");
+		return;
 	}
-	else
-		Log::throwError<DrawList, 0x0>("Grouping the meshes by instance is required!");
 
+	for (u32 i = 0; i < count; ++i)
+		draw(draws[i].mesh, draws[i].instances, draws[i].sortKey);
+
+}
+
+void DrawList::draw(const std::vector<DrawCall> &draws) {
+	draw(draws.data(), (u32) draws.size());
 }
 
 DrawList::DrawList(DrawListInfo info) : info(info) {}
@@ -67,6 +100,7 @@ bool DrawList::init() {
 		return Log::error("Couldn't create DrawList; object buffer or mesh buffer was invalid");
 
 	info.objects.reserve(info.maxBatches);
+	meshIds.reserve(info.maxBatches);
 
 	if (!createCBO())
 		return Log::error("Couldn't reserve draw list");
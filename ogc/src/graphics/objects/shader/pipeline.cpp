@@ -131,6 +131,10 @@ Pipeline::~Pipeline() {
 }
 
 
+ShaderBufferHandle Pipeline::getHandle(String path) {
+	return info.shaderData->getHandle(path);
+}
+
 void Pipeline::setRegister(String path, GraphicsResource *object) {
 	info.shaderData->set(path, object);
 }
@@ -1,5 +1,6 @@
 #include "graphics/graphics.h"
 #include "graphics/objects/shader/shaderbuffer.h"
+#include "utils/hash.h"
 using namespace oi::gc;
 using namespace oi;
 
@@ -8,12 +9,32 @@ using namespace oi;
 ShaderBufferObject::ShaderBufferObject(ShaderBufferObject *parent, u32 offset, u32 length, std::vector<u32> arr, String name, TextureFormat format, SBOFlag flags) : parent(parent), offset(offset), length(length), arr(arr), name(name), format(format), flags(flags) {}
 ShaderBufferObject::ShaderBufferObject() : ShaderBufferObject(nullptr, 0, 0, {}, "", 0, (SBOFlag)0) {}
 
-void ShaderBufferObject::addChild(ShaderBufferObject *obj) { childs.push_back(obj); }
+void ShaderBufferObject::addChild(ShaderBufferObject *obj) {
+	childIndex[Hash::xx64((const u8*) obj->name.ptr(), obj->name.size())] = (u32) childs.size();
+	childs.push_back(obj);
+}
 
 ShaderBufferObject *ShaderBufferObject::find(String oname) {
+	return find(oname.ptr(), oname.size());
+}
+
+ShaderBufferObject *ShaderBufferObject::find(const char *oname, u32 length) {
+
+	auto it = childIndex.find(Hash::xx64((const u8*) oname, length));
+
+	if (it != childIndex.end()) {
+
+		ShaderBufferObject *child = childs[it->second];
+
+		if (child->name.size() == length && memcmp(child->name.ptr(), oname, length) == 0)
+			return child;
+	}
+
+	//Hash collision; fall back to comparing names
 	for (ShaderBufferObject *child : childs)
-		if (child->name == oname)
+		if (child->name.size() == length && memcmp(child->name.ptr(), oname, length) == 0)
 			return child;
+
 	return nullptr;
 }
 
@@ -28,7 +49,7 @@ bool ShaderBufferObject::operator==(const ShaderBufferObject &other) const {
 ShaderBufferInfo::ShaderBufferInfo(ShaderRegisterType type, u32 size, u32 elements, bool allocate) : type(type), size(size), elements(elements), allocate(allocate), self(nullptr, 0, size, {}, "", TextureFormat::Undefined, SBOFlag::Value) {}
 ShaderBufferInfo::ShaderBufferInfo() : ShaderBufferInfo(ShaderRegisterType::Undefined, 0, 0, false) {}
 
-void ShaderBufferInfo::addRoot(ShaderBufferObject *obj) { self.childs.push_back(obj); }
+void ShaderBufferInfo::addRoot(ShaderBufferObject *obj) { self.addChild(obj); }
 u32 ShaderBufferInfo::getRoots() { return (u32) self.childs.size(); }
 
 ShaderBufferObject &ShaderBufferInfo::operator[](u32 i) { return elements[i]; }
@@ -129,7 +150,22 @@ void ShaderBufferInfo::push(ShaderBufferObject obj, ShaderBufferObject &parent)
 	elements.push_back(obj);
 
 	ShaderBufferObject *objptr = &elements[elements.size() - 1U];
-	(objptr->parent = (parentId == 0 ? &self : elements.data() + (parentId - 1U)))->childs.push_back(objptr);
+	(objptr->parent = (parentId == 0 ? &self : elements.data() + (parentId - 1U)))->addChild(objptr);
+}
+
+///ShaderBufferHandle
+
+ShaderBufferHandle ShaderBufferHandle::operator[](u32 i) const {
+
+	if (dimensions.size() == 0)
+		return *this;
+
+	ShaderBufferHandle handle = *this;
+	handle.offset += (i % dimensions[0]) * strides[0];
+	handle.length /= dimensions[0];
+	handle.dimensions.erase(handle.dimensions.begin());
+	handle.strides.erase(handle.strides.begin());
+	return handle;
 }
 
 ///ShaderBufferVar
@@ -222,64 +258,78 @@ bool ShaderBuffer::init() {
 	return true;
 }
 
-void ShaderBuffer::calculateArrayInfo(std::vector<u32> &off, std::vector<u32> &len, u32 stride, u32 &offset, u32 &count) {
-
-	u32 totalOffset = 0;
-	count = 1;
+ShaderBufferHandle ShaderBuffer::getHandle(String path) {
 
-	for (u32 x : len)
-		count *= x;
+	ShaderBufferHandle handle;
+	handle.buffer = this;
+	handle.obj = &info.self;
 
-	for (u32 i = 0, j = (u32)off.size(), k = (u32)len.size(); i < j && i < k; ++i) {
-		u32 siz = len[k - 1 - i];
-		count /= siz;
-		totalOffset += (off[i] % siz) * count;
+	if (path == "") {
+		handle.length = info.size;
+		return handle;
 	}
 
-	offset += totalOffset * stride;
+	ShaderBufferObject *sbo = &info.self;
+	u32 offset = 0, indexed = 0;
 
-}
+	for (StringView part : StringView(path).split("/")) {
 
-ShaderBufferVar ShaderBuffer::get(String path) {
+		if (part.empty())
+			continue;
 
-	if (path == "") return get();
+		u32 index = 0;
 
-	ShaderBufferObject *sbo = &info.self;
-	u32 offset = 0, count = 0;
+		if (!part.isUint() || !part.toUInt(index)) {
 
-	std::vector<u32> arr;
+			if ((sbo = sbo->find(part.data(), part.size())) == nullptr)
+				Log::throwError<ShaderBufferVar, 0x1>(String("Couldn't find the path \"") + path + "\"");
+			else
+				offset += sbo->offset;
 
-	for (char *beg = path.ptr(), *c = beg, *end = beg + path.size(), *prev = beg; c < end; ++c) {
+			indexed = 0;
 
-		bool isEnd = c == end - 1;
+		}
 
-		if (*c == '/' || isEnd) {
+		//Arrays are stored inner to outer, so the first index is for the last dimension
+		else if (indexed < sbo->arr.size()) {
 
-			String str(prev, u32(c - prev + isEnd));
+			u32 dims = (u32) sbo->arr.size() - indexed, stride = sbo->length;
 
-			if (!str.isUint()) {
+			for (u32 i = 0; i < dims - 1; ++i)
+				stride *= sbo->arr[i];
 
-				if (arr.size() != 0) {
-					calculateArrayInfo(arr, sbo->arr, sbo->length, offset, count);
-					arr.clear();
-				}
+			offset += (index % sbo->arr[dims - 1]) * stride;
+			++indexed;
+		}
+		
+	}
 
-				if ((sbo = sbo->find(str)) == nullptr)
-					Log::throwError<ShaderBufferVar, 0x1>(String("Couldn't find the path \"") + path + "\"");
-				else
-					offset += sbo->offset;
+	handle.obj = sbo;
+	handle.offset = offset;
 
-			}
-			else
-				arr.push_back((u32)str.toLong());
+	//Dimensions that weren't indexed; stored outer to inner
+	u32 remaining = (u32) sbo->arr.size() - indexed, stride = sbo->length;
 
-			prev = c + 1;
+	handle.dimensions.resize(remaining);
+	handle.strides.resize(remaining);
 
-		}
-		
+	for (u32 i = 0; i < remaining; ++i) {
+		handle.dimensions[remaining - 1 - i] = sbo->arr[i];
+		handle.strides[remaining - 1 - i] = stride;
+		stride *= sbo->arr[i];
 	}
 
-	calculateArrayInfo(arr, sbo->arr, sbo->length, offset, count);
+	handle.length = stride;
+	return handle;
+}
+
+ShaderBufferVar ShaderBuffer::get(String path) {
+
+	if (path == "") return get();
+
+	return get(getHandle(path));
+}
 
-	return { *sbo, Buffer::construct(buffer->getAddress() + offset, sbo->length * count) };
+ShaderBufferVar ShaderBuffer::get(const ShaderBufferHandle &handle) {
+	return { *handle.obj, Buffer::construct(buffer->getAddress() + handle.offset, handle.length) };
 }
\ No newline at end of file
@@ -28,6 +28,25 @@ bool ShaderData::init() {
 	return initData();
 }
 
+ShaderBufferHandle ShaderData::getHandle(String path) {
+
+	auto it = info.shaderData.find(path.untilFirst("/"));
+
+	if (it == info.shaderData.end() || it->second == nullptr) {
+		Log::warn(String("ShaderData::getHandle(") + path.untilFirst("/") + ") failed; the path couldn't be found");
+		return {};
+	}
+
+	ShaderBuffer *shaderBuffer = it->second->cast<ShaderBuffer>();
+
+	if (shaderBuffer == nullptr) {
+		Log::warn(String("ShaderData::getHandle(") + path.untilFirst("/") + ") failed; the path didn't evaluate to a buffer");
+		return {};
+	}
+
+	return shaderBuffer->getHandle(path.fromFirst("/"));
+}
+
 bool ShaderData::set(String path, GraphicsResource *res) {
 
 	auto it = info.shaderData.find(path);
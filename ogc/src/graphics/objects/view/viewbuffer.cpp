@@ -14,34 +14,32 @@ void ViewBuffer::update() {
 
 	bool updated = false;
 
-	for (u32 i = 0; i < ViewBufferInfo::cameraCount; ++i) {
+	info.cameras.forEachLive([&](u32 i, CameraStruct &c) {
 
-		if (info.cameras.isOccupied(i) && info.updated[getCameraId(i)]) {
-			info.cameras[i].makeView();
+		if (info.updated[getCameraId(i)]) {
+			c.makeView();
 			updated = true;
 		}
 
-	}
+	});
 
-	for (u32 i = 0; i < ViewBufferInfo::frustumCount; ++i) {
+	info.frusta.forEachLive([&](u32 i, CameraFrustumStruct &f) {
 
-		if (info.frusta.isOccupied(i) && info.updated[getFrustumId(i)]) {
-			info.frusta[i].makeProjection();
+		if (info.updated[getFrustumId(i)]) {
+			f.makeProjection();
 			updated = true;
 		}
 
-	}
-
-	for (u32 i = 0; i < ViewBufferInfo::viewCount; ++i) {
+	});
 
-		ViewStruct &v = info.views[i];
+	info.views.forEachLive([&](u32 i, ViewStruct &v) {
 
-		if (info.views.isOccupied(i) && (info.updated[getViewId(i)] || info.updated[getCameraId(v.camera)] || info.updated[getFrustumId(v.frustum)])) {
+		if (info.updated[getViewId(i)] || info.updated[getCameraId(v.camera)] || info.updated[getFrustumId(v.frustum)]) {
 			v.makeViewProjection(this);
 			updated = true;
 		}
 
-	}
+	});
 
 	if (updated) {
 
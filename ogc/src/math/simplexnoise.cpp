@@ -1,6 +1,14 @@
 #include <math.h>
 #include "template/common.h"
 #include "math/simplexnoise.h"
+#include "types/threadpool.h"
+
+#if defined(__AVX2__)
+	#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+	#include <emmintrin.h>
+#endif
+
 using namespace oi;
 
 Grad::Grad(f32 x, f32 y, f32 z, f32 w) : x(x), y(y), z(z), w(w) { }
@@ -522,6 +530,294 @@ f32 SimplexNoise::noise(Vec4 pos, Vec4 offset, u32 octaves, f32 persistence, f32
 	return u / max;
 }
 
+//Bulk 3D noise
+//The kernels follow noise(Vec3) operation for operation, so a lane returns the same value as the single point path
+
+//The permutation tables as i32 (so they can be gathered) and the gradients split per axis
+struct SimplexTables {
+
+	i32 perm[512], permMod12[512];
+	f32 gx[12], gy[12], gz[12];
+	f32 F3, G3;
+
+	SimplexTables(const u8 *p, const u8 *pmod12, const Grad *grad, f32 F3, f32 G3): F3(F3), G3(G3) {
+
+		for (u32 i = 0; i < 512; ++i) {
+			perm[i] = p[i];
+			permMod12[i] = pmod12[i];
+		}
+
+		for (u32 i = 0; i < 12; ++i) {
+			gx[i] = grad[i].x;
+			gy[i] = grad[i].y;
+			gz[i] = grad[i].z;
+		}
+	}
+
+};
+
+#if defined(__AVX2__)
+
+	struct SimplexLanes {
+
+		static constexpr u32 width = 8;
+
+		typedef __m256 F;
+		typedef __m256i I;
+
+		static F load(const f32 *p) { return _mm256_loadu_ps(p); }
+		static void store(f32 *p, F a) { _mm256_storeu_ps(p, a); }
+		static F set(f32 a) { return _mm256_set1_ps(a); }
+		static I seti(i32 a) { return _mm256_set1_epi32(a); }
+
+		static F add(F a, F b) { return _mm256_add_ps(a, b); }
+		static F sub(F a, F b) { return _mm256_sub_ps(a, b); }
+		static F mul(F a, F b) { return _mm256_mul_ps(a, b); }
+		static F max(F a, F b) { return _mm256_max_ps(a, b); }
+
+		static F ge(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+		static F and_(F a, F b) { return _mm256_and_ps(a, b); }
+		static F or_(F a, F b) { return _mm256_or_ps(a, b); }
+		static F andNot(F a, F b) { return _mm256_andnot_ps(a, b); }
+
+		static I addi(I a, I b) { return _mm256_add_epi32(a, b); }
+		static I andi(I a, I b) { return _mm256_and_si256(a, b); }
+		static F tof(I a) { return _mm256_cvtepi32_ps(a); }
+		static I toi(F a) { return _mm256_cvttps_epi32(a); }
+
+		//Truncate and subtract one if that rounded up (the same as fastfloor)
+		static I floor(F a) {
+			I i = _mm256_cvttps_epi32(a);
+			return _mm256_add_epi32(i, _mm256_castps_si256(_mm256_cmp_ps(a, _mm256_cvtepi32_ps(i), _CMP_LT_OQ)));
+		}
+
+		static I gather(const i32 *table, I i) { return _mm256_i32gather_epi32(table, i, 4); }
+		static F gather(const f32 *table, I i) { return _mm256_i32gather_ps(table, i, 4); }
+
+	};
+
+	#define SIMPLEX_LANES
+
+#elif defined(__SSE2__) || defined(_M_X64)
+
+	struct SimplexLanes {
+
+		static constexpr u32 width = 4;
+
+		typedef __m128 F;
+		typedef __m128i I;
+
+		static F load(const f32 *p) { return _mm_loadu_ps(p); }
+		static void store(f32 *p, F a) { _mm_storeu_ps(p, a); }
+		static F set(f32 a) { return _mm_set1_ps(a); }
+		static I seti(i32 a) { return _mm_set1_epi32(a); }
+
+		static F add(F a, F b) { return _mm_add_ps(a, b); }
+		static F sub(F a, F b) { return _mm_sub_ps(a, b); }
+		static F mul(F a, F b) { return _mm_mul_ps(a, b); }
+		static F max(F a, F b) { return _mm_max_ps(a, b); }
+
+		static F ge(F a, F b) { return _mm_cmpge_ps(a, b); }
+		static F and_(F a, F b) { return _mm_and_ps(a, b); }
+		static F or_(F a, F b) { return _mm_or_ps(a, b); }
+		static F andNot(F a, F b) { return _mm_andnot_ps(a, b); }
+
+		static I addi(I a, I b) { return _mm_add_epi32(a, b); }
+		static I andi(I a, I b) { return _mm_and_si128(a, b); }
+		static F tof(I a) { return _mm_cvtepi32_ps(a); }
+		static I toi(F a) { return _mm_cvttps_epi32(a); }
+
+		//Truncate and subtract one if that rounded up (the same as fastfloor)
+		static I floor(F a) {
+			I i = _mm_cvttps_epi32(a);
+			return _mm_add_epi32(i, _mm_castps_si128(_mm_cmplt_ps(a, _mm_cvtepi32_ps(i))));
+		}
+
+		//SSE2 has no gathers; every lane is loaded by itself
+
+		static I gather(const i32 *table, I i) {
+			alignas(16) i32 j[4];
+			_mm_store_si128((I*) j, i);
+			return _mm_setr_epi32(table[j[0]], table[j[1]], table[j[2]], table[j[3]]);
+		}
+
+		static F gather(const f32 *table, I i) {
+			alignas(16) i32 j[4];
+			_mm_store_si128((I*) j, i);
+			return _mm_setr_ps(table[j[0]], table[j[1]], table[j[2]], table[j[3]]);
+		}
+
+	};
+
+	#define SIMPLEX_LANES
+
+#endif
+
+#ifdef SIMPLEX_LANES
+
+	typedef SimplexLanes L;
+
+	//The contribution of one corner; max(t, 0) instead of the branch, since a zero t contributes zero either way
+	static inline L::F simplexCorner(const SimplexTables &tab, L::I gi, L::F x, L::F y, L::F z) {
+
+		L::F t = L::sub(L::sub(L::sub(L::set((f32) 0.6), L::mul(x, x)), L::mul(y, y)), L::mul(z, z));
+		t = L::max(t, L::set(0));
+		t = L::mul(t, t);
+
+		L::F d = L::add(L::add(L::mul(L::gather(tab.gx, gi), x), L::mul(L::gather(tab.gy, gi), y)), L::mul(L::gather(tab.gz, gi), z));
+		return L::mul(L::mul(t, t), d);
+	}
+
+	//The hashed gradient index of the corner at i, j, k (already wrapped to 255) + an offset
+	static inline L::I simplexHash(const SimplexTables &tab, L::I i, L::I j, L::I k, L::I di, L::I dj, L::I dk) {
+		L::I h = L::gather(tab.perm, L::addi(k, dk));
+		h = L::gather(tab.perm, L::addi(L::addi(j, dj), h));
+		return L::gather(tab.permMod12, L::addi(L::addi(i, di), h));
+	}
+
+	//Samples SimplexLanes::width points
+	static inline void simplexKernel(const SimplexTables &tab, const f32 *xp, const f32 *yp, const f32 *zp, f32 *out) {
+
+		L::F xin = L::load(xp), yin = L::load(yp), zin = L::load(zp);
+		L::F one = L::set(1), G3 = L::set(tab.G3);
+
+		//Skew to find the cell and unskew its origin
+
+		L::F s = L::mul(L::add(L::add(xin, yin), zin), L::set(tab.F3));
+		L::I i = L::floor(L::add(xin, s)), j = L::floor(L::add(yin, s)), k = L::floor(L::add(zin, s));
+		L::F t = L::mul(L::tof(L::addi(L::addi(i, j), k)), G3);
+
+		L::F x0 = L::sub(xin, L::sub(L::tof(i), t));
+		L::F y0 = L::sub(yin, L::sub(L::tof(j), t));
+		L::F z0 = L::sub(zin, L::sub(L::tof(k), t));
+
+		//The branches of noise(Vec3) as masks; only one of i1, j1 and k1 is set and k2 is only unset if i2 and j2 are
+
+		L::F xy = L::ge(x0, y0), xz = L::ge(x0, z0), yz = L::ge(y0, z0);
+
+		L::F i1 = L::and_(L::and_(xy, xz), one), j1 = L::and_(L::andNot(xy, yz), one);
+		L::F k1 = L::sub(one, L::add(i1, j1));
+
+		L::F i2 = L::and_(L::or_(xy, xz), one), j2 = L::or_(L::andNot(xy, one), L::and_(yz, one));
+		L::F k2 = L::sub(one, L::mul(i2, j2));
+
+		//Offsets of the other corners
+
+		L::F G3_2 = L::set((f32) 2.0 * tab.G3), G3_3 = L::set((f32) 3.0 * tab.G3);
+
+		L::F x1 = L::add(L::sub(x0, i1), G3), y1 = L::add(L::sub(y0, j1), G3), z1 = L::add(L::sub(z0, k1), G3);
+		L::F x2 = L::add(L::sub(x0, i2), G3_2), y2 = L::add(L::sub(y0, j2), G3_2), z2 = L::add(L::sub(z0, k2), G3_2);
+		L::F x3 = L::add(L::sub(x0, one), G3_3), y3 = L::add(L::sub(y0, one), G3_3), z3 = L::add(L::sub(z0, one), G3_3);
+
+		//Hashed gradients of the corners
+
+		L::I mod = L::seti(255), zero = L::seti(0), onei = L::seti(1);
+		L::I ii = L::andi(i, mod), jj = L::andi(j, mod), kk = L::andi(k, mod);
+
+		L::I gi0 = simplexHash(tab, ii, jj, kk, zero, zero, zero);
+		L::I gi1 = simplexHash(tab, ii, jj, kk, L::toi(i1), L::toi(j1), L::toi(k1));
+		L::I gi2 = simplexHash(tab, ii, jj, kk, L::toi(i2), L::toi(j2), L::toi(k2));
+		L::I gi3 = simplexHash(tab, ii, jj, kk, onei, onei, onei);
+
+		//Add the contributions and scale to [0, 1]
+
+		L::F n = L::add(L::add(L::add(
+			simplexCorner(tab, gi0, x0, y0, z0),
+			simplexCorner(tab, gi1, x1, y1, z1)),
+			simplexCorner(tab, gi2, x2, y2, z2)),
+			simplexCorner(tab, gi3, x3, y3, z3)
+		);
+
+		L::store(out, L::mul(L::add(L::mul(L::set((f32) 32.0), n), one), L::set((f32) 0.5)));
+	}
+
+#endif
+
+void SimplexNoise::noise(const f32 *x, const f32 *y, const f32 *z, f32 *out, u32 count) {
+
+	u32 i = 0;
+
+	#ifdef SIMPLEX_LANES
+
+		static const SimplexTables tables(perm, permMod12, grad3, F3, G3);
+
+		for (; i + L::width <= count; i += L::width)
+			simplexKernel(tables, x + i, y + i, z + i, out + i);
+
+	#endif
+
+	for (; i < count; ++i)
+		out[i] = noise(Vec3(x[i], y[i], z[i]));
+}
+
+//Points are processed in blocks, so the separated x, y and z (and the sum of the octaves) stay in cache
+static constexpr u32 simplexBlock = 256;
+
+void SimplexNoise::noise(const Vec3 *in, f32 *out, u32 count) {
+
+	f32 x[simplexBlock], y[simplexBlock], z[simplexBlock];
+
+	for (u32 i = 0; i < count; i += simplexBlock) {
+
+		u32 n = std::min(count - i, simplexBlock);
+
+		for (u32 j = 0; j < n; ++j) {
+			x[j] = in[i + j].x;
+			y[j] = in[i + j].y;
+			z[j] = in[i + j].z;
+		}
+
+		noise(x, y, z, out + i, n);
+	}
+}
+
+void SimplexNoise::noise(const Vec3 *in, f32 *out, u32 count, Vec3 offset, u32 octaves, f32 persistence, f32 roughness, f32 frequency) {
+
+	f32 x[simplexBlock], y[simplexBlock], z[simplexBlock], sample[simplexBlock], w[simplexBlock];
+
+	for (u32 i = 0; i < count; i += simplexBlock) {
+
+		u32 n = std::min(count - i, simplexBlock);
+
+		f32 amp = 1, max = 0, freq = frequency;
+
+		for (u32 j = 0; j < n; ++j)
+			w[j] = 0;
+
+		for (u32 o = 0; o < octaves; ++o) {
+
+			for (u32 j = 0; j < n; ++j) {
+				Vec3 pos = in[i + j] * freq + offset;
+				x[j] = pos.x;
+				y[j] = pos.y;
+				z[j] = pos.z;
+			}
+
+			noise(x, y, z, sample, n);
+
+			for (u32 j = 0; j < n; ++j)
+				w[j] += (sample[j] + 1) * 0.5f * amp;
+
+			max += amp;
+			amp *= persistence;
+			freq *= roughness;
+		}
+
+		for (u32 j = 0; j < n; ++j)
+			out[i + j] = w[j] / max;
+	}
+}
+
+void SimplexNoise::noiseParallel(const Vec3 *in, f32 *out, u32 count, Vec3 offset, u32 octaves, f32 persistence, f32 roughness, f32 frequency) {
+
+	static constexpr u32 chunk = simplexBlock * 16;
+
+	ThreadPool::get().parallelFor(0, (count + chunk - 1) / chunk, 1, [&](u32 i) {
+		u32 begin = i * chunk;
+		noise(in + begin, out + begin, std::min(count - begin, chunk), offset, octaves, persistence, roughness, frequency);
+	});
+}
+
 i32 SimplexNoise::fastfloor(f32 x) {
 	i32 xi = (i32)x;
 	return x < xi ? xi - 1 : xi;
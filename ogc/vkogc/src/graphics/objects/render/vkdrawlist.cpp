@@ -8,50 +8,45 @@ using namespace oi;
 
 void DrawList::prepareDrawList() {
 
+	//The commands are written straight into the GPUBuffer's CPU copy (without a temporary array); only the written range gets pushed to the GPU
+	//Not into the mapped memory, because the CBO has a version per frame in flight and GPUBuffer::push copies into the version of the current frame
+
 	if (info.meshBuffer->getInfo().maxIndices == 0) {
 
-		VkDrawIndirectCommand *drawCmd = new VkDrawIndirectCommand[getBatches()];
-		VkDrawIndirectCommand *ptr = drawCmd;
-		
-		u32 instanceOffset = 0;
+		VkDrawIndirectCommand *ptr = (VkDrawIndirectCommand*) info.drawBuffer->getAddress();
+
+		for (const DrawCall &it : info.objects) {
 
-		for (auto it : info.objects) {
+			const MeshAllocation &allocation = it.mesh->getInfo().allocation;
 
-			ptr->firstInstance = instanceOffset;
-			ptr->instanceCount = it.second;
-			ptr->firstVertex = it.first->getInfo().allocation.baseVertex;
-			ptr->vertexCount = it.first->getInfo().allocation.vertices;
+			ptr->firstInstance = it.firstInstance;
+			ptr->instanceCount = it.instances;
+			ptr->firstVertex = allocation.baseVertex;
+			ptr->vertexCount = allocation.vertices;
 
-			instanceOffset += ptr->instanceCount;
 			++ptr;
 		}
 
-		info.drawBuffer->set(Buffer::construct((u8*) drawCmd, (u32) sizeof(VkDrawIndirectCommand) * getBatches()));
-
-		delete[] drawCmd;
+		info.drawBuffer->flush(Vec2u(0, (u32) sizeof(VkDrawIndirectCommand) * getBatches()));
 
 	} else {
 
-		VkDrawIndexedIndirectCommand *drawCmd = new VkDrawIndexedIndirectCommand[getBatches()];
-		VkDrawIndexedIndirectCommand *ptr = drawCmd;
+		VkDrawIndexedIndirectCommand *ptr = (VkDrawIndexedIndirectCommand*) info.drawBuffer->getAddress();
 
-		u32 instanceOffset = 0;
+		for (const DrawCall &it : info.objects) {
 
-		for (auto it : info.objects) {
+			MeshLod lod = it.mesh->getLod(0);
 
-			ptr->firstInstance = instanceOffset;
-			ptr->instanceCount = it.second;
-			ptr->vertexOffset = it.first->getInfo().allocation.baseVertex;
-			ptr->firstIndex = it.first->getInfo().allocation.baseIndex;
-			ptr->indexCount = it.first->getInfo().allocation.indices;
+			ptr->firstInstance = it.firstInstance;
+			ptr->instanceCount = it.instances;
+			ptr->vertexOffset = it.mesh->getInfo().allocation.baseVertex;
+			ptr->firstIndex = lod.baseIndex;
+			ptr->indexCount = lod.indices;
 
-			instanceOffset += ptr->instanceCount;
 			++ptr;
 		}
 
-		info.drawBuffer->set(Buffer::construct((u8*)drawCmd, (u32) sizeof(VkDrawIndexedIndirectCommand) * getBatches()));
-
-		delete[] drawCmd;
+		info.drawBuffer->flush(Vec2u(0, (u32) sizeof(VkDrawIndexedIndirectCommand) * getBatches()));
 
 	}
 
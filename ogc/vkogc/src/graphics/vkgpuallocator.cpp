@@ -99,7 +99,7 @@ GPUMemoryBlockExt *GraphicsExt::alloc(const std::tuple<VkMemoryPropertyFlagBits,
 		memoryBlocks.push_back(block);
 		allocation = block->allocator.alloc((u32)requirements1.size);
 		offset = 0;
-		Log::println(String("Allocated dedicated memory for resource: ") + resourceName + " (" + allocation.size + " bytes mapped at " + String((void*)mapped.addr()) + ")");
+		Log::format("Allocated dedicated memory for resource: {} ({} bytes mapped at {})", resourceName, allocation.size, String((void*)mapped.addr()));
 		return block;
 	}
 
@@ -159,7 +159,7 @@ GPUMemoryBlockExt *GraphicsExt::alloc(const std::tuple<VkMemoryPropertyFlagBits,
 		memoryBlocks.push_back(block);
 		allocation = block->allocator.alloc((u32)requirements1.size);
 		offset = 0;
-		Log::println(String("Allocated memory for resource: ") + resourceName + " (" + allocation.size + " bytes / " + size + " chunk size mapped at " + String((void*)mapped.addr()) + ")");
+		Log::format("Allocated memory for resource: {} ({} bytes / {} chunk size mapped at {})", resourceName, allocation.size, size, String((void*)mapped.addr()));
 		return block;
 	}
 
@@ -173,13 +173,13 @@ GPUMemoryBlockExt *GraphicsExt::alloc(const std::tuple<VkMemoryPropertyFlagBits,
 	if (mappedMemory.size() != 0)
 		mapped = mappedMemory.subbuffer(offset, (u32)requirements1.size);
 
-	Log::println(String("Allocated memory for resource: ") + resourceName + " (" + allocation.size + " bytes at " + offset + " mapped at " + String((void*)mapped.addr()) + ")");
+	Log::format("Allocated memory for resource: {} ({} bytes at {} mapped at {})", resourceName, allocation.size, offset, String((void*)mapped.addr()));
 	return memoryBlocks[it - memoryBlocks.begin()];
 }
 
 void GraphicsExt::dealloc(GPUMemoryBlockExt *block, BlockAllocation allocation) {
 
-	Log::println(String("Freeing object at offset ") + allocation.start + " with " + allocation.size + " bytes");
+	Log::format("Freeing object at offset {} with {} bytes", allocation.start, allocation.size);
 
 	if (block->free(allocation)) {
 
@@ -187,7 +187,7 @@ void GraphicsExt::dealloc(GPUMemoryBlockExt *block, BlockAllocation allocation)
 
 		if (it != memoryBlocks.end()) {
 			memoryBlocks.erase(it);
-			Log::println(String("Freeing memory block; ") + block->allocator.size() + " bytes");
+			Log::format("Freeing memory block; {} bytes", block->allocator.size());
 			delete block;
 		}
 
@@ -251,7 +251,7 @@ void GraphicsExt::dealloc(GPUBufferExt &ext, String name) {
 		GPUAllocationExt &balloc = ext.allocations[i];
 		GPUMemoryBlockExt *memoryBlock = balloc.block;
 
-		Log::println(String("Deallocated ") + name + " #" + i + " at " + balloc.allocation.start + " with size " + balloc.allocation.size);
+		Log::format("Deallocated {} #{} at {} with size {}", name, i, balloc.allocation.start, balloc.allocation.size);
 
 		if (memoryBlock->free(balloc.allocation)) {
 			delete memoryBlock;
@@ -301,7 +301,7 @@ void GraphicsExt::dealloc(TextureExt &ext, String name) {
 	VkImage image = ext.resource;
 	vkDestroyImage(device, image, vkAllocator);
 
-	Log::println(String("Deallocated ") + name + " at " + balloc.allocation.start + " with size " + balloc.allocation.size);
+	Log::format("Deallocated {} at {} with size {}", name, balloc.allocation.start, balloc.allocation.size);
 
 	if (memoryBlock->free(balloc.allocation)) {
 		delete memoryBlock;
@@ -624,16 +624,7 @@ void Graphics::initSurface(Window *w) {
 			TextureExt &vkTex = tex->getExtension();
 			vkTex.resource = swapchainImages[i];
 
-			u32 id = maxId + 1;
-
-			for (u32 j = 0; j < maxId; ++j)
-				if (!idAllocator[j]) {
-					id = j;
-					idAllocator[j] = true;
-					break;
-				}
-
-			tex->id = id;
+			tex->id = allocId();
 			tex->g = this;
 			tex->name = String("Swapchain image ") + i;
 			tex->setHash<Texture>();
@@ -665,16 +656,7 @@ void Graphics::initSurface(Window *w) {
 
 		//Register into graphics objects
 
-		u32 id = maxId + 1;
-
-		for (u32 i = 0; i < maxId; ++i)
-			if (!idAllocator[i]) {
-				id = i;
-				idAllocator[i] = true;
-				break;
-			}
-
-		backBuffer->id = id;
+		backBuffer->id = allocId();
 		backBuffer->g = this;
 		backBuffer->setHash<RenderTarget>();
 		backBuffer->name = "Swapchain";
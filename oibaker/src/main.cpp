@@ -1,12 +1,240 @@
 #include "file/filemanager.h"
+#include "utils/timer.h"
+#include "graphics/format/fbx.h"
+#include "graphics/format/meshoptimizer.h"
+#include "graphics/format/oirm.h"
 #include "graphics/helper/bakemanager.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
 using namespace oi::gc;
 using namespace oi::wc;
 using namespace oi;
 
+//Counts the heap allocations of oibaker; used by -string_benchmark
+
+static std::atomic<u64> allocations(0);
+
+void *operator new(size_t size) {
+
+	++allocations;
+
+	if (void *ptr = malloc(size == 0 ? 1 : size))
+		return ptr;
+
+	throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept { free(ptr); }
+void operator delete(void *ptr, size_t) noexcept { free(ptr); }
+
+//Bakes all fbx models (without writing them) and reports the throughput
+int benchmark() {
+
+	u64 totalIn = 0, totalOut = 0;
+	f32 totalTime = 0;
+
+	FileManager::get()->foreachFile("mod/models", [&](const FileInfo &fi) -> bool {
+
+		if (fi.isFolder || !fi.name.endsWithIgnoreCase(".fbx"))
+			return false;
+
+		Buffer buf;
+
+		if (!FileManager::get()->read(fi.name, buf))
+			return false;
+
+		Timer t;
+		auto res = Fbx::convertMeshes(buf, true);
+		f32 duration = t.getDuration();
+
+		u64 out = 0;
+
+		for (auto &elem : res) {
+			out += elem.second.size();
+			elem.second.deconstruct();
+		}
+
+		Log::println(fi.name.replaceFirst("mod/", "res/") + ": " + buf.size() + " -> " + u32(out) + " bytes in " + duration + "s (" + f32(buf.size() / duration) + " bytes/s)");
+
+		totalIn += buf.size();
+		totalOut += out;
+		totalTime += duration;
+
+		buf.deconstruct();
+		return false;
+	});
+
+	if (totalTime != 0)
+		Log::println(String("Total: ") + u32(totalIn) + " -> " + u32(totalOut) + " bytes in " + totalTime + "s (" + f32(totalIn / totalTime) + " bytes/s)");
+
+	return 0;
+}
+
+//Writes a mesh with meshlets and reads it back (with and without compression)
+//The meshlet header is cleared first, because oiRM::convert(MeshInfo) doesn't know the limits the meshlets were built with
+bool testMeshletRoundTrip() {
+
+	constexpr u32 side = 16, vertices = side * side, indices = (side - 1) * (side - 1) * 6;
+
+	std::vector<Vec3> positions(vertices);
+	std::vector<u32> ibo;
+	ibo.reserve(indices);
+
+	for (u32 y = 0; y < side; ++y)
+		for (u32 x = 0; x < side; ++x)
+			positions[y * side + x] = Vec3(f32(x), f32(y), f32((x * y) % 3));
+
+	for (u32 y = 0; y + 1 < side; ++y)
+		for (u32 x = 0; x + 1 < side; ++x) {
+			u32 i = y * side + x;
+			ibo.insert(ibo.end(), { i, i + side, i + 1, i + 1, i + side, i + side + 1 });
+		}
+
+	RMFile file = oiRM::generate(Buffer::construct((u8*) positions.data(), vertices * (u32) sizeof(Vec3)), Buffer::construct((u8*) ibo.data(), indices * 4), true, false, false, vertices, indices);
+
+	if (file.meshlets.size() == 0)
+		return Log::error("Self test failed; no meshlets were generated");
+
+	for (bool compression : { false, true }) {
+
+		RMFile copy = file;
+		copy.meshletHeader = {};
+
+		Buffer buf = oiRM::write(copy, compression);
+		RMFile result;
+
+		bool equal = buf.size() != 0 && oiRM::read(buf, result) && result.meshlets.size() == file.meshlets.size() &&
+			result.meshletVertices == file.meshletVertices && result.meshletTriangles == file.meshletTriangles;
+
+		buf.deconstruct();
+
+		if (!equal)
+			return Log::error(String("Self test failed; meshlets didn't survive an oiRM round trip") + (compression ? " (compressed)" : ""));
+	}
+
+	return true;
+}
+
+//String behavior that changed when String moved onto StringView
+bool testString() {
+
+	bool success =
+		String(" \t\r\n").trim() == "" &&							//Whitespace only trims to nothing
+		String("a::b::c").fromFirst("::") == "b::c" &&					//The whole separator is skipped
+		String("a::b::c").fromLast("::") == "c" &&
+		String("ab").replaceFirst("x", "y") == "ab" &&					//Nothing is appended if there's no match
+		String("1e").toFloat() == 1 && String("9e +1").toFloat() == 9 &&	//The numeric prefix is parsed
+		String("x").toFloat() == 0 &&
+		!String("").isFloat() && !String(" \t").isVector() && !String(",\t").isVector() &&
+		String("1, 2,3").getVectorLength() == 3;
+
+	return success || Log::error("Self test failed; String doesn't behave as expected");
+}
+
+//Checks that aren't worth baking every file for; returns 0 if they all passed
+int selfTest() {
+
+	bool success = testString();
+	success = testMeshletRoundTrip() && success;
+
+	Log::println(success ? "Self test passed" : "Self test failed");
+	return success ? 0 : 1;
+}
+
+//Counts the allocations and time of common String calls (like the parsers make them) on strings that are already in memory
+int stringBenchmark() {
+
+	const std::vector<String> inputs = {
+		"objects/0/transform/position", "1.2345e-3", "0.5, 0.25, 1", "textures/diffuse.png",
+		"value_with_a_long_name = 12345", "  padded text that's longer than sso  "
+	};
+
+	constexpr u32 calls = 200000;
+	u64 sink = 0;
+
+	//Queries shouldn't have to allocate
+
+	u64 start = allocations;
+	Timer t;
+
+	for (u32 i = 0; i < calls; ++i) {
+		const String &str = inputs[i % inputs.size()];
+		sink += str.isFloat() + str.isVector() + str.count('/') + u64(str.toFloat()) + str.contains("long") + str.endsWith("position") + str.equalsIgnoreCase("TEXTURES/diffuse.png") + str.containsIgnoreCase("LONG");
+	}
+
+	f32 queryTime = t.getDuration();
+	u64 queryAllocations = allocations - start;
+
+	//Calls that return new strings only allocate their results
+
+	start = allocations;
+	t.reset();
+
+	for (u32 i = 0; i < calls; ++i) {
+		const String &str = inputs[i % inputs.size()];
+		sink += str.replace("/", "::").size() + str.trim().size() + str.fromLast("/").size() + str.split("/").size();
+	}
+
+	f32 copyTime = t.getDuration();
+	u64 copyAllocations = allocations - start;
+
+	Log::format("Queries: {} allocations per call in {}s", f64(queryAllocations) / calls, queryTime);
+	Log::format("Copies: {} allocations per call in {}s ({})", f64(copyAllocations) / calls, copyTime, sink);
+	return 0;
+}
+
 int main(int argc, char *argv[]) {
-	bool stripDebug = argc >= 2 && String(argv[1]) == "-strip_debug_info";
+
+	bool stripDebug = false, bench = false, test = false, stringBench = false;
+
+	for (int i = 1; i < argc; ++i)
+		if (String(argv[i]) == "-strip_debug_info")
+			stripDebug = true;
+		else if (String(argv[i]) == "-benchmark")
+			bench = true;
+		else if (String(argv[i]) == "-self_test")
+			test = true;
+		else if (String(argv[i]) == "-string_benchmark")
+			stringBench = true;
+		else if (String(argv[i]) == "-mesh_stats")
+			MeshOptimizer::setReporting(true);
+		else if (String(argv[i]).startsWith("-lod_errors=")) {
+
+			std::vector<f32> errors;
+
+			for (String error : String(argv[i]).fromFirst("=").split(","))
+				if (error != "")
+					errors.push_back(error.toFloat());
+
+			MeshOptimizer::setLodErrors(errors);
+		}
+		else if (String(argv[i]).startsWith("-block_compression=")) {
+
+			String codec = String(argv[i]).fromFirst("=");
+			bool found = false;
+
+			for (u32 j = 0; j < CompressionCodec::length; ++j)
+				if (CompressionCodec::getNames()[j].equalsIgnoreCase(codec)) {
+					oiRM::setBlockCompression(CompressionCodec(j));
+					found = true;
+				}
+
+			if (!found)
+				Log::warn(String("Unknown block compression codec \"") + codec + "\"; expected none, lz4 or zlib");
+		}
+
 	FileManager fm(nullptr);
+
+	if (bench)
+		return benchmark();
+
+	if (test)
+		return selfTest();
+
+	if (stringBench)
+		return stringBenchmark();
+
 	BakeManager manager(stripDebug);
 	return manager.run();
-}
\ No newline at end of file
+}
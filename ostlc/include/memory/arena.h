@@ -0,0 +1,72 @@
+#pragma once
+#include <new>
+#include <cstddef>
+#include <utility>
+#include <type_traits>
+#include <vector>
+#include "types/generic.h"
+
+namespace oi {
+
+	//Bump allocator; allocations are taken from big blocks and are only freed all at once (clear or destruction)
+	//Objects created through create<T> that aren't trivially destructible are destructed (in reverse order) when the arena is cleared
+	class Arena {
+
+	public:
+
+		Arena(u32 blockSize = 64 * 1024);
+		~Arena();
+
+		Arena(const Arena&) = delete;
+		Arena &operator=(const Arena&) = delete;
+
+		//Returns uninitialized memory aligned to alignment (power of two)
+		u8 *alloc(size_t size, size_t alignment = alignof(std::max_align_t));
+
+		template<typename T, typename ...args>
+		T *create(args&&... arg);
+
+		//Returns an uninitialized T[count]; T has to be trivially destructible
+		template<typename T>
+		T *allocArray(size_t count);
+
+		//Destructs all objects and frees all blocks
+		void clear();
+
+		//Bytes handed out (excluding padding and unused space in blocks)
+		size_t getAllocated() const;
+
+	private:
+
+		struct Destructor {
+			void *ptr;
+			void (*destroy)(void*);
+		};
+
+		std::vector<u8*> blocks;
+		std::vector<Destructor> destructors;
+
+		u8 *current = nullptr, *end = nullptr;
+		size_t allocated = 0;
+		u32 blockSize;
+
+	};
+
+	template<typename T, typename ...args>
+	T *Arena::create(args&&... arg) {
+
+		T *t = new (alloc(sizeof(T), alignof(T))) T(std::forward<args>(arg)...);
+
+		if constexpr (!std::is_trivially_destructible<T>::value)
+			destructors.push_back({ t, [](void *ptr) { ((T*) ptr)->~T(); } });
+
+		return t;
+	}
+
+	template<typename T>
+	T *Arena::allocArray(size_t count) {
+		static_assert(std::is_trivially_destructible<T>::value, "Arena::allocArray requires a trivially destructible type");
+		return count == 0 ? nullptr : (T*) alloc(sizeof(T) * count, alignof(T));
+	}
+
+}
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "types/generic.h"
 #include "types/buffer.h"
+#include <map>
 
 namespace oi {
 
@@ -15,10 +16,16 @@ namespace oi {
 	};
 
 	//Virtual block allocator; handles object allocation, not memory per se
+	//Free blocks are stored in a two-level segregated fit (TLSF) free list;
+	//a first level bitmap per power of two and a second level bitmap that splits that range into slCount bins.
+	//Finding a fitting block is therefore two bit scans and merging neighbours is a hash lookup.
+	//Live allocations are stored in an address ordered index
 	class VirtualBlockAllocator {
 
 	public:
 
+		static constexpr u32 slLog2 = 4, slCount = 1U << slLog2, flCount = 32;
+
 		VirtualBlockAllocator(u32 length);
 
 		BlockAllocation alloc(u32 length);
@@ -34,10 +41,38 @@ namespace oi {
 
 	protected:
 
-		std::vector<BlockAllocation> blocks, allocations;
+		//Node in the free list of a bin
+		struct FreeBlock {
+			BlockAllocation block;
+			u32 prev, next;
+		};
+
+		static constexpr u32 nullNode = u32_MAX;
+
+		std::vector<FreeBlock> freeBlocks;
+		std::vector<u32> unusedNodes;
+
+		std::unordered_map<u32, u32> freeByStart, freeByEnd;
+		std::map<u32, u32> allocations;
+
+		u32 flBitmap = 0;
+		u32 slBitmap[flCount] = {};
+		u32 bins[flCount][slCount];
 
 		void merge(BlockAllocation allocation);
 
+		void insert(BlockAllocation block);
+		void remove(u32 node);
+
+		//Find a free block that can hold length elements starting at an alignment boundary
+		u32 find(u32 length, u32 alignment) const;
+
+		//Find the first non-empty bin at or after fl, sl
+		bool findBin(u32 &fl, u32 &sl) const;
+
+		static void mapping(u32 size, u32 &fl, u32 &sl);
+		static u64 alignUp(u32 start, u32 alignment);
+
 	private:
 
 		u32 length;
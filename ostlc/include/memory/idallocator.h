@@ -0,0 +1,50 @@
+#pragma once
+
+#include "types/generic.h"
+
+namespace oi {
+
+	//Hands out ids; an id is an index (lower 24 bits) with a generation (upper 8 bits)
+	//Free indices are stored in a hierarchical bitmap (64-ary), so finding the lowest free index is a count trailing zeros per level
+	//The generation of an index is increased when it is freed, so ids that point to a destroyed object can be detected
+	class IdAllocator {
+
+	public:
+
+		static constexpr u32 indexBits = 24, indexMask = (1U << indexBits) - 1U, maxIndices = 1U << indexBits;
+		static constexpr u32 invalidId = u32_MAX;
+
+		IdAllocator(u32 count);
+
+		//Returns the id of the lowest free index or invalidId if there's no space left
+		u32 alloc();
+
+		//Frees the index of an id; returns false if the id isn't allocated (or stale)
+		bool dealloc(u32 id);
+
+		//Mark an index as used; so it will never be returned by alloc
+		bool reserve(u32 index);
+
+		//If the id is allocated and isn't stale
+		bool contains(u32 id) const;
+
+		static u32 getIndex(u32 id) { return id & indexMask; }
+		static u32 getGeneration(u32 id) { return id >> indexBits; }
+
+		u32 size() const;
+		u32 getAllocations() const;
+
+	private:
+
+		//levels[0] has a bit per index (1 = free), levels[i] has a bit per word of levels[i - 1] (1 = has a free index)
+		std::vector<std::vector<u64>> levels;
+		std::vector<u8> generations;
+
+		u32 count, allocations = 0;
+
+		bool isFree(u32 index) const;
+		void take(u32 index);
+
+	};
+
+}
\ No newline at end of file
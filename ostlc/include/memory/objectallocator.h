@@ -1,11 +1,14 @@
 #pragma once
 #include "types/bitset.h"
+#include "memory/occupancymask.h"
 
 namespace oi {
 
 	//Dynamic ObjectAllocator
 
-	//Similar to T[] with Bitset
+	//Similar to T[] with an OccupancyMask
+	//Objects are stored in pages of 'size' objects; a growable allocator adds a page when it's full
+	//Pages are never moved, so pointers to objects stay valid
 	template<typename T>
 	class ObjectAllocator {
 
@@ -14,19 +17,21 @@ namespace oi {
 		static constexpr u32 objSize = (u32) sizeof(T);
 
 		//ObjectAllocator handles allocation
-		ObjectAllocator(u32 size): occ(size), buf(size * objSize) {
-			for (u32 i = 0; i < size; ++i)
-				::new (buf.addr() + i * objSize) T();
+		ObjectAllocator(u32 size, bool growable = false): occ(size), pageSize(size), growable(growable && size != 0) {
+			addPage();
 		}
 
 		//ObjectAllocator doesn't handle allocation
-		ObjectAllocator(u32 size, Buffer buf) : buf(buf), occ(size) { 
+		ObjectAllocator(u32 size, Buffer buf) : occ(size), pageSize(size), owned(false) { 
+
 			if (buf.size() != size * objSize) 
 				Log::throwError<ObjectAllocator, 0x0>("ObjectAllocator buffer should match size * sizeof(T)"); 
+
+			pages.push_back(buf);
 		}
 
 		~ObjectAllocator() {
-			if (owned) buf.deconstruct();
+			clear();
 		}
 
 		ObjectAllocator(const ObjectAllocator &other) {
@@ -34,112 +39,160 @@ namespace oi {
 		}
 
 		ObjectAllocator &operator=(const ObjectAllocator &other) {
-			copy(other);
+
+			if (this != &other) {
+				clear();
+				copy(other);
+			}
+
 			return *this;
 		}
 
 		bool isOccupied(u32 i) const {
-			return i > occ.getBits() || occ[i];
+			return occ.isOccupied(i);
 		}
 
 		T &operator[](u32 i) {
-			return buf.operator[]<T>(i * objSize);
+			return i < pageSize ? pages[0].operator[]<T>(i * objSize) : pages[i / pageSize].operator[]<T>(i % pageSize * objSize);
 		}
 
 		const T &operator[](u32 i) const {
-			return buf.operator[]<T>(i * objSize);
+			return i < pageSize ? pages[0].operator[]<T>(i * objSize) : pages[i / pageSize].operator[]<T>(i % pageSize * objSize);
 		}
 
+		//Returns size() if it's full (and can't grow)
 		u32 allocate(const T &t) {
 
-			u32 j = occ.getBits();
+			u32 i = occ.findFree();
+
+			if (i == occ.size()) {
 
-			for (u32 i = 0; i < j; ++i)
-				if (!occ[i]) {
-					buf.operator[]<T>(i * objSize) = t;
-					occ[i] = true;
+				if (!growable)
 					return i;
-				}
 
-			return j;
+				addPage();
+			}
+
+			operator[](i) = t;
+			occ.set(i, true);
+			return i;
 		}
 
+		//Returns the end of the first page if it's full (and can't grow)
 		T *alloc(const T &t) {
 
-			u32 j = occ.getBits();
+			u32 i = allocate(t);
 
-			for (u32 i = 0; i < j; ++i)
-				if (!occ[i]) {
-					buf.operator[]<T>(i * objSize) = t;
-					occ[i] = true;
-					j = i;
-					break;
-				}
-
-			return (T*)(buf.addr() + j * objSize);
+			if (i == occ.size())
+				return (T*)(pages[0].addr() + pageSize * objSize);
 
+			return &operator[](i);
 		}
 
 		bool deallocate(u32 i) {
 
-			if (i >= occ.getBits() || !occ[i])
+			if (i >= occ.size() || !occ.isOccupied(i))
 				return Log::error("Invalid dealloc; out of range or not allocated");
 
-			occ[i] = false;
-			buf.operator[]<T>(i * objSize).~T();
+			//Free slots keep a default object
+			T &t = operator[](i);
+			t.~T();
+			::new (&t) T();
+
+			occ.set(i, false);
 			return true;
 		}
 
 		bool dealloc(T *t) {
 
-			if (t < (T*)buf.addr() || t >= (T*)(buf.addr() + buf.size()))
-				return Log::error("Invalid dealloc; out of range or not allocated");
+			u32 i = find(t);
 
-			u32 i = u32(t - (T*)buf.addr());
+			if (i == occ.size())
+				return false;
 
-			occ[i] = false;
-			buf.operator[]<T>(i * objSize).~T();
-			return true;
+			return deallocate(i);
 		}
 
-		Buffer getBuffer() { return buf; }
+		//Call f(u32 i, T &t) for every allocated object; 64 slots are skipped at once if they're empty
+		template<typename F>
+		void forEachLive(F f) {
+			occ.forEachOccupied([this, &f](u32 i) { f(i, operator[](i)); });
+		}
+
+		//The first page; this is every object if the allocator can't grow
+		Buffer getBuffer() { return pages.size() == 0 ? Buffer() : pages[0]; }
 
 		u32 find(T *t) {
 
-			if (t < (T*)buf.addr() || t >= (T*)(buf.addr() + buf.size())) {
-				Log::error("Invalid find; out of range or not allocated");
-				return occ.getBits();
-			}
+			for (u32 i = 0, j = (u32) pages.size(); i < j; ++i)
+				if (t >= (T*)pages[i].addr() && t < (T*)(pages[i].addr() + pages[i].size()))
+					return i * pageSize + u32(t - (T*)pages[i].addr());
 
-			return u32(t - (T*)buf.addr());
+			Log::error("Invalid find; out of range or not allocated");
+			return occ.size();
 
 		}
 
+		u32 size() const { return occ.size(); }
+		u32 getAllocations() const { return occ.getAllocations(); }
+
 	protected:
 
+		void addPage() {
+
+			Buffer page(pageSize * objSize);
+
+			for (u32 i = 0; i < pageSize; ++i)
+				::new (page.addr() + i * objSize) T();
+
+			if (pages.size() != 0)
+				occ.grow(pageSize);
+
+			pages.push_back(page);
+		}
+
+		void clear() {
+
+			if (owned)
+				for (Buffer &page : pages) {
+
+					for (u32 i = 0; i < pageSize; ++i)
+						page.operator[]<T>(i * objSize).~T();
+
+					page.deconstruct();
+				}
+
+			pages.clear();
+		}
+
 		void copy(const ObjectAllocator &other) {
 
 			occ = other.occ;
+			pageSize = other.pageSize;
+			growable = other.growable;
 
 			if ((owned = other.owned)) {
 
-				buf = Buffer(other.buf.size());
+				pages.resize(other.pages.size());
+
+				for (u32 j = 0; j < (u32) pages.size(); ++j) {
 
-				for (u32 i = 0, j = other.occ.getBits(); i < j; ++i)
-					if (occ[i])
-						::new (buf.addr() + i * objSize) T(other.buf.template operator[]<T>(i * objSize));
-					else
-						::new (buf.addr() + i * objSize) T();
+					pages[j] = Buffer(pageSize * objSize);
+
+					for (u32 i = 0; i < pageSize; ++i)
+						::new (pages[j].addr() + i * objSize) T(other.pages[j].template operator[]<T>(i * objSize));
+				}
 
 			} else
-				buf = other.buf;
+				pages = other.pages;
 		}
 
 	private:
 
-		Buffer buf;
-		Bitset occ;
-		bool owned = true;
+		std::vector<Buffer> pages;
+		OccupancyMask occ;
+		u32 pageSize;
+		bool owned = true, growable = false;
 
 	};
 
@@ -170,7 +223,7 @@ namespace oi {
 		}
 
 		bool isOccupied(u32 i) const {
-			return i > n || occ[i];
+			return i >= n || occ[i];
 		}
 
 		T &operator[](u32 i) {
@@ -183,30 +236,18 @@ namespace oi {
 
 		u32 allocate(const T &t) {
 
-			for (u32 i = 0; i < n; ++i)
-				if (!occ[i]) {
-					data[i] = t;
-					occ[i] = true;
-					return i;
-				}
+			u32 i = occ.findFirstUnset();
+
+			if (i != n) {
+				data[i] = t;
+				occ[i] = true;
+			}
 
-			return n;
+			return i;
 		}
 
 		T *alloc(const T &t) {
-
-			u32 j = n;
-
-			for (u32 i = 0; i < n; ++i)
-				if (!occ[i]) {
-					data[i] = t;
-					occ[i] = true;
-					j = i;
-					break;
-				}
-
-			return data + j;
-
+			return data + allocate(t);
 		}
 
 		bool deallocate(u32 i) {
@@ -231,6 +272,12 @@ namespace oi {
 			return true;
 		}
 
+		//Call f(u32 i, T &t) for every allocated object; 64 slots are skipped at once if they're empty
+		template<typename F>
+		void forEachLive(F f) {
+			occ.forEachSetBit([this, &f](u32 i) { f(i, data[i]); });
+		}
+
 		u32 find(T *t){
 
 			if (t < data || t >= data + n) {
@@ -0,0 +1,55 @@
+#pragma once
+#include "utils/binaryhelper.h"
+
+namespace oi {
+
+	//Keeps track of which slots are in use; a bit per slot (1 = occupied)
+	//Every word of 64 slots has a bit in a summary (1 = has a free slot), so finding a free slot checks one bit per 4096 slots
+	class OccupancyMask {
+
+	public:
+
+		OccupancyMask(u32 size = 0);
+
+		//Add free slots at the end
+		void grow(u32 size);
+
+		//Lowest free slot; size() if there is none
+		u32 findFree() const;
+
+		bool isOccupied(u32 i) const;
+		void set(u32 i, bool occupied);
+
+		u32 size() const;
+		u32 getAllocations() const;
+
+		//Call f(u32 i) for every occupied slot (in order); empty words are skipped
+		template<typename T>
+		void forEachOccupied(T f) const;
+
+	private:
+
+		std::vector<u64> slots, summary;
+		u32 count = 0, allocations = 0;
+
+		void updateSummary(u32 word);
+
+	};
+
+	template<typename T>
+	void OccupancyMask::forEachOccupied(T f) const {
+
+		for (u32 i = 0, j = (u32) slots.size(); i < j; ++i) {
+
+			u64 word = slots[i];
+
+			//Slots past the end are marked as occupied
+			if (i == j - 1 && count % 64 != 0)
+				word &= (1ULL << (count % 64)) - 1;
+
+			for (; word != 0; word &= word - 1)
+				f(i * 64 + BinaryHelper::lsb(word));
+		}
+	}
+
+}
\ No newline at end of file
@@ -107,22 +107,22 @@ namespace oi {
 		static const std::vector<oi::String> initNames() {											\
 																									\
 			std::vector<oi::String> res;															\
-			std::vector<oi::String> arr = getArgs().split("=");										\
+			oi::StringView args = getArgs();														\
 																									\
-			u32 i = 0;																				\
-			for (oi::String &temp : arr) {															\
+			/* The name starts after the last ',' or '('; if there's none, npos + 1 wraps around to 0 */\
+			u32 i = 0, names = args.count('=');														\
 																									\
-				if (i == 0){																		\
-					std::vector<oi::String> csplit2 = temp.split("(");								\
-					res.push_back(csplit2[csplit2.size() - 1]);										\
-				}																					\
-				else if (i < arr.size() - 1) {														\
-					std::vector<oi::String> csplit = temp.split(",");								\
-					oi::String almostCorrect = csplit[csplit.size() - 1];							\
-					std::vector<oi::String> csplit2 = almostCorrect.split("(");						\
-					res.push_back(csplit2[csplit2.size() - 1]);										\
+			for (oi::StringView part : args.split("=")) {											\
+																									\
+				if (i != 0) {																		\
+																									\
+					if (i == names)																	\
+						break;																		\
+																									\
+					part = part.cutBegin(part.findLast(',') + 1);									\
 				}																					\
 																									\
+				res.push_back(part.cutBegin(part.findLast('(') + 1).toString());					\
 				++i;																				\
 			}																						\
 																									\
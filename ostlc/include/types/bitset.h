@@ -94,13 +94,33 @@ namespace oi {
 
 		Bitset operator~() const;
 
+		//Pack/unpack values with a fixed number of bits (MSB first); bits has to be values.size() * bitsPerVal
 		void write(const std::vector<u32> &values, u32 bitsPerVal);
-		void read(std::vector<u32> &values, u32 bitsPerVal);
+		void read(std::vector<u32> &values, u32 bitsPerVal) const;
 
 		u8 &at(u32 bit);
 
 		void clear(bool value = false);
 
+		//Number of set bits
+		u32 count() const;
+
+		//Index of the first (un)set bit at or after 'from'; getBits() if there is none
+		u32 findFirstSet(u32 from = 0) const;
+		u32 findFirstUnset(u32 from = 0) const;
+
+		//Call f(u32 bit) for every set bit (in order)
+		template<typename T>
+		void forEachSetBit(T f) const;
+
+		//Bits [i * 64, i * 64 + 64) as a word; the first bit is the MSB and bits past the end are 0
+		//The raw versions are shared with StaticBitset
+		u64 getWord(u32 i) const { return getWord(data, bits, i); }
+
+		static u64 getWord(const u8 *data, u32 bits, u32 i);
+		static u32 count(const u8 *data, u32 bits);
+		static u32 findFirst(const u8 *data, u32 bits, u32 from, bool value);
+
 	private:
 
 		u8 *data;
@@ -110,6 +130,13 @@ namespace oi {
 
 	};
 
+	template<typename T>
+	void Bitset::forEachSetBit(T f) const {
+		for (u32 i = 0, j = (bits + 63) / 64; i < j; ++i)
+			for (u64 word = getWord(i); word != 0; word &= ~(1ULL << BinaryHelper::msb(word)))
+				f(i * 64 + 63 - BinaryHelper::msb(word));
+	}
+
 	//Static Bitset
 
 	template<u32 n>
@@ -314,6 +341,18 @@ namespace oi {
 			memset(data, value ? 0xFF : 0, bytes);
 		}
 
+		u32 count() const { return Bitset::count(data, bits); }
+
+		template<typename T>
+		void forEachSetBit(T f) const {
+			for (u32 i = 0, j = (bits + 63) / 64; i < j; ++i)
+				for (u64 word = Bitset::getWord(data, bits, i); word != 0; word &= ~(1ULL << BinaryHelper::msb(word)))
+					f(i * 64 + 63 - BinaryHelper::msb(word));
+		}
+
+		u32 findFirstSet(u32 from = 0) const { return Bitset::findFirst(data, bits, from, true); }
+		u32 findFirstUnset(u32 from = 0) const { return Bitset::findFirst(data, bits, from, false); }
+
 	private:
 
 		u8 data[bytes];
@@ -41,13 +41,14 @@ namespace oi {
 		Buffer operator+(u32 off) const;
 		Buffer subbuffer(u32 offset, u32 length) const;
 
-		//Uncompress with zlib
+		//Uncompress a block compressed buffer or a zlib stream (older buffers and formats like FBX)
+		//The result needs 1 byte more than the uncompressed size
 		bool uncompress(Buffer result) const;
 
-		//Compress with zlib
+		//Compress with BlockCompression (utils/compression.h); Zlib blocks that are compressed in parallel
 		Buffer compress() const;
 
-		//Compress with zlib into buffer
+		//Compress into buffer (has to be big enough for the block compressed result)
 		bool compress(Buffer result) const;
 
 		//Merge the two buffers into one
@@ -0,0 +1,155 @@
+#pragma once
+#include <cstring>
+#include "types/generic.h"
+
+namespace oi {
+
+	//Hashes the bytes of a C-struct (8 bytes at a time)
+	template<typename T>
+	struct BinaryHash {
+
+		static constexpr u64 prime = 0x9E3779B97F4A7C15ULL;
+
+		inline size_t operator()(const T &t) const {
+
+			const u8 *ptr = (const u8*) &t;
+			u64 h = u64(sizeof(T)) * prime;
+
+			for (size_t i = 0; i + 8 <= sizeof(T); i += 8) {
+				u64 w;
+				memcpy(&w, ptr + i, 8);
+				h = (h ^ w) * prime;
+				h ^= h >> 29;
+			}
+
+			if constexpr (sizeof(T) % 8 != 0) {
+				u64 w = 0;
+				memcpy(&w, ptr + sizeof(T) / 8 * 8, sizeof(T) % 8);
+				h = (h ^ w) * prime;
+				h ^= h >> 29;
+			}
+
+			h ^= h >> 32;
+			h *= 0xD6E8FEB86659FD93ULL;
+			h ^= h >> 32;
+			return size_t(h);
+		}
+
+	};
+
+	//Maps keys to an index in the order they were first inserted (0, 1, 2, ...)
+	//Uses open addressing (linear probing) into a table of indices; the keys themselves are stored contiguously
+	//Iterating over the keys is therefore deterministic (insertion order)
+	template<typename K, typename Hash = BinaryHash<K>>
+	class IndexMap {
+
+	public:
+
+		static constexpr u32 empty = u32_MAX;
+
+		IndexMap(u32 reserved = 0) { reserve(reserved); }
+
+		//Returns the index of the key; if it doesn't exist yet, it is added to the end
+		u32 insert(const K &k, bool &inserted) {
+
+			if ((keys.size() + 1) * 2 > table.size())
+				rehash(table.size() == 0 ? 16 : (u32) table.size() * 2);
+
+			size_t h = hasher(k);
+			u32 mask = (u32) table.size() - 1;
+
+			for (u32 i = u32(h) & mask;; i = (i + 1) & mask) {
+
+				u32 &slot = table[i];
+
+				if (slot == empty) {
+					slot = (u32) keys.size();
+					keys.push_back(k);
+					hashes.push_back(h);
+					inserted = true;
+					return slot;
+				}
+
+				if (hashes[slot] == h && keys[slot] == k) {
+					inserted = false;
+					return slot;
+				}
+			}
+		}
+
+		u32 insert(const K &k) {
+			bool inserted;
+			return insert(k, inserted);
+		}
+
+		//Returns the index of the key or size() if it doesn't exist
+		u32 find(const K &k) const {
+
+			if (table.size() == 0)
+				return size();
+
+			size_t h = hasher(k);
+			u32 mask = (u32) table.size() - 1;
+
+			for (u32 i = u32(h) & mask;; i = (i + 1) & mask) {
+
+				u32 slot = table[i];
+
+				if (slot == empty)
+					return size();
+
+				if (hashes[slot] == h && keys[slot] == k)
+					return slot;
+			}
+		}
+
+		void reserve(u32 count) {
+
+			keys.reserve(count);
+			hashes.reserve(count);
+
+			u32 tableSize = 16;
+
+			while (tableSize < count * 2)
+				tableSize *= 2;
+
+			if (tableSize > table.size())
+				rehash(tableSize);
+		}
+
+		void clear() {
+			keys.clear();
+			hashes.clear();
+			table.assign(table.size(), empty);
+		}
+
+		u32 size() const { return (u32) keys.size(); }
+		const K &operator[](u32 i) const { return keys[i]; }
+		const std::vector<K> &getKeys() const { return keys; }
+
+	private:
+
+		std::vector<K> keys;
+		std::vector<size_t> hashes;
+		std::vector<u32> table;
+		Hash hasher;
+
+		void rehash(u32 tableSize) {
+
+			table.assign(tableSize, empty);
+			u32 mask = tableSize - 1;
+
+			for (u32 j = 0, k = (u32) keys.size(); j < k; ++j) {
+
+				u32 i = u32(hashes[j]) & mask;
+
+				while (table[i] != empty)
+					i = (i + 1) & mask;
+
+				table[i] = j;
+			}
+		}
+
+	};
+
+}
\ No newline at end of file
@@ -9,6 +9,7 @@ namespace oi {
 
 	class JSON;
 	class Buffer;
+	class StringView;
 
 	class String {
 
@@ -48,7 +49,7 @@ namespace oi {
 		String substring(u32 start, u32 end) const;
 
 		u32 count(char c) const;
-		u32 count(String s) const;
+		u32 count(StringView s) const;
 
 		String padStart(char c, u32 count) const;		//Add padding to the start of this string, until it this->size() eaches the specified count
 		String padEnd(char c, u32 count) const;			//Add padding to the end of this string, until it this->size() eaches the specified count
@@ -60,17 +61,19 @@ namespace oi {
 		//If it can't find anything it will just pick size()
 		std::vector<TVec<u32, 2>> find(const String s, const String end, u32 offset) const;
 
-		String replace(String s0, String s1) const;
-		String replaceLast(String s0, String s1) const;
-		String replaceFirst(String s0, String s1) const;
+		//Functions that only read their arguments take a StringView, so literals and other Strings aren't copied
 
-		String fromLast(String split) const;
-		String untilLast(String split) const;
-		String fromFirst(String split) const;
-		String untilFirst(String split) const;
+		String replace(StringView s0, StringView s1) const;
+		String replaceLast(StringView s0, StringView s1) const;
+		String replaceFirst(StringView s0, StringView s1) const;
 
-		std::vector<String> split(String s) const;
-		std::vector<String> splitIgnoreCase(String s) const;
+		String fromLast(StringView split) const;
+		String untilLast(StringView split) const;
+		String fromFirst(StringView split) const;
+		String untilFirst(StringView split) const;
+
+		std::vector<String> split(StringView s) const;
+		std::vector<String> splitIgnoreCase(StringView s) const;
 		String trim() const;
 
 		template<class T>
@@ -100,11 +103,11 @@ namespace oi {
 		String &operator=(const String &other);
 		bool operator==(const String &other) const;
 		bool operator!=(String other) const;
-		bool equalsIgnoreCase(String other) const;
-		bool endsWithIgnoreCase(String other) const;
-		bool startsWithIgnoreCase(String other) const;
-		bool endsWith(String other) const;
-		bool startsWith(String other) const;
+		bool equalsIgnoreCase(StringView other) const;
+		bool endsWithIgnoreCase(StringView other) const;
+		bool startsWithIgnoreCase(StringView other) const;
+		bool endsWith(StringView other) const;
+		bool startsWith(StringView other) const;
 
 		String getPath() const;								//File path without file name
 		String getExtension() const;						//Get extension
@@ -119,8 +122,9 @@ namespace oi {
 		bool isVector() const;
 		u32 getVectorLength() const;
 
-		bool contains(String other) const;
-		bool containsIgnoreCase(String other) const;
+		bool contains(char c) const;
+		bool contains(StringView other) const;
+		bool containsIgnoreCase(StringView other) const;
 
 		static String lineEnd();
 		static String toHex(u32 u);
@@ -155,4 +159,6 @@ namespace std {
 			return str.getHash();
 		}
 	};
-}
\ No newline at end of file
+}
+
+#include "stringview.h"
\ No newline at end of file
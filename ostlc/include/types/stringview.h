@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstring>
+#include "types/string.h"
+
+namespace oi {
+
+	class StringSplit;
+
+	//A view into characters that are owned by something else (String, literal or buffer)
+	//None of the functions allocate; except toString, which copies the characters into a String
+	//The view is only valid as long as the characters it points to are
+	class StringView {
+
+	public:
+
+		static constexpr u32 npos = u32_MAX;
+
+		constexpr StringView() : str(nullptr), len(0) {}
+		constexpr StringView(const char *str, u32 len) : str(str), len(len) {}
+		StringView(const char *str) : str(str), len(str == nullptr ? 0 : (u32) strlen(str)) {}
+		StringView(const String &str) : str(str.toCString()), len(str.size()) {}
+
+		const char *data() const { return str; }
+		u32 size() const { return len; }
+		bool empty() const { return len == 0; }
+
+		char operator[](u32 i) const { return str[i]; }
+
+		const char *begin() const { return str; }
+		const char *end() const { return str + len; }
+
+		StringView cutBegin(u32 start) const;
+		StringView cutEnd(u32 end) const;
+		StringView substring(u32 start, u32 end) const;
+
+		//Returns npos if it can't be found
+		u32 find(char c, u32 offset = 0) const;
+		u32 find(StringView s, u32 offset = 0) const;
+		u32 findLast(char c) const;
+		u32 findLast(StringView s) const;
+
+		u32 count(char c) const;
+		u32 count(StringView s) const;
+
+		bool contains(char c) const { return find(c) != npos; }
+		bool contains(StringView s) const { return find(s) != npos; }
+
+		bool startsWith(StringView s) const;
+		bool endsWith(StringView s) const;
+		bool equalsIgnoreCase(StringView s) const;
+
+		//Empty if split can't be found (same as String)
+		StringView fromLast(StringView split) const;
+		StringView fromFirst(StringView split) const;
+
+		//The whole view if split can't be found (same as String)
+		StringView untilLast(StringView split) const;
+		StringView untilFirst(StringView split) const;
+
+		//Removes spaces, tabs, line ends and null chars from both sides
+		StringView trim() const;
+
+		//Iterates over the parts between the separators; "a,,b" gives "a", "" and "b"
+		//An empty separator gives the view itself
+		StringSplit split(StringView separator) const;
+
+		bool isInt() const;
+		bool isUint() const;
+		bool isFloat() const;
+		bool isFloatNoExp() const;							//Is float; without e notation (ex. 1e5); an empty view isn't
+
+		//Parses the whole (trimmed) view; returns false if it isn't a number or doesn't fit
+		//A leading '+' is allowed, just like with String::toLong and String::toFloat
+		bool toLong(i64 &out) const;
+		bool toULong(u64 &out) const;
+		bool toUInt(u32 &out) const;
+		bool toFloat(f32 &out) const;
+		bool toDouble(f64 &out) const;
+
+		//Same as above, but returns 0 if it isn't a number
+		i64 toLong() const;
+		f32 toFloat() const;
+
+		String toString() const;
+
+		bool operator==(StringView other) const { return len == other.len && (len == 0 || memcmp(str, other.str, len) == 0); }
+		bool operator!=(StringView other) const { return !operator==(other); }
+
+	private:
+
+		const char *str;
+		u32 len;
+
+	};
+
+	class StringSplit {
+
+	public:
+
+		class Iterator {
+
+		public:
+
+			Iterator(const char *it, const char *end, StringView separator);
+
+			StringView operator*() const { return StringView(it, len); }
+
+			Iterator &operator++();
+
+			bool operator==(const Iterator &other) const { return it == other.it; }
+			bool operator!=(const Iterator &other) const { return it != other.it; }
+
+		private:
+
+			void next();
+
+			//it is nullptr if there are no parts left
+			const char *it, *end;
+			StringView separator;
+			u32 len;
+
+		};
+
+		StringSplit(StringView view, StringView separator) : view(view), separator(separator) {}
+
+		//An empty view still has one (empty) part
+		Iterator begin() const { return view.data() == nullptr ? Iterator("", "", separator) : Iterator(view.begin(), view.end(), separator); }
+		Iterator end() const { return Iterator(nullptr, nullptr, separator); }
+
+	private:
+
+		StringView view, separator;
+
+	};
+
+}
\ No newline at end of file
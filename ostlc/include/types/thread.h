@@ -14,60 +14,24 @@ namespace oi {
 			return std::thread::hardware_concurrency();
 		}
 
+		//Run f for every core (on the shared ThreadPool) and wait for all of them to finish
+		static void foreachCore(std::function<void (u32)> f);
+
 		template<typename T>
 		static std::vector<T> foreachCore(std::function<T (u32)> f) {
 
-			u32 threads = cores();
-			std::vector<std::future<T>> thr(threads);
-			std::vector<T> results(threads);
-
-			for (u32 i = 0; i < threads; ++i)
-				thr[i] = std::move(std::async(f, i));
-
-			for (u32 i = 0; i < threads; ++i)
-				results[i] = thr[i].get();
-
+			std::vector<T> results(cores());
+			foreachCore(std::function<void (u32)>([&results, &f](u32 i) { results[i] = f(i); }));
 			return results;
 		}
 
-		static void foreachCore(std::function<void (u32)> f) {
-
-			u32 threads = cores();
-			std::vector<std::future<void>> thr(threads);
-
-			for (u32 i = 0; i < threads; ++i)
-				thr[i] = std::move(std::async(f, i));
-
-			for (u32 i = 0; i < threads; ++i)
-				thr[i].get();
-		}
-
 		template<typename T>
 		static std::vector<T> foreachCore(T (*f)(u32)) {
-
-			u32 threads = cores();
-			std::vector<std::future<T>> thr(threads);
-			std::vector<T> results(threads);
-
-			for (u32 i = 0; i < threads; ++i)
-				thr[i] = std::move(std::async(f, i));
-
-			for (u32 i = 0; i < threads; ++i)
-				results[i] = thr[i].get();
-
-			return results;
+			return foreachCore(std::function<T (u32)>(f));
 		}
 
 		static void foreachCore(void (*f)(u32)) {
-
-			u32 threads = cores();
-			std::vector<std::future<void>> thr(threads);
-
-			for (u32 i = 0; i < threads; ++i)
-				thr[i] = std::move(std::async(f, i));
-
-			for (u32 i = 0; i < threads; ++i)
-				thr[i].get();
+			foreachCore(std::function<void (u32)>(f));
 		}
 
 	};
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include "types/thread.h"
+
+namespace oi {
+
+	typedef std::function<void()> Job;
+
+	//A persistent pool of worker threads
+	//Every worker has its own deque of jobs; it takes jobs from the back of its own deque
+	//and steals from the front of the other workers' deques when it runs out of work
+	class ThreadPool {
+
+	public:
+
+		ThreadPool(u32 threads = Thread::cores());
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool &operator=(const ThreadPool&) = delete;
+
+		//Submit a job; a worker submits to its own deque, other threads distribute the jobs over all workers
+		void submit(Job job);
+
+		//Run one pending job on the calling thread (if there is any)
+		//This allows a thread that is waiting on jobs to help instead of blocking
+		bool runOne();
+
+		//Call f(i) for every i in [begin, end) and wait for all calls to finish; the calling thread helps
+		//The range is split into chunks of grain indices (0 picks a grain that gives every thread a few chunks)
+		void parallelFor(u32 begin, u32 end, u32 grain, const std::function<void (u32)> &f);
+
+		u32 getThreads() const;
+
+		//The id of the worker in this pool that is calling this function (u32_MAX if it isn't a worker of this pool)
+		u32 getWorkerId() const;
+
+		//The shared thread pool (created on first use with a thread per core)
+		static ThreadPool &get();
+
+	private:
+
+		struct Worker {
+			std::mutex mutex;
+			std::deque<Job> jobs;
+		};
+
+		std::vector<Worker> workers;
+		std::vector<std::thread> threads;
+
+		std::mutex sleepMutex;
+		std::condition_variable wake;
+
+		std::atomic<u32> pending, next;
+		std::atomic<bool> running;
+
+		bool pop(u32 worker, Job &job);
+		bool steal(u32 thief, Job &job);
+
+		void work(u32 worker);
+
+	};
+
+	//A group of jobs that can be waited on
+	//Continuations are started once every job in the group is finished and are part of the group themselves
+	class TaskGroup {
+
+	public:
+
+		TaskGroup(ThreadPool &pool = ThreadPool::get());
+
+		//Waits for all jobs to finish
+		~TaskGroup();
+
+		TaskGroup(const TaskGroup&) = delete;
+		TaskGroup &operator=(const TaskGroup&) = delete;
+
+		//Start a job as part of this group
+		void run(Job job);
+
+		//Start a job once all jobs that are currently in the group have finished
+		//If the group is already finished, it starts immediately
+		void then(Job job);
+
+		//Wait until all jobs (and their continuations) are finished; the calling thread helps executing jobs
+		void wait();
+
+		bool isDone() const;
+
+	private:
+
+		ThreadPool &pool;
+
+		std::mutex mutex;
+		std::vector<Job> continuations;
+		std::atomic<u32> remaining;
+
+		void finish();
+
+	};
+
+	//A graph of jobs that is executed on a ThreadPool
+	//A job only starts once all jobs it depends on are finished; jobs without any dependencies start immediately
+	class JobGraph {
+
+	public:
+
+		JobGraph(ThreadPool &pool = ThreadPool::get());
+
+		//Add a job and return its id
+		u32 add(Job job);
+
+		//Make sure that the job 'after' only starts once the job 'before' has finished
+		void addEdge(u32 before, u32 after);
+
+		//Run all jobs and wait for them to finish; the calling thread helps executing jobs
+		//Returns false if the graph contains a cycle (nothing is executed in that case)
+		bool run();
+
+		u32 size() const;
+
+	private:
+
+		struct Node {
+			Job job;
+			std::vector<u32> next;
+			u32 dependencies = 0;
+		};
+
+		ThreadPool &pool;
+		std::vector<Node> nodes;
+
+		std::unique_ptr<std::atomic<u32>[]> waiting;
+		std::atomic<u32> remaining;
+
+		void schedule(u32 node);
+
+	};
+
+}
\ No newline at end of file
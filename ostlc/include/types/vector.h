@@ -570,14 +570,15 @@ namespace oi {
 
 		TVec<T, n> result;
 
-		std::vector<String> s = contains(',') ? split(',') : split(' ');
+		StringView view = *this;
 
 		u32 i = 0;
-		for (auto &e : s) {
+		for (StringView e : view.split(view.contains(',') ? "," : " ")) {
 
-			if(i < n)
-				result[i] = (T) e.trim().toFloat();
+			if (i == n)
+				break;
 
+			result[i] = (T) e.trim().toFloat();
 			++i;
 		}
 
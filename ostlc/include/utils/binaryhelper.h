@@ -1,6 +1,10 @@
 #pragma once
 #include "types/generic.h"
 
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
 namespace oi {
 
 	class Buffer;
@@ -23,6 +27,54 @@ namespace oi {
 
 		static constexpr bool isLittleEndian = le_test_one_cast == 1;
 
+		//Index of the lowest set bit (count trailing zeros); undefined for 0
+		static inline u32 lsb(u32 v);
+		static inline u32 lsb(u64 v);
+
+		//Index of the highest set bit (31/63 - count leading zeros); undefined for 0
+		static inline u32 msb(u32 v);
+		static inline u32 msb(u64 v);
+
+		//Number of set bits
+		static inline u32 popcount(u32 v);
+		static inline u32 popcount(u64 v);
+
+		//Reverse the byte order (endianness)
+		static inline u32 swapBytes(u32 v);
+		static inline u64 swapBytes(u64 v);
+
 	};
 
+
+	#ifdef _MSC_VER
+
+	u32 BinaryHelper::lsb(u32 v) { unsigned long i; _BitScanForward(&i, v); return u32(i); }
+	u32 BinaryHelper::msb(u32 v) { unsigned long i; _BitScanReverse(&i, v); return u32(i); }
+	u32 BinaryHelper::popcount(u32 v) { return u32(__popcnt(v)); }
+	u32 BinaryHelper::swapBytes(u32 v) { return u32(_byteswap_ulong(v)); }
+	u64 BinaryHelper::swapBytes(u64 v) { return u64(_byteswap_uint64(v)); }
+
+	#if defined(_M_X64) || defined(_M_ARM64)
+	u32 BinaryHelper::lsb(u64 v) { unsigned long i; _BitScanForward64(&i, v); return u32(i); }
+	u32 BinaryHelper::msb(u64 v) { unsigned long i; _BitScanReverse64(&i, v); return u32(i); }
+	u32 BinaryHelper::popcount(u64 v) { return u32(__popcnt64(v)); }
+	#else
+	u32 BinaryHelper::lsb(u64 v) { return u32(v) != 0 ? lsb(u32(v)) : lsb(u32(v >> 32)) + 32; }
+	u32 BinaryHelper::msb(u64 v) { return u32(v >> 32) != 0 ? msb(u32(v >> 32)) + 32 : msb(u32(v)); }
+	u32 BinaryHelper::popcount(u64 v) { return popcount(u32(v)) + popcount(u32(v >> 32)); }
+	#endif
+
+	#else
+
+	u32 BinaryHelper::lsb(u32 v) { return u32(__builtin_ctz(v)); }
+	u32 BinaryHelper::lsb(u64 v) { return u32(__builtin_ctzll(v)); }
+	u32 BinaryHelper::msb(u32 v) { return 31 - u32(__builtin_clz(v)); }
+	u32 BinaryHelper::msb(u64 v) { return 63 - u32(__builtin_clzll(v)); }
+	u32 BinaryHelper::popcount(u32 v) { return u32(__builtin_popcount(v)); }
+	u32 BinaryHelper::popcount(u64 v) { return u32(__builtin_popcountll(v)); }
+	u32 BinaryHelper::swapBytes(u32 v) { return u32(__builtin_bswap32(v)); }
+	u64 BinaryHelper::swapBytes(u64 v) { return u64(__builtin_bswap64(v)); }
+
+	#endif
+
 }
\ No newline at end of file
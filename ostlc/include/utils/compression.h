@@ -0,0 +1,64 @@
+#pragma once
+
+#include "types/buffer.h"
+#include "template/enum.h"
+
+namespace oi {
+
+	//None stores the blocks uncompressed; LZ4 is the LZ4 block format (fast to decompress), Zlib compresses better
+	UEnum(CompressionCodec, None = 0, LZ4 = 1, Zlib = 2);
+
+	UEnum(BlockCompressionVersion, Undefined = 0, V0_0_1 = 1);
+
+	//Header of a block compressed buffer
+	//Followed by u32[blocks]; where every block's data ends (relative to the end of that table)
+	//If the top bit is set, the block is stored uncompressed (because it didn't get any smaller)
+	struct BlockCompressionHeader {
+
+		char magicNumber[4];	//oiBC
+		u8 version;				//BlockCompressionVersion
+		u8 codec;				//CompressionCodec
+		u8 blockSizeLog2;		//Every block but the last one has 1 << blockSizeLog2 bytes
+		u8 p0 = 0;
+
+		u32 size;				//Uncompressed size
+		u32 blocks;
+
+	};
+
+	//Compresses buffers as independent blocks, so they can be (de)compressed on the ThreadPool
+	//and a part of the buffer can be uncompressed without touching the other blocks
+	class BlockCompression {
+
+	public:
+
+		static constexpr u32 defaultBlockSize = 256 * 1024;
+
+		//Creates new buffer (blockSize is rounded up to a power of two); returns an empty buffer if it fails
+		//The blocks are written into an allocation of the uncompressed size (+ table), so only a few blocks need temporary memory
+		static Buffer compress(Buffer data, CompressionCodec codec = CompressionCodec::LZ4, u32 blockSize = defaultBlockSize);
+
+		//If the buffer starts with a valid header and block table (bytes after the last block are allowed)
+		static bool isCompressed(Buffer data);
+
+		//The size of the uncompressed data (0 if it isn't compressed)
+		static u32 getSize(Buffer data);
+
+		//Uncompress all blocks; result has to be getSize(data) bytes
+		static bool uncompress(Buffer data, Buffer result);
+
+		//Uncompress the bytes [offset, offset + result.size()); only the blocks in that range are uncompressed
+		static bool uncompress(Buffer data, Buffer result, u32 offset);
+
+		//Compress a single block; returns the compressed size or 0 if it doesn't fit in out
+		static u32 compressBlock(CompressionCodec codec, Buffer in, Buffer out);
+
+		//Uncompress a single block; out has to be the exact uncompressed size
+		static bool uncompressBlock(CompressionCodec codec, Buffer in, Buffer out);
+
+		//The maximum size of a compressed block
+		static u32 getBound(CompressionCodec codec, u32 size);
+
+	};
+
+}
\ No newline at end of file
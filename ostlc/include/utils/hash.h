@@ -0,0 +1,19 @@
+#pragma once
+#include "types/generic.h"
+
+namespace oi {
+
+	class Buffer;
+
+	//Fast non-cryptographic content hashing
+	class Hash {
+
+	public:
+
+		//64-bit xxHash (XXH64) of the data
+		static u64 xx64(const u8 *data, size_t size, u64 seed = 0);
+		static u64 xx64(const Buffer &buf, u64 seed = 0);
+
+	};
+
+}
\ No newline at end of file
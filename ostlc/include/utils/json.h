@@ -160,13 +160,13 @@ namespace oi {
 			return val;
 		}
 
-		JSONNode &operator[](String var);
-		const JSONNode &operator[](String var) const;
+		JSONNode &operator[](const String &var);
+		const JSONNode &operator[](const String &var) const;
 
 		u32 getMembers() const;
 
-		bool exists(String var) const;
-		bool mkdir(String var);
+		bool exists(const String &var) const;
+		bool mkdir(const String &var);
 
 		auto begin() { return children.begin(); }
 		auto end() { return children.end(); }
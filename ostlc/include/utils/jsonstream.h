@@ -0,0 +1,450 @@
+#pragma once
+
+//Streaming JSON (de)serialization
+//Reads/writes ose types straight from/to rapidjson's SAX Reader/Writer, without building a JSON(Node) tree
+
+#include "utils/serialization.h"
+
+namespace oi {
+
+	struct JSONReadFrame;
+	struct JSONReadTarget;
+
+	//A scalar value from the JSON
+	struct JSONReadValue {
+
+		enum Type { Null, Bool, UInt, Int, Float, Str };
+
+		Type type = Null;
+
+		union {
+			bool b;
+			u64 u;
+			i64 i;
+			f64 f;
+		};
+
+		const char *str = nullptr;
+		u32 length = 0;
+
+		JSONReadValue() : u(0) {}
+
+		bool isNumber() const { return type == UInt || type == Int || type == Float; }
+
+		template<typename T>
+		T getNumber() const { return type == UInt ? T(u) : (type == Int ? T(i) : T(f)); }
+
+	};
+
+	//How a JSON value is read into a type (see JSONRead<T>)
+	struct JSONReadType {
+
+		//Read a scalar; false if it's the wrong type (it's ignored)
+		bool (*value)(void *ptr, const JSONReadValue &val);
+
+		//Start of an object or array; false if the type can't be read from it (it's skipped)
+		bool (*start)(void *ptr, JSONReadFrame &frame, bool isArray);
+
+		//Where the next member (key) or array element (key = nullptr) goes
+		JSONReadTarget (*child)(JSONReadFrame &frame, const char *key, u32 length);
+
+		template<typename T>
+		static const JSONReadType *get();
+
+	};
+
+	//Where a JSON value is read to; type = nullptr skips the value
+	struct JSONReadTarget {
+		void *ptr = nullptr;
+		const JSONReadType *type = nullptr;
+	};
+
+	//An object or array that is being read
+	struct JSONReadFrame {
+
+		JSONReadTarget target;
+		bool isArray = false;
+		u32 index = 0;
+
+		//Members of an ose type (in order); the next key is searched from the last found member
+		const std::vector<String> *memberNames = nullptr;
+		std::vector<JSONReadTarget> members;
+
+		//Used by ose's serialize; collects the members so they can be found by key
+		template<typename ...args>
+		void serializeAll(const std::vector<String> &names, bool save, args&... arg) {
+			memberNames = &names;
+			members = { JSONReadTarget{ &arg, JSONReadType::get<args>() }... };
+		}
+
+		JSONReadTarget findMember(const char *key, u32 length);
+
+	};
+
+	//Turns SAX events into reads from a root target
+	class JSONReader {
+
+	public:
+
+		JSONReader(JSONReadTarget root) : root(root) {}
+
+		//Parses the string and reads it into the root; false if the JSON is invalid
+		bool parse(const String &str);
+
+		bool value(const JSONReadValue &val);
+		bool start(bool isArray);
+		bool end();
+		bool key(const char *key, u32 length);
+
+	private:
+
+		JSONReadTarget next();
+
+		std::vector<JSONReadFrame> frames;
+		u32 depth = 0;
+
+		JSONReadTarget root, pending;
+		bool rootRead = false;
+
+	};
+
+	//Writes JSON to a string (rapidjson's Writer or PrettyWriter)
+	class JSONWriter {
+
+	public:
+
+		JSONWriter(bool pretty = true);
+		~JSONWriter();
+
+		JSONWriter(const JSONWriter&) = delete;
+		JSONWriter &operator=(const JSONWriter&) = delete;
+
+		void startObject();
+		void endObject();
+		void startArray();
+		void endArray();
+
+		void key(const String &name);
+
+		void writeUInt(u64 val);
+		void writeInt(i64 val);
+		void writeFloat(f64 val);
+		void writeBool(bool val);
+		void writeString(const String &val);
+
+		String toString() const;
+
+		//Used by ose's serialize; writes every member as key and value
+		template<typename ...args>
+		void serializeAll(const std::vector<String> &names, bool save, args&... arg);
+
+	private:
+
+		void *impl;
+
+	};
+
+	//Reading; for any struct (ose)
+	template<typename T, bool isNum = std::is_arithmetic<T>::value>
+	struct JSONRead {
+
+		static bool value(void*, const JSONReadValue&) { return false; }
+
+		static bool start(void *ptr, JSONReadFrame &frame, bool isArray) {
+
+			if (isArray)
+				return false;
+
+			((T*)ptr)->serialize(frame, false);
+			return true;
+		}
+
+		static JSONReadTarget child(JSONReadFrame &frame, const char *key, u32 length) {
+			return frame.findMember(key, length);
+		}
+
+	};
+
+	//For data types
+	template<typename T>
+	struct JSONRead<T, true> {
+
+		static bool value(void *ptr, const JSONReadValue &val) {
+
+			if (!val.isNumber())
+				return false;
+
+			*(T*)ptr = val.getNumber<T>();
+			return true;
+		}
+
+		static bool start(void*, JSONReadFrame&, bool) { return false; }
+		static JSONReadTarget child(JSONReadFrame&, const char*, u32) { return {}; }
+
+	};
+
+	template<>
+	struct JSONRead<bool, true> {
+
+		static bool value(void *ptr, const JSONReadValue &val) {
+
+			if (val.type != JSONReadValue::Bool)
+				return false;
+
+			*(bool*)ptr = val.b;
+			return true;
+		}
+
+		static bool start(void*, JSONReadFrame&, bool) { return false; }
+		static JSONReadTarget child(JSONReadFrame&, const char*, u32) { return {}; }
+
+	};
+
+	//For strings
+	template<>
+	struct JSONRead<String, false> {
+
+		static bool value(void *ptr, const JSONReadValue &val) {
+
+			if (val.type != JSONReadValue::Str)
+				return false;
+
+			*(String*)ptr = String((char*)val.str, val.length);
+			return true;
+		}
+
+		static bool start(void*, JSONReadFrame&, bool) { return false; }
+		static JSONReadTarget child(JSONReadFrame&, const char*, u32) { return {}; }
+
+	};
+
+	//For vectors; an object (empty vector written by JSONNode) clears the vector
+	template<typename T>
+	struct JSONRead<std::vector<T>, false> {
+
+		static bool value(void*, const JSONReadValue&) { return false; }
+
+		static bool start(void *ptr, JSONReadFrame&, bool isArray) {
+			((std::vector<T>*)ptr)->clear();
+			return isArray;
+		}
+
+		static JSONReadTarget child(JSONReadFrame &frame, const char*, u32) {
+			std::vector<T> &vec = *(std::vector<T>*)frame.target.ptr;
+			vec.emplace_back();
+			return { &vec.back(), JSONReadType::get<T>() };
+		}
+
+	};
+
+	template<typename T, u32 n>
+	struct JSONRead<oi::TVec<T, n>, false> {
+
+		static bool value(void*, const JSONReadValue&) { return false; }
+		static bool start(void*, JSONReadFrame&, bool isArray) { return isArray; }
+
+		static JSONReadTarget child(JSONReadFrame &frame, const char*, u32) {
+
+			if (frame.index >= n)
+				return {};
+
+			return { &(*(oi::TVec<T, n>*)frame.target.ptr)[frame.index], JSONReadType::get<T>() };
+		}
+
+	};
+
+	//A matrix is stored as x arrays of y elements; a column is read from the element at ptr with a stride of x
+	template<typename T, u32 x, u32 y>
+	struct JSONMatrixColumn {};
+
+	template<typename T, u32 x, u32 y>
+	struct JSONRead<JSONMatrixColumn<T, x, y>, false> {
+
+		static bool value(void*, const JSONReadValue&) { return false; }
+		static bool start(void*, JSONReadFrame&, bool isArray) { return isArray; }
+
+		static JSONReadTarget child(JSONReadFrame &frame, const char*, u32) {
+
+			if (frame.index >= y)
+				return {};
+
+			return { (T*)frame.target.ptr + frame.index * x, JSONReadType::get<T>() };
+		}
+
+	};
+
+	template<typename T, u32 x, u32 y>
+	struct JSONRead<oi::TMatrix<T, x, y>, false> {
+
+		static bool value(void*, const JSONReadValue&) { return false; }
+		static bool start(void*, JSONReadFrame&, bool isArray) { return isArray; }
+
+		static JSONReadTarget child(JSONReadFrame &frame, const char*, u32) {
+
+			if (frame.index >= x)
+				return {};
+
+			return { &(*(oi::TMatrix<T, x, y>*)frame.target.ptr)[frame.index], JSONReadType::get<JSONMatrixColumn<T, x, y>>() };
+		}
+
+	};
+
+	//For "named arrays" aka, T[] with names
+	template<typename T>
+	struct JSONRead<std::unordered_map<String, T>, false> {
+
+		static bool value(void*, const JSONReadValue&) { return false; }
+		static bool start(void*, JSONReadFrame&, bool isArray) { return !isArray; }
+
+		static JSONReadTarget child(JSONReadFrame &frame, const char *key, u32 length) {
+			auto &map = *(std::unordered_map<String, T>*)frame.target.ptr;
+			return { &map[String((char*)key, length)], JSONReadType::get<T>() };
+		}
+
+	};
+
+	template<typename T>
+	const JSONReadType *JSONReadType::get() {
+		static const JSONReadType type = { JSONRead<T>::value, JSONRead<T>::start, JSONRead<T>::child };
+		return &type;
+	}
+
+	//Writing; for any struct (ose)
+	template<typename T, bool isNum = std::is_arithmetic<T>::value>
+	struct JSONWrite {
+
+		static void write(JSONWriter &writer, T &val) {
+			writer.startObject();
+			val.serialize(writer, true);
+			writer.endObject();
+		}
+
+	};
+
+	//For data types
+	template<typename T>
+	struct JSONWrite<T, true> {
+
+		static void write(JSONWriter &writer, T &val) {
+
+			if (std::is_same<T, bool>::value)
+				writer.writeBool(val != 0);
+			else if (std::is_floating_point<T>::value)
+				writer.writeFloat((f64)val);
+			else if (std::is_signed<T>::value)
+				writer.writeInt((i64)val);
+			else
+				writer.writeUInt((u64)val);
+		}
+
+	};
+
+	//For strings
+	template<>
+	struct JSONWrite<String, false> {
+		static void write(JSONWriter &writer, String &val) { writer.writeString(val); }
+	};
+
+	template<>
+	struct JSONWrite<const char*, false> {
+		static void write(JSONWriter &writer, const char *val) { writer.writeString(val); }
+	};
+
+	//For vectors
+	template<typename T>
+	struct JSONWrite<std::vector<T>, false> {
+
+		static void write(JSONWriter &writer, std::vector<T> &val) {
+
+			writer.startArray();
+
+			for (T &t : val)
+				JSONWrite<T>::write(writer, t);
+
+			writer.endArray();
+		}
+
+	};
+
+	template<typename T, u32 n>
+	struct JSONWrite<oi::TVec<T, n>, false> {
+
+		static void write(JSONWriter &writer, oi::TVec<T, n> &val) {
+
+			writer.startArray();
+
+			for (u32 i = 0; i < n; ++i)
+				JSONWrite<T>::write(writer, val[i]);
+
+			writer.endArray();
+		}
+
+	};
+
+	template<typename T, u32 x, u32 y>
+	struct JSONWrite<oi::TMatrix<T, x, y>, false> {
+
+		static void write(JSONWriter &writer, oi::TMatrix<T, x, y> &val) {
+
+			writer.startArray();
+
+			for (u32 i = 0; i < x; ++i) {
+
+				writer.startArray();
+
+				for (u32 j = 0; j < y; ++j)
+					JSONWrite<T>::write(writer, val[i + j * x]);
+
+				writer.endArray();
+			}
+
+			writer.endArray();
+		}
+
+	};
+
+	//For "named arrays" aka, T[] with names
+	template<typename T>
+	struct JSONWrite<std::unordered_map<String, T>, false> {
+
+		static void write(JSONWriter &writer, std::unordered_map<String, T> &val) {
+
+			writer.startObject();
+
+			for (auto &elem : val) {
+				writer.key(elem.first);
+				JSONWrite<T>::write(writer, elem.second);
+			}
+
+			writer.endObject();
+		}
+
+	};
+
+	template<typename ...args>
+	void JSONWriter::serializeAll(const std::vector<String> &names, bool, args&... arg) {
+		const String *name = names.data();
+		(void) std::initializer_list<i32>{ (key(*name++), JSONWrite<args>::write(*this, arg), 0)... };
+	}
+
+	struct JSONStream {
+
+		//Read a value from a JSON string; false if the JSON is invalid
+		//Members that are missing or have another type are left untouched
+		template<typename T>
+		static bool read(const String &str, T &val) {
+			JSONReader reader({ &val, JSONReadType::get<T>() });
+			return reader.parse(str);
+		}
+
+		//Write a value to a JSON string; the same as JSON::serialize + toString
+		template<typename T>
+		static String write(T &val, bool pretty = true) {
+			JSONWriter writer(pretty);
+			JSONWrite<T>::write(writer, val);
+			return writer.toString();
+		}
+
+	};
+
+}
\ No newline at end of file
@@ -1,10 +1,22 @@
 #pragma once
 
 #include <typeinfo>
+#include <cstring>
+#include <atomic>
 #include "types/string.h"
 
 #undef ERROR
 
+//Levels below LOG_LEVEL are compiled out (0 = everything, 1 = warnings and up, 2 = errors and up, 4 = nothing)
+//Fatal errors (throwError) always throw
+#ifndef LOG_LEVEL
+	#ifdef NO_LOG
+		#define LOG_LEVEL 4
+	#else
+		#define LOG_LEVEL 0
+	#endif
+#endif
+
 namespace oi {
 
 	typedef void (*LogCallback)(String str);
@@ -13,6 +25,78 @@ namespace oi {
 		PRINT, WARN, ERROR, FATAL
 	};
 
+	//Arguments of Log::format; numbers and strings are copied, so they can be formatted later on the log thread
+	class LogArgs {
+
+	public:
+
+		enum Type : u8 { Int, UInt, Float, Bool, Str, Float32 };
+
+		LogArgs() {}
+		LogArgs(const LogArgs&) = delete;
+		LogArgs &operator=(const LogArgs&) = delete;
+
+		template<typename T>
+		void add(const T &t) {
+
+			if constexpr (std::is_same<T, bool>::value)
+				push(Bool, &t, 1);
+
+			//f32 is kept as is, so it prints the same as String(f32)
+			else if constexpr (std::is_same<T, f32>::value)
+				push(Float32, &t, 4);
+
+			else if constexpr (std::is_floating_point<T>::value) {
+				f64 f = f64(t);
+				push(Float, &f, 8);
+			}
+
+			else if constexpr (std::is_integral<T>::value && std::is_signed<T>::value) {
+				i64 i = i64(t);
+				push(Int, &i, 8);
+			}
+
+			else if constexpr (std::is_integral<T>::value || std::is_enum<T>::value) {
+				u64 u = u64(t);
+				push(UInt, &u, 8);
+			}
+
+			else if constexpr (std::is_convertible<T, const char*>::value)
+				addString(t, u32(strlen(t)));
+
+			else if constexpr (std::is_same<T, String>::value)
+				addString(t.toCString(), t.size());
+
+			//Anything else is converted to a String right away
+			else {
+				String str = t;
+				addString(str.toCString(), str.size());
+			}
+		}
+
+		const u8 *data() const { return length <= localSize ? local : heap.data(); }
+		u32 size() const { return length; }
+
+		//Replace every "{}" in format by the next argument
+		static String format(const char *format, const u8 *data, u32 size);
+
+	private:
+
+		void addString(const char *str, u32 len);
+		void push(Type type, const void *ptr, u32 size);
+		void append(const void *ptr, u32 size);
+
+		//Most messages fit on the stack; bigger ones move to the heap
+		static constexpr u32 localSize = 192;
+
+		u8 local[localSize];
+		std::vector<u8> heap;
+		u32 length = 0;
+
+	};
+
+	//Messages are passed to the callbacks on a background thread, in the order they were logged (per thread)
+	//Producers only copy their message into a bounded ring buffer; when it's full, prints and warnings are dropped and errors wait
 	class Log {
 
 	public:
@@ -24,19 +108,60 @@ namespace oi {
 
 		static void print(String what, LogLevel level);
 
+		//Deferred formatting; every "{}" in format is replaced by the next argument on the log thread (a line end is added)
+		//format has to stay valid (a string literal), arguments are copied (numbers, bools, String and const char*)
+		//Returns false, like warn and error
+		template<LogLevel level = LogLevel::PRINT, typename ...args>
+		static bool format(const char *format, const args &...arg) {
+
+			if constexpr (u32(level) >= LOG_LEVEL) {
+
+				LogArgs packed;
+				(void) std::initializer_list<i32>{ (packed.add(arg), 0)... };
+
+				enqueue(level, format, packed.data(), packed.size(), true);
+			}
+
+			return false;
+		}
+
 		template<class T, u32 errorId>
 		static bool throwError(String what) {
 			String errorCode = String("Error [") + String::toHex(errorId) + " " + typeid(T).name() + "]: " + what;
 			error(errorCode);
+			flush();
 			throw std::runtime_error(errorCode.toCString());
 			return false;
 		}
 
+		//Flushes first, so earlier messages still go to the old callback
+		//Callbacks are called on the log thread (or the calling thread if the Log isn't async)
 		static void setCallback(LogCallback callback, LogLevel ll = LogLevel::PRINT);
 
+		//Waits until every message that was logged so far is passed to the callbacks
+		static void flush();
+
+		//Pass messages to the callbacks on the calling thread instead (flushes first)
+		static void setAsync(bool async);
+		static bool isAsync();
+
+		//Also write every message to a file (empty path closes it)
+		static bool setFile(String path);
+
+		//The number of messages that were dropped because the buffer was full
+		static u64 getDropped();
+
 	private:
 
-		static LogCallback errorc, warningc, printc;
+		//Add a message to the buffer; format = nullptr if data is the message itself
+		static void enqueue(LogLevel level, const char *format, const u8 *data, u32 size, bool lineEnd);
+
+		static void dispatch(LogLevel level, const String &str);
+
+		friend struct LogQueue;
+
+		//Read by the log thread, so they can be swapped while it's running
+		static std::atomic<LogCallback> errorc, warningc, printc;
 	};
 
 }
\ No newline at end of file
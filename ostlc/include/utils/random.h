@@ -1,8 +1,63 @@
 #pragma once
+#include <atomic>
 #include "types/vector.h"
 
 namespace oi {
 
+	//A stream of random numbers from a counter-based generator (Philox4x32-10)
+	//Value i only depends on the seed, stream id and i; so streams can be used on their own threads
+	//and arrays are filled in parallel with the same result, regardless of the number of threads
+	class RandomStream {
+
+	public:
+
+		RandomStream(u64 seed = 0, u32 stream = 0);
+
+		//Returns 0->u32_max and advances the counter
+		u32 randU32();
+
+		//Returns beg->end (swaps end with beg if the one is bigger)
+		//Includes beg and end
+		u32 randInt(u32 beg = u32_MIN, u32 end = u32_MAX);
+
+		//Returns beg->end (excludes end)
+		f32 randFloat(f32 beg = 0.f, f32 end = 1.f);
+
+		//Randomize a number of floats/integers; advances the counter by size
+		void randomizeFloat(f32 *arr, u32 size, f32 beg = 0.f, f32 end = 1.f);
+		void randomizeInt(u32 *arr, u32 size, u32 beg = u32_MIN, u32 end = u32_MAX);
+
+		template<u32 n>
+		TVec<f32, n> randomize(f32 beg, f32 end);
+
+		//Value i of the stream (doesn't advance the counter)
+		u32 get(u64 i) const;
+
+		//Fills arr with values [first, first + size) of the stream (doesn't advance the counter)
+		//Generates 4 (SSE2) or 8 (AVX2) blocks of 4 values at once and splits big arrays over the ThreadPool
+		void fillFloat(u64 first, f32 *arr, u32 size, f32 beg = 0.f, f32 end = 1.f) const;
+		void fillInt(u64 first, u32 *arr, u32 size, u32 beg = u32_MIN, u32 end = u32_MAX) const;
+
+		//A stream with the same seed that doesn't overlap with this one
+		RandomStream getStream(u32 stream) const;
+
+		u64 getSeed() const;
+		u32 getStreamId() const;
+
+		u64 getCounter() const;
+		void setCounter(u64 counter);
+
+		//Philox4x32-10; the 4 values of block 'block' of stream 'stream'
+		static void generate(u64 seed, u32 stream, u64 block, u32 out[4]);
+
+	private:
+
+		u64 seed, counter = 0;
+		u32 stream;
+
+	};
+
+	//Static class that uses a default stream; thread safe, but not deterministic if threads use it at the same time
 	class Random {
 
 	public:
@@ -37,19 +92,31 @@ namespace oi {
 		template<u32 n>
 		static TVec<f32, n> randomize(f32 beg, f32 end);
 
+		//The default stream (at its first unused value); can be used to create streams from the same seed
+		static RandomStream getStream();
+
 	protected:
 
-		static u32 off, seed;
+		static RandomStream stream;
+		static std::atomic<u64> off;
+		static u32 seed;
 
 	};
 
 	template<u32 n>
-	TVec<f32, n> Random::randomize(f32 beg, f32 end) {
+	TVec<f32, n> RandomStream::randomize(f32 beg, f32 end) {
 
 		TVec<f32, n> result;
+		randomizeFloat(result.arr, n, beg, end);
 
-		for (u32 i = 0; i < n; ++i)
-			result[i] = randFloat(beg, end);
+		return result;
+	}
+
+	template<u32 n>
+	TVec<f32, n> Random::randomize(f32 beg, f32 end) {
+
+		TVec<f32, n> result;
+		randomizeFloat(result.arr, n, beg, end);
 
 		return result;
 	}
@@ -0,0 +1,48 @@
+#include "memory/arena.h"
+using namespace oi;
+
+Arena::Arena(u32 blockSize) : blockSize(blockSize) {}
+Arena::~Arena() { clear(); }
+
+u8 *Arena::alloc(size_t size, size_t alignment) {
+
+	u8 *ptr = (u8*)((size_t(current) + alignment - 1) & ~(alignment - 1));
+
+	if (current == nullptr || ptr + size > end) {
+
+		//Big allocations get their own block, so they don't waste the rest of the current block
+		size_t blockLength = size + alignment > blockSize ? size + alignment : blockSize;
+
+		u8 *block = new u8[blockLength];
+		blocks.push_back(block);
+
+		ptr = (u8*)((size_t(block) + alignment - 1) & ~(alignment - 1));
+
+		if (blockLength == blockSize) {
+			current = ptr + size;
+			end = block + blockLength;
+		}
+
+	} else
+		current = ptr + size;
+
+	allocated += size;
+	return ptr;
+}
+
+void Arena::clear() {
+
+	for (size_t i = destructors.size(); i > 0; --i)
+		destructors[i - 1].destroy(destructors[i - 1].ptr);
+
+	for (u8 *block : blocks)
+		delete[] block;
+
+	destructors.clear();
+	blocks.clear();
+
+	current = end = nullptr;
+	allocated = 0;
+}
+
+size_t Arena::getAllocated() const { return allocated; }
\ No newline at end of file
@@ -4,121 +4,237 @@ using namespace oi;
 u32 BlockAllocation::end() const { return start + size; }
 bool BlockAllocation::operator==(const BlockAllocation &other) const { return start == other.start && size == other.size; }
 
-VirtualBlockAllocator::VirtualBlockAllocator(u32 length) : length(length) { blocks.push_back({ 0, length }); }
+VirtualBlockAllocator::VirtualBlockAllocator(u32 length) : length(length) {
 
-BlockAllocation VirtualBlockAllocator::alloc(u32 size) {
+	for (u32 i = 0; i < flCount; ++i)
+		for (u32 j = 0; j < slCount; ++j)
+			bins[i][j] = nullNode;
 
-	BlockAllocation result = { 0, 0 };
-	u32 i = 0;
+	if (length != 0)
+		insert({ 0, length });
+}
 
-	for (BlockAllocation block : blocks)
-		if (block.size == size) {
-			blocks.erase(blocks.begin() + i);
-			allocations.push_back(result = { block.start, size });
-			break;
-		}
-		else if (block.size > size) {
-			blocks[i] = { block.start + size, block.size - size };
-			allocations.push_back(result = { block.start, size });
-			break;
-		}
-		else
-			++i;
+void VirtualBlockAllocator::mapping(u32 size, u32 &fl, u32 &sl) {
+
+	if (size < slCount) {
+		fl = 0;
+		sl = size;
+		return;
+	}
 
-	return result;
+	u32 m = BinaryHelper::msb(size);
+	fl = m - slLog2 + 1;
+	sl = (size >> (m - slLog2)) - slCount;
 }
 
-BlockAllocation VirtualBlockAllocator::allocAligned(u32 size, u32 alignment, u32 &alignedStart) {
+u64 VirtualBlockAllocator::alignUp(u32 start, u32 alignment) {
+
+	if (alignment <= 1)
+		return start;
+
+	return (u64(start) + alignment - 1) / alignment * alignment;
+}
 
-	BlockAllocation result = { 0, 0 };
-	u32 i = 0;
+bool VirtualBlockAllocator::findBin(u32 &fl, u32 &sl) const {
 
-	for (BlockAllocation block : blocks) {
+	if (fl >= flCount)
+		return false;
+
+	u32 slMap = slBitmap[fl] & (u32_MAX << sl);
+
+	if (slMap == 0) {
+
+		u32 flMap = fl + 1 < flCount ? flBitmap & (u32_MAX << (fl + 1)) : 0;
+
+		if (flMap == 0)
+			return false;
+
+		fl = BinaryHelper::lsb(flMap);
+		slMap = slBitmap[fl];
+	}
+
+	sl = BinaryHelper::lsb(slMap);
+	return true;
+}
 
-		u32 aligned = u32(std::ceil((f64)block.start / alignment) * alignment);
-		u32 alignedEnd = aligned + size;
-		u32 alignedSize = alignedEnd - block.start;
+u32 VirtualBlockAllocator::find(u32 size, u32 alignment) const {
 
-		if (block.size == alignedSize) {
-			blocks.erase(blocks.begin() + i);
-			allocations.push_back(result = { block.start, alignedSize });
-			alignedStart = aligned;
-			break;
+	u32 fl, sl;
+
+	//Round up to the next bin; every block in there is big enough, even with worst case alignment padding
+
+	u64 needed = u64(size) + (alignment > 1 ? alignment - 1 : 0);
+
+	if (needed >= slCount)
+		needed += (1ULL << (BinaryHelper::msb(needed) - slLog2)) - 1;
+
+	if (needed <= u32_MAX) {
+
+		mapping(u32(needed), fl, sl);
+
+		if (findBin(fl, sl))
+			return bins[fl][sl];
+	}
+
+	//All bins above are empty; check the blocks in the bins that might fit
+
+	mapping(size, fl, sl);
+
+	while (findBin(fl, sl)) {
+
+		for (u32 node = bins[fl][sl]; node != nullNode; node = freeBlocks[node].next) {
+			const BlockAllocation &block = freeBlocks[node].block;
+			if (alignUp(block.start, alignment) + size <= block.end())
+				return node;
 		}
-		else if (block.size > alignedSize) {
-			blocks[i] = { alignedEnd, block.size - alignedSize };
-			allocations.push_back(result = { block.start, alignedSize });
-			alignedStart = aligned;
-			break;
+
+		if (++sl == slCount) {
+			sl = 0;
+			++fl;
 		}
-		else
-			++i;
 	}
 
-	return result;
+	return nullNode;
 }
 
-bool VirtualBlockAllocator::hasSpace(u32 size) const {
+void VirtualBlockAllocator::insert(BlockAllocation block) {
+
+	u32 node;
+
+	if (unusedNodes.size() != 0) {
+		node = unusedNodes[unusedNodes.size() - 1];
+		unusedNodes.pop_back();
+	} else {
+		node = (u32) freeBlocks.size();
+		freeBlocks.push_back({});
+	}
+
+	u32 fl, sl;
+	mapping(block.size, fl, sl);
+
+	FreeBlock &fb = freeBlocks[node];
+	fb = { block, nullNode, bins[fl][sl] };
 
-	for (BlockAllocation block : blocks)
-		if (block.size >= size)
-			return true;
+	if (fb.next != nullNode)
+		freeBlocks[fb.next].prev = node;
 
-	return false;
+	bins[fl][sl] = node;
+	flBitmap |= 1U << fl;
+	slBitmap[fl] |= 1U << sl;
+
+	freeByStart[block.start] = node;
+	freeByEnd[block.end()] = node;
 }
 
-bool VirtualBlockAllocator::hasAlignedSpace(u32 size, u32 alignment) const {
+void VirtualBlockAllocator::remove(u32 node) {
 
-	for (BlockAllocation block : blocks) {
-		u32 alignedStart = u32(std::ceil((f64)block.start / alignment) * alignment);
-		if (alignedStart + size < block.end())
-			return true;
-	}
+	FreeBlock &fb = freeBlocks[node];
+
+	u32 fl, sl;
+	mapping(fb.block.size, fl, sl);
+
+	if (fb.prev != nullNode)
+		freeBlocks[fb.prev].next = fb.next;
+	else
+		bins[fl][sl] = fb.next;
+
+	if (fb.next != nullNode)
+		freeBlocks[fb.next].prev = fb.prev;
+
+	if (bins[fl][sl] == nullNode && (slBitmap[fl] &= ~(1U << sl)) == 0)
+		flBitmap &= ~(1U << fl);
+
+	freeByStart.erase(fb.block.start);
+	freeByEnd.erase(fb.block.end());
+	unusedNodes.push_back(node);
+}
+
+BlockAllocation VirtualBlockAllocator::alloc(u32 size) {
+
+	if (size == 0)
+		return { 0, 0 };
+
+	u32 node = find(size, 1);
+
+	if (node == nullNode)
+		return { 0, 0 };
+
+	BlockAllocation block = freeBlocks[node].block;
+	remove(node);
+
+	if (block.size != size)
+		insert({ block.start + size, block.size - size });
+
+	allocations[block.start] = size;
+	return { block.start, size };
+}
 
-	return false;
+BlockAllocation VirtualBlockAllocator::allocAligned(u32 size, u32 alignment, u32 &alignedStart) {
+
+	if (size == 0)
+		return { 0, 0 };
+
+	u32 node = find(size, alignment);
+
+	if (node == nullNode)
+		return { 0, 0 };
+
+	BlockAllocation block = freeBlocks[node].block;
+	remove(node);
+
+	u32 aligned = u32(alignUp(block.start, alignment));
+	u32 alignedEnd = aligned + size;
+	u32 alignedSize = alignedEnd - block.start;
+
+	if (block.size != alignedSize)
+		insert({ alignedEnd, block.size - alignedSize });
+
+	allocations[block.start] = alignedSize;
+	alignedStart = aligned;
+	return { block.start, alignedSize };
+}
+
+bool VirtualBlockAllocator::hasSpace(u32 size) const {
+	return find(size, 1) != nullNode;
+}
+
+bool VirtualBlockAllocator::hasAlignedSpace(u32 size, u32 alignment) const {
+	return find(size, alignment) != nullNode;
 }
 
 bool VirtualBlockAllocator::dealloc(u32 pos) {
 
-	u32 i = 0;
+	auto it = allocations.find(pos);
 
-	for (BlockAllocation block : allocations)
-		if (block.start == pos) {
-			allocations.erase(allocations.begin() + i);
-			merge(block);
-			return true;
-		}
-		else ++i;
+	if (it == allocations.end())
+		return false;
 
-	return false;
+	BlockAllocation block = { it->first, it->second };
+	allocations.erase(it);
+	merge(block);
+	return true;
 }
 
 void VirtualBlockAllocator::merge(BlockAllocation allocation) {
 
-	BlockAllocation *left = nullptr, *right = nullptr;
+	auto left = freeByEnd.find(allocation.start);
 
-	for (BlockAllocation &block : blocks)
-		if (allocation.end() == block.start)
-			right = &block;
-		else if (allocation.start == block.end())
-			left = &block;
-		else if (left != nullptr && right != nullptr)
-			break;
+	if (left != freeByEnd.end()) {
+		u32 node = left->second;
+		allocation.start = freeBlocks[node].block.start;
+		allocation.size += freeBlocks[node].block.size;
+		remove(node);
+	}
 
-	if (left)
-		left->size += allocation.size;
+	auto right = freeByStart.find(allocation.end());
 
-	if (left && right) {
-		left->size += right->size;
-		blocks.erase(blocks.begin() + (right - blocks.data()));
-	}
-	else if (right) {
-		right->size += allocation.size;
-		right->start = allocation.start;
+	if (right != freeByStart.end()) {
+		u32 node = right->second;
+		allocation.size += freeBlocks[node].block.size;
+		remove(node);
 	}
-	else if (!left)
-		blocks.push_back(allocation);
 
+	insert(allocation);
 }
 
 u32 VirtualBlockAllocator::size() const { return length; }
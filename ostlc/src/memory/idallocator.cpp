@@ -0,0 +1,107 @@
+#include "memory/idallocator.h"
+#include "utils/binaryhelper.h"
+#include "utils/log.h"
+using namespace oi;
+
+IdAllocator::IdAllocator(u32 count): count(count) {
+
+	if (count > maxIndices)
+		Log::throwError<IdAllocator, 0x0>("IdAllocator can't have more than 2^24 indices");
+
+	u32 bits = count;
+
+	do {
+
+		u32 words = (bits + 63) / 64;
+		std::vector<u64> level(words, u64_MAX);
+
+		if (bits % 64 != 0)
+			level[words - 1] = (1ULL << (bits % 64)) - 1;
+
+		levels.push_back(level);
+		bits = words;
+
+	} while (bits > 1);
+}
+
+bool IdAllocator::isFree(u32 index) const {
+	return (levels[0][index / 64] & (1ULL << (index % 64))) != 0;
+}
+
+void IdAllocator::take(u32 index) {
+
+	if (index >= generations.size())
+		generations.resize(index + 1);
+
+	for (auto &level : levels) {
+
+		u64 &word = level[index / 64];
+		word &= ~(1ULL << (index % 64));
+
+		if (word != 0)
+			break;
+
+		index /= 64;
+	}
+
+	++allocations;
+}
+
+u32 IdAllocator::alloc() {
+
+	if (count == 0 || levels[levels.size() - 1][0] == 0)
+		return invalidId;
+
+	u32 index = 0;
+
+	for (size_t i = levels.size(); i > 0; --i)
+		index = index * 64 + BinaryHelper::lsb(levels[i - 1][index]);
+
+	take(index);
+	return index | (u32(generations[index]) << indexBits);
+}
+
+bool IdAllocator::reserve(u32 index) {
+
+	if (index >= count || !isFree(index))
+		return false;
+
+	take(index);
+	return true;
+}
+
+bool IdAllocator::dealloc(u32 id) {
+
+	if (!contains(id))
+		return false;
+
+	u32 index = getIndex(id);
+	++generations[index];
+
+	//The last index would turn into invalidId with the last generation
+	if ((index | (u32(generations[index]) << indexBits)) == invalidId)
+		++generations[index];
+
+	for (auto &level : levels) {
+
+		u64 &word = level[index / 64];
+		bool wasEmpty = word == 0;
+		word |= 1ULL << (index % 64);
+
+		if (!wasEmpty)
+			break;
+
+		index /= 64;
+	}
+
+	--allocations;
+	return true;
+}
+
+bool IdAllocator::contains(u32 id) const {
+	u32 index = getIndex(id);
+	return index < count && !isFree(index) && generations[index] == getGeneration(id);
+}
+
+u32 IdAllocator::size() const { return count; }
+u32 IdAllocator::getAllocations() const { return allocations; }
\ No newline at end of file
@@ -0,0 +1,78 @@
+#include <algorithm>
+#include "memory/occupancymask.h"
+using namespace oi;
+
+OccupancyMask::OccupancyMask(u32 size) { grow(size); }
+
+u32 OccupancyMask::size() const { return count; }
+u32 OccupancyMask::getAllocations() const { return allocations; }
+
+void OccupancyMask::updateSummary(u32 word) {
+
+	u64 &sum = summary[word / 64];
+	u64 bit = 1ULL << (word % 64);
+
+	if (slots[word] != u64_MAX)
+		sum |= bit;
+	else
+		sum &= ~bit;
+}
+
+void OccupancyMask::grow(u32 size) {
+
+	if (size == 0)
+		return;
+
+	u32 start = count;
+	count += size;
+
+	//New words start occupied, so the slots past the end are never found
+
+	slots.resize((count + 63) / 64, u64_MAX);
+	summary.resize((slots.size() + 63) / 64, 0);
+
+	for (u32 i = start; i < count; ) {
+
+		u32 word = i / 64, bit = i % 64;
+		u32 bits = std::min(64 - bit, count - i);
+
+		slots[word] &= ~((bits == 64 ? u64_MAX : (1ULL << bits) - 1) << bit);
+		updateSummary(word);
+
+		i += bits;
+	}
+}
+
+u32 OccupancyMask::findFree() const {
+
+	for (u32 i = 0, j = (u32) summary.size(); i < j; ++i)
+		if (summary[i] != 0) {
+			u32 word = i * 64 + BinaryHelper::lsb(summary[i]);
+			return word * 64 + BinaryHelper::lsb(~slots[word]);
+		}
+
+	return count;
+}
+
+bool OccupancyMask::isOccupied(u32 i) const {
+	return i >= count || (slots[i / 64] & (1ULL << (i % 64))) != 0;
+}
+
+void OccupancyMask::set(u32 i, bool occupied) {
+
+	if (i >= count || isOccupied(i) == occupied)
+		return;
+
+	u64 &word = slots[i / 64];
+	u64 bit = 1ULL << (i % 64);
+
+	if (occupied) {
+		word |= bit;
+		++allocations;
+	} else {
+		word &= ~bit;
+		--allocations;
+	}
+
+	updateSummary(i / 64);
+}
\ No newline at end of file
@@ -16,6 +16,6 @@ void printerr(String str){
 	__android_log_print(ANDROID_LOG_ERROR, "oi_Log", "%s", str.toCString());
 }
 
-LogCallback Log::errorc = printerr, Log::warningc = printwar, Log::printc = printstr;
+std::atomic<LogCallback> Log::errorc(printerr), Log::warningc(printwar), Log::printc(printstr);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,21 @@
+#ifdef __LINUX__
+
+#include "utils/log.h"
+#include <cstdio>
+using namespace oi;
+
+//Messages are passed on by the log thread, so they're written without formatting
+
+void printstr(String str){
+	fwrite(str.toCString(), 1, str.size(), stdout);
+}
+
+//Flush stdout first, so errors don't show up before the messages that were logged before them
+void printerr(String str){
+	fflush(stdout);
+	fwrite(str.toCString(), 1, str.size(), stderr);
+}
+
+std::atomic<LogCallback> Log::errorc(printerr), Log::warningc(printstr), Log::printc(printstr);
+
+#endif
\ No newline at end of file
@@ -13,6 +13,6 @@ void printerr(String str){
 	printstr(str);
 }
 
-LogCallback Log::errorc = printerr, Log::warningc = printstr, Log::printc = printstr;
+std::atomic<LogCallback> Log::errorc(printerr), Log::warningc(printstr), Log::printc(printstr);
 
 #endif
\ No newline at end of file
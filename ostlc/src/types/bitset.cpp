@@ -37,7 +37,7 @@ Bitset::Bitset(u32 size) : bytes((u32)std::ceil(size / 32.f) * 4), data(nullptr)
 }
 
 Bitset::Bitset(u32 size, bool def): Bitset(size) {
-	std::memset((char*)data, def ? 0xFF : 0, size);
+	std::memset((char*)data, def ? 0xFF : 0, bytes);
 }
 
 u8 *Bitset::addr() { return data; }
@@ -65,68 +65,59 @@ Bitset::~Bitset() {
 
 Bitset::Bitset(const Bitset &other) { copy(other); }
 Bitset &Bitset::operator=(const Bitset &other) {
-	copy(other);
-	return *this;
-}
 
-Bitset &Bitset::flip() {
+	if (this != &other) {
 
-	u32 *uarr = (u32*)data;
+		if (data != nullptr)
+			delete[] data;
 
-	for (u32 i = 0; i < bytes / 4; ++i)
-		uarr[i] = ~uarr[i];
-
-	for (u32 i = 0; i < bytes % 4; ++i)
-		data[bytes / 4 * 4 + i] = ~data[bytes / 4 * 4 + i];
+		copy(other);
+	}
 
 	return *this;
 }
 
-Bitset &Bitset::operator^=(bool other) {
+//Apply an operation per word; 64-bit words first, then the last 32-bit word (bytes is always a multiple of 4)
+//The loops are simple enough to be vectorized by the compiler
+template<typename Op>
+static inline void forEachWord(u8 *data, const u8 *other, u32 bytes, Op op) {
 
-	u32 *uarr = (u32*)data;
+	u32 i = 0;
 
-	u32 c = other ? 0xFFFFFFFFU : 0;
-	u8 c0 = other ? 0xFFU : 0;
+	for (; i + 8 <= bytes; i += 8) {
+		u64 a, b;
+		memcpy(&a, data + i, 8);
+		memcpy(&b, other + i, 8);
+		a = op(a, b);
+		memcpy(data + i, &a, 8);
+	}
 
-	for (u32 i = 0; i < bytes / 4; ++i)
-		uarr[i] ^= c;
+	for (; i + 4 <= bytes; i += 4) {
+		u32 a, b;
+		memcpy(&a, data + i, 4);
+		memcpy(&b, other + i, 4);
+		a = op(a, b);
+		memcpy(data + i, &a, 4);
+	}
+}
 
-	for (u32 i = 0; i < bytes % 4; ++i)
-		data[bytes / 4 * 4 + i] ^= c0;
+Bitset &Bitset::flip() {
+	forEachWord(data, data, bytes, [](auto a, auto) { return ~a; });
+	return *this;
+}
 
+Bitset &Bitset::operator^=(bool other) {
+	if (other) flip();
 	return *this;
 }
 
 Bitset &Bitset::operator|=(bool other) {
-
-	u32 *uarr = (u32*)data;
-
-	u32 c = other ? 0xFFFFFFFFU : 0;
-	u8 c0 = other ? 0xFFU : 0;
-
-	for (u32 i = 0; i < bytes / 4; ++i)
-		uarr[i] |= c;
-
-	for (u32 i = 0; i < bytes % 4; ++i)
-		data[bytes / 4 * 4 + i] |= c0;
-
+	if (other) clear(true);
 	return *this;
 }
 
 Bitset &Bitset::operator&=(bool other) {
-
-	u32 *uarr = (u32*)data;
-
-	u32 c = other ? 0xFFFFFFFFU : 0;
-	u8 c0 = other ? 0xFFU : 0;
-
-	for (u32 i = 0; i < bytes / 4; ++i)
-		uarr[i] &= c;
-
-	for (u32 i = 0; i < bytes % 4; ++i)
-		data[bytes / 4 * 4 + i] &= c0;
-
+	if (!other) clear(false);
 	return *this;
 }
 
@@ -174,104 +165,185 @@ Bitset Bitset::operator~() const {
 }
 
 Bitset &Bitset::operator^=(const Bitset &other) {
+	forEachWord(data, other.data, bytes <= other.bytes ? bytes : other.bytes, [](auto a, auto b) { return a ^ b; });
+	return *this;
+}
 
-	u32 sbytes = bytes <= other.bytes ? bytes : other.bytes;
+Bitset &Bitset::operator|=(const Bitset &other) {
+	forEachWord(data, other.data, bytes <= other.bytes ? bytes : other.bytes, [](auto a, auto b) { return a | b; });
+	return *this;
+}
 
-	u32 *udat = (u32*)data, *oudat = (u32*) other.data;
+Bitset &Bitset::operator&=(const Bitset &other) {
 
-	for (u32 i = 0; i < sbytes / 4; ++i)
-		udat[i] ^= oudat[i];
+	u32 sbytes = bytes <= other.bytes ? bytes : other.bytes;
+	forEachWord(data, other.data, sbytes, [](auto a, auto b) { return a & b; });
 
-	for (u32 i = sbytes * 8; i < bits; ++i)
-		operator[](i) ^= i >= other.bits ? false : other.fetch(i);
+	//Bits that the other doesn't have are false
+	if (sbytes < bytes)
+		memset(data + sbytes, 0, bytes - sbytes);
 
 	return *this;
-
 }
 
-Bitset &Bitset::operator|=(const Bitset &other) {
+void Bitset::write(const std::vector<u32> &values, u32 bitsPerVal) {
 
-	u32 sbytes = bytes <= other.bytes ? bytes : other.bytes;
+	if (bits != bitsPerVal * values.size())
+		Log::throwError<Bitset, 0x0>("Couldn't write values to bitset; bitset didn't have enough space");
 
-	u32 *udat = (u32*)data, *oudat = (u32*)other.data;
+	if (bitsPerVal > 32)
+		Log::throwError<Bitset, 0x2>("Couldn't write values to bitset; a value can't be bigger than 32 bits");
 
-	for (u32 i = 0; i < sbytes / 4; ++i)
-		udat[i] |= oudat[i];
+	if (bitsPerVal == 0)
+		return;
 
-	for (u32 i = sbytes * 8; i < bits; ++i)
-		operator[](i) |= i >= other.bits ? false : other.fetch(i);
+	//Values are shifted into an accumulator and stored 32 bits at a time (big endian; MSB first)
 
-	return *this;
+	u32 mask = u32_MAX >> (32 - bitsPerVal), accBits = 0;
+	u64 acc = 0;
+	u8 *out = data;
 
-}
+	for (u32 value : values) {
 
-Bitset &Bitset::operator&=(const Bitset &other) {
+		acc = (acc << bitsPerVal) | (value & mask);
+		accBits += bitsPerVal;
 
-	u32 sbytes = bytes <= other.bytes ? bytes : other.bytes;
+		if (accBits >= 32) {
 
-	u32 *udat = (u32*)data, *oudat = (u32*)other.data;
+			accBits -= 32;
+			u32 word = u32(acc >> accBits);
 
-	for (u32 i = 0; i < sbytes / 4; ++i)
-		udat[i] &= oudat[i];
+			if (BinaryHelper::isLittleEndian)
+				word = BinaryHelper::swapBytes(word);
 
-	for (u32 i = sbytes * 8; i < bits; ++i)
-		operator[](i) &= i >= other.bits ? false : other.fetch(i);
+			memcpy(out, &word, 4);
+			out += 4;
+		}
+	}
 
-	return *this;
+	for (; accBits >= 8; ++out) {
+		accBits -= 8;
+		*out = u8(acc >> accBits);
+	}
+
+	if (accBits != 0)
+		*out = u8(acc << (8 - accBits));
 
 }
 
-void Bitset::write(const std::vector<u32> &values, u32 bitsPerVal) {
+void Bitset::read(std::vector<u32> &values, u32 bitsPerVal) const {
 
 	if (bits != bitsPerVal * values.size())
-		Log::throwError<Bitset, 0x0>("Couldn't write values to bitset; bitset didn't have enough space");
+		Log::throwError<Bitset, 0x1>("Couldn't read values from bitset; bitset didn't have enough space");
+
+	if (bitsPerVal > 32)
+		Log::throwError<Bitset, 0x3>("Couldn't read values from bitset; a value can't be bigger than 32 bits");
+
+	if (bitsPerVal == 0) {
+
+		for (u32 &value : values)
+			value = 0;
+
+		return;
+	}
+
+	//Bits are loaded 32 at a time into an accumulator (bytes at a time near the end, so it doesn't read past the used bytes)
+
+	u32 mask = u32_MAX >> (32 - bitsPerVal), accBits = 0;
+	u64 acc = 0;
+	const u8 *in = data, *end = data + (bits + 7) / 8;
+
+	for (u32 &value : values) {
+
+		if (accBits < bitsPerVal) {
+
+			if (in + 4 <= end) {
 
-	for (u32 i = 0; i < (u32) values.size() * bitsPerVal; ++i) 
-		operator[](i) = (values[i / bitsPerVal] & (1 << (bitsPerVal - 1 - i % bitsPerVal))) != 0;
+				u32 word;
+				memcpy(&word, in, 4);
+
+				if (BinaryHelper::isLittleEndian)
+					word = BinaryHelper::swapBytes(word);
+
+				acc = (acc << 32) | word;
+				accBits += 32;
+				in += 4;
+
+			} else while (accBits < bitsPerVal) {
+				acc = (acc << 8) | *in;
+				accBits += 8;
+				++in;
+			}
+		}
+
+		accBits -= bitsPerVal;
+		value = u32(acc >> accBits) & mask;
+	}
 
 }
 
-void Bitset::read(std::vector<u32> &values, u32 bitsPerVal) {
+u64 Bitset::getWord(const u8 *data, u32 bits, u32 i) {
 
-	if (bits != bitsPerVal * values.size())
-		Log::throwError<Bitset, 0x1>("Couldn't read values from bitset; bitset didn't have enough space");
+	u64 start = u64(i) * 8, used = (u64(bits) + 7) / 8;
 
-	memset(values.data(), 0, values.size() * sizeof(u32));
+	if (start >= used)
+		return 0;
 
-	u32 *dest = values.data(), *src = (u32*) data;
+	u64 word = 0;
 
-	u32 mask = (1 << bitsPerVal) - 1, offset = 0;
+	if (start + 8 <= used) {
 
-	for (u32 i = 0, len = (u32)values.size(); i < len; ++i) {
+		memcpy(&word, data + start, 8);
 
-		u32 leftIndex = offset / 32;
-		u32 rightIndex = (offset + bitsPerVal) / 32;
-		u32 localOff = offset % 32;
+		if (BinaryHelper::isLittleEndian)
+			word = BinaryHelper::swapBytes(word);
 
-		u32 toEnd = 32 - bitsPerVal;
-		u32 leftBits = toEnd - localOff;
-		u32 rightBits = localOff - toEnd;
+	} else for (u64 j = start; j < used; ++j)
+		word |= u64(data[j]) << (56 - (j - start) * 8);
 
-		u32 left = src[leftIndex];
-		left = ((left & 0xFF) << 24) | ((left & 0xFF00) << 8) | ((left & 0xFF0000) >> 8) | ((left & 0xFF000000) >> 24);
+	u64 remaining = u64(bits) - u64(i) * 64;
 
-		if (leftBits <= toEnd)												//Sample from first uint
-			*(dest + i) = (left & (mask << leftBits)) >> leftBits;
-		else {																//Sample from both uints
+	if (remaining < 64)
+		word &= ~(u64_MAX >> remaining);
 
-			u32 right = src[rightIndex];
-			right = ((right & 0xFF) << 24) | ((right & 0xFF00) << 8) | ((right & 0xFF0000) >> 8) | ((right & 0xFF000000) >> 24);
+	return word;
+}
 
-			*(dest + i) = ((left & (mask >> rightBits)) << rightBits) | ((right & (mask << (32 - rightBits))) >> (32 - rightBits));
+u32 Bitset::count(const u8 *data, u32 bits) {
 
-		}
+	u32 total = 0;
 
-		offset += bitsPerVal;
+	for (u32 i = 0, j = (bits + 63) / 64; i < j; ++i)
+		total += BinaryHelper::popcount(getWord(data, bits, i));
 
+	return total;
+}
+
+u32 Bitset::findFirst(const u8 *data, u32 bits, u32 from, bool value) {
+
+	for (u32 i = from / 64, j = (bits + 63) / 64; i < j; ++i) {
+
+		u64 word = getWord(data, bits, i);
+
+		if (!value)
+			word = ~word;
+
+		if (i == from / 64)
+			word &= u64_MAX >> (from % 64);
+
+		if (word != 0) {
+			u32 bit = i * 64 + 63 - BinaryHelper::msb(word);
+			return bit < bits ? bit : bits;
+		}
 	}
 
+	return bits;
 }
 
+u32 Bitset::count() const { return count(data, bits); }
+u32 Bitset::findFirstSet(u32 from) const { return findFirst(data, bits, from, true); }
+u32 Bitset::findFirstUnset(u32 from) const { return findFirst(data, bits, from, false); }
+
 String Bitset::toString() const {
 	return Buffer::construct(data, bytes).toHex();
 }
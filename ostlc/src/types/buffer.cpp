@@ -227,10 +227,24 @@ bool Buffer::getBit(u32 bitoff) {
 
 //Compressing and uncompressing (end of file to avoid poluting our Buffer.cpp's namespace)
 
+#include "utils/compression.h"
 #include "zlib/zlib.h"
 
 bool Buffer::uncompress(Buffer output) const {
 
+	if (output.length == 0)
+		return Log::error("Couldn't uncompress buffer; the result needs 1 byte more than the expected size");
+
+	//Buffer::compress writes block compressed buffers; older buffers (and formats like FBX) are a single zlib stream
+
+	if (BlockCompression::isCompressed(*this)) {
+
+		if (BlockCompression::getSize(*this) != output.length - 1)
+			return Log::error("Couldn't uncompress buffer; requested size wasn't equal to the actual size");
+
+		return BlockCompression::uncompress(*this, output.subbuffer(0, output.length - 1));
+	}
+
 	uLong outLen = (uLong) output.size();
 
 	if (::uncompress((Bytef*) output.data, &outLen, (Bytef*) data, (uLong) length) != Z_OK)
@@ -243,30 +257,23 @@ bool Buffer::uncompress(Buffer output) const {
 }
 
 Buffer Buffer::compress() const {
-
-	Buffer buf(length);
-
-	uLong outLen = buf.length;
-
-	if (::compress((Bytef*) buf.data, &outLen, (Bytef*) data, length) != Z_OK)
-		return Log::error("Couldn't compress buffer");
-
-	Buffer output((u32)outLen);
-	memcpy(output.data, buf.data, outLen);
-
-	buf.deconstruct();
-
-	return output;
-
+	return BlockCompression::compress(*this, CompressionCodec::Zlib);
 }
 
 bool Buffer::compress(Buffer output) const {
 
-	uLong outLen = output.length;
+	Buffer buf = compress();
 
-	if (::compress((Bytef*)output.data, &outLen, (Bytef*)data, length) != Z_OK)
+	if (buf.length == 0)
 		return Log::error("Couldn't compress buffer");
 
+	if (buf.length > output.length) {
+		buf.deconstruct();
+		return Log::error("Couldn't compress buffer; the result is too small");
+	}
+
+	memcpy(output.data, buf.data, buf.length);
+	buf.deconstruct();
 	return true;
 
 }
\ No newline at end of file
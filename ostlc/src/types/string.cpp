@@ -51,23 +51,11 @@ String String::substring(u32 start, u32 end) const {
 }
 
 u32 String::count(char c) const {
-	size_t offset = 0;
-	u32 count = 0;
-	while ((offset = source.find(c, offset)) != std::string::npos) {
-		++count;
-		++offset;
-	}
-	return count;
+	return StringView(*this).count(c);
 }
 
-u32 String::count(String s) const {
-	size_t offset = 0;
-	u32 count = 0;
-	while ((offset = source.find(s.source, offset)) != std::string::npos) {
-		++count;
-		offset += s.source.size();
-	}
-	return count;
+u32 String::count(StringView s) const {
+	return StringView(*this).count(s);
 }
 
 std::vector<u32> String::find(char c) const {
@@ -133,82 +121,74 @@ bool String::operator<(const String &s) const {
 	return memcmp(toCString(), s.toCString(), shortest) < 0;
 }
 
-String String::replace(String s0, String s1) const {
-	return combine(split(s0), s1);
-}
+String String::replace(StringView s0, StringView s1) const {
 
-String String::replaceFirst(String s0, String s1) const {
-	auto arr = split(s0);
-	String first = arr[0];
-	arr.erase(arr.begin());
-	String last = combine(arr, s0);
-	return first + s1 + last;
-}
+	StringView view = *this;
+	u32 matches = view.count(s0);
 
-String String::replaceLast(String s0, String s1) const {
-	auto arr = split(s0);
-	String last = arr[arr.size() - 1];
-	arr.erase(arr.end() - 1);
-	String first = combine(arr, s0);
-	return first + s1 + last;
-}
+	if (matches == 0) return *this;
+
+	//Allocate once and copy the parts between the matches
+	String res;
+	res.source.reserve(size() + matches * s1.size() - matches * s0.size());
 
-String String::fromLast(String split) const {
+	u32 i = 0;
+
+	for (StringView part : view.split(s0)) {
 
-	std::vector<u32> parts = find(split);
+		if (i++ != 0)
+			res.source.append(s1.data(), s1.size());
 
-	if (parts.size() == 0) return "";
-	return cutBegin(parts[(u32) parts.size() - 1] + 1);
+		res.source.append(part.data(), part.size());
+	}
 
+	return res;
 }
 
-String String::untilLast(String split) const {
+String String::replaceFirst(StringView s0, StringView s1) const {
 
-	std::vector<u32> parts = find(split);
+	u32 i = StringView(*this).find(s0);
 
-	if (parts.size() == 0) return *this;
-	return cutEnd(parts[(u32)parts.size() - 1]);
+	if (i == StringView::npos || s0.size() == 0) return *this;
 
+	String res = *this;
+	res.source.replace(i, s0.size(), s1.data(), s1.size());
+	return res;
 }
 
-String String::fromFirst(String split) const {
+String String::replaceLast(StringView s0, StringView s1) const {
 
-	std::vector<u32> parts = find(split);
+	u32 i = StringView(*this).findLast(s0);
 
-	if (parts.size() == 0) return "";
-	return cutBegin(parts[0] + 1);
+	if (i == StringView::npos || s0.size() == 0) return *this;
 
+	String res = *this;
+	res.source.replace(i, s0.size(), s1.data(), s1.size());
+	return res;
 }
 
-String String::untilFirst(String split) const {
+String String::fromLast(StringView split) const {
+	return StringView(*this).fromLast(split).toString();
+}
 
-	std::vector<u32> parts = find(split);
+String String::untilLast(StringView split) const {
+	return StringView(*this).untilLast(split).toString();
+}
 
-	if (parts.size() == 0) return *this;
-	return cutEnd(parts[0]);
+String String::fromFirst(StringView split) const {
+	return StringView(*this).fromFirst(split).toString();
+}
 
+String String::untilFirst(StringView split) const {
+	return StringView(*this).untilFirst(split).toString();
 }
 
 i64 String::toLong() const {
-
-	i64 object;
-
-	std::stringstream ss;
-	ss << source;
-	ss >> object;
-
-	return object;
+	return StringView(*this).toLong();
 }
 
 f32 String::toFloat() const {
-
-	f32 object;
-
-	std::stringstream ss;
-	ss << source;
-	ss >> object;
-
-	return object;
+	return StringView(*this).toFloat();
 }
 
 std::string String::toStdString() const { return source; }
@@ -241,49 +221,25 @@ String String::combine(std::vector<String> strings, String seperator) {
 	return res;
 }
 
-std::vector<String> String::split(String s) const {
+std::vector<String> String::split(StringView s) const {
 
-	std::vector<String> res(count(s) + 1);
+	StringView view = *this;
 
-	u32 prev = 0;
-	size_t offset = 0;
-	u32 count = 0;
-
-	while ((offset = source.find(s.source, offset)) != std::string::npos) {
+	std::vector<String> res;
+	res.reserve(view.count(s) + 1);
 
-		res[count] = substring(prev, (u32)offset);
-
-		offset += s.source.size();
-		prev = (u32)offset;
-		++count;
-	}
-
-	res[res.size() - 1] = substring(prev, size());
+	for (StringView part : view.split(s))
+		res.push_back(part.toString());
 
 	return res;
 }
 
-std::vector<String> String::splitIgnoreCase(String s) const {
-	return toLowerCase().split(s.toLowerCase());
+std::vector<String> String::splitIgnoreCase(StringView s) const {
+	return toLowerCase().split(s.toString().toLowerCase());
 }
 
 String String::trim() const {
-
-	u32 start = 0;
-	for (u32 i = 0; i < size(); ++i)
-		if (source[i] != ' ' && source[i] != '\t' && source[i] != '\n' && source[i] != '\0') {
-			start = i;
-			break;
-		}
-
-	u32 end = 0;
-	for (u32 i = size() - 1; i != u32_MAX; --i)
-		if (source[i] != ' ' && source[i] != '\t' && source[i] != '\n' && source[i] != '\0') {
-			end = i;
-			break;
-		}
-
-	return substring(start, end + 1);
+	return StringView(*this).trim().toString();
 }
 
 
@@ -309,26 +265,24 @@ String String::toUpperCase() const {
 	return other;
 }
 
-bool String::equalsIgnoreCase(String other) const {
-	return toLowerCase() == other.toLowerCase();
+bool String::equalsIgnoreCase(StringView other) const {
+	return StringView(*this).equalsIgnoreCase(other);
 }
 
-bool String::endsWithIgnoreCase(String other) const {
-	return toLowerCase().endsWith(other.toLowerCase());
+bool String::endsWithIgnoreCase(StringView other) const {
+	return other.size() <= size() && StringView(*this).cutBegin(size() - other.size()).equalsIgnoreCase(other);
 }
 
-bool String::startsWithIgnoreCase(String other) const {
-	return toLowerCase().startsWith(other.toLowerCase());
+bool String::startsWithIgnoreCase(StringView other) const {
+	return other.size() <= size() && StringView(*this).cutEnd(other.size()).equalsIgnoreCase(other);
 }
 
-bool String::endsWith(String other) const {
-	if (other.size() > size()) return false;
-	return cutBegin(size() - other.size()) == other;
+bool String::endsWith(StringView other) const {
+	return StringView(*this).endsWith(other);
 }
 
-bool String::startsWith(String other) const {
-	if (other.size() > size()) return false;
-	return cutEnd(other.size()) == other;
+bool String::startsWith(StringView other) const {
+	return StringView(*this).startsWith(other);
 }
 
 String String::getPath() const {
@@ -352,71 +306,51 @@ String String::getFilePath() const {
 	return untilLast(".");
 }
 
-bool String::isInt() const {
-	for (u32 i = 0; i < size(); ++i)
-		if (!(source[i] >= '0' && source[i] <= '9') && !(source[i] == '-' && i == 0))
-			return false;
-	return true;
-}
+bool String::isInt() const { return StringView(*this).isInt(); }
+bool String::isUint() const { return StringView(*this).isUint(); }
+bool String::isFloatNoExp() const { return StringView(*this).isFloatNoExp(); }
+bool String::isFloat() const { return StringView(*this).isFloat(); }
 
-bool String::isUint() const {
-	for (u32 i = 0; i < size(); ++i)
-		if (!(source[i] >= '0' && source[i] <= '9'))
-			return false;
-	return true;
-}
+bool String::isVector() const {
 
-bool String::isFloatNoExp() const {
-	bool containsDot = false;
+	StringView view = *this;
+	u32 parts = 0;
 
-	for (u32 i = 0; i < size(); ++i)
-		if (!(source[i] >= '0' && source[i] <= '9') && !(source[i] == '-' && i == 0)) {
-			if (source[i] == '.' && !containsDot)
-				containsDot = true;
-			else
-				return false;
-		}
-
-	return true;
-}
+	for (StringView part : view.split(view.contains(',') ? "," : " ")) {
 
-bool String::isFloat() const {
-	if (!containsIgnoreCase("e"))
-		return isFloatNoExp();
-	
-	std::vector<String> splits = splitIgnoreCase("e");
+		if (!part.trim().isFloat())
+			return false;
 
-	if (splits.size() != 2)
-		return false;
+		++parts;
+	}
 
-	return splits[0].isFloatNoExp() && splits[1].isFloatNoExp();
+	return parts >= 2;
 }
 
-bool String::isVector() const {
+u32 String::getVectorLength() const {
 
-	std::vector<String> splits = contains(',') ? splitIgnoreCase(',') : splitIgnoreCase(' ');
+	if (!isVector()) return 0;
 
-	for (u32 i = 0; i < splits.size(); ++i)
-		if (!splits[i].trim().isFloat())
-			return false;
+	return StringView(*this).count(',') + 1;
+}
 
-	return splits.size() >= 2;
+bool String::contains(char c) const {
+	return StringView(*this).contains(c);
 }
 
-u32 String::getVectorLength() const {
+bool String::contains(StringView other) const {
+	return StringView(*this).contains(other);
+}
 
-	if (!isVector()) return 0;
+bool String::containsIgnoreCase(StringView other) const {
 
-	std::vector<String> splits = splitIgnoreCase(",");
-	return (u32) splits.size();
-}
+	StringView view = *this;
 
-bool String::contains(String other) const {
-	return source.find(other.source) != std::string::npos;
-}
+	for (u32 i = 0; i + other.size() <= size(); ++i)
+		if (view.substring(i, i + other.size()).equalsIgnoreCase(other))
+			return true;
 
-bool String::containsIgnoreCase(String other) const {
-	return toLowerCase().contains(other.toLowerCase());
+	return false;
 }
 
 String String::lineEnd() {
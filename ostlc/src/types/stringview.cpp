@@ -0,0 +1,317 @@
+#include "types/stringview.h"
+#include <charconv>
+#include <cstdlib>
+using namespace oi;
+
+//Slicing
+
+StringView StringView::cutBegin(u32 start) const {
+	if (start >= len) return StringView(str + len, 0);
+	return StringView(str + start, len - start);
+}
+
+StringView StringView::cutEnd(u32 end) const {
+	return StringView(str, end > len ? len : end);
+}
+
+StringView StringView::substring(u32 start, u32 end) const {
+
+	if (end > len) end = len;
+
+	if (end <= start)
+		return StringView(str + (start > len ? len : start), 0);
+
+	return StringView(str + start, end - start);
+}
+
+//Searching
+
+u32 StringView::find(char c, u32 offset) const {
+
+	if (offset >= len) return npos;
+
+	const char *it = (const char*) memchr(str + offset, c, len - offset);
+	return it == nullptr ? npos : u32(it - str);
+}
+
+u32 StringView::find(StringView s, u32 offset) const {
+
+	if (s.len == 0) return offset <= len ? offset : npos;
+	if (offset >= len || s.len > len - offset) return npos;
+
+	const char *last = str + len - s.len;
+
+	for (const char *it = str + offset; it <= last; ++it) {
+
+		it = (const char*) memchr(it, s.str[0], last - it + 1);
+
+		if (it == nullptr)
+			return npos;
+
+		if (memcmp(it + 1, s.str + 1, s.len - 1) == 0)
+			return u32(it - str);
+	}
+
+	return npos;
+}
+
+u32 StringView::findLast(char c) const {
+
+	for (u32 i = len - 1; i != u32_MAX; --i)
+		if (str[i] == c)
+			return i;
+
+	return npos;
+}
+
+u32 StringView::findLast(StringView s) const {
+
+	if (s.len > len) return npos;
+	if (s.len == 0) return len;
+
+	for (u32 i = len - s.len; i != u32_MAX; --i)
+		if (str[i] == s.str[0] && memcmp(str + i + 1, s.str + 1, s.len - 1) == 0)
+			return i;
+
+	return npos;
+}
+
+u32 StringView::count(char c) const {
+
+	u32 count = 0;
+
+	for (u32 i = 0; (i = find(c, i)) != npos; ++i)
+		++count;
+
+	return count;
+}
+
+u32 StringView::count(StringView s) const {
+
+	if (s.len == 0) return 0;
+
+	u32 count = 0;
+
+	for (u32 i = 0; (i = find(s, i)) != npos; i += s.len)
+		++count;
+
+	return count;
+}
+
+bool StringView::startsWith(StringView s) const {
+	return s.len <= len && memcmp(str, s.str, s.len) == 0;
+}
+
+bool StringView::endsWith(StringView s) const {
+	return s.len <= len && memcmp(str + len - s.len, s.str, s.len) == 0;
+}
+
+bool StringView::equalsIgnoreCase(StringView s) const {
+
+	if (s.len != len) return false;
+
+	for (u32 i = 0; i < len; ++i) {
+
+		char a = str[i], b = s.str[i];
+
+		if (a >= 'A' && a <= 'Z') a = a - 'A' + 'a';
+		if (b >= 'A' && b <= 'Z') b = b - 'A' + 'a';
+
+		if (a != b)
+			return false;
+	}
+
+	return true;
+}
+
+StringView StringView::fromLast(StringView split) const {
+	u32 i = findLast(split);
+	return i == npos ? StringView() : cutBegin(i + split.len);
+}
+
+StringView StringView::fromFirst(StringView split) const {
+	u32 i = find(split);
+	return i == npos ? StringView() : cutBegin(i + split.len);
+}
+
+StringView StringView::untilLast(StringView split) const {
+	u32 i = findLast(split);
+	return i == npos ? *this : cutEnd(i);
+}
+
+StringView StringView::untilFirst(StringView split) const {
+	u32 i = find(split);
+	return i == npos ? *this : cutEnd(i);
+}
+
+static inline bool isWhitespace(char c) {
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\0';
+}
+
+StringView StringView::trim() const {
+
+	u32 start = 0, end = len;
+
+	while (start < end && isWhitespace(str[start]))
+		++start;
+
+	while (end > start && isWhitespace(str[end - 1]))
+		--end;
+
+	return StringView(str + start, end - start);
+}
+
+StringSplit StringView::split(StringView separator) const {
+	return StringSplit(*this, separator);
+}
+
+//Splitting
+
+StringSplit::Iterator::Iterator(const char *it, const char *end, StringView separator) : it(it), end(end), separator(separator), len(0) {
+	if (it != nullptr) next();
+}
+
+void StringSplit::Iterator::next() {
+
+	u32 i = separator.size() == 0 ? StringView::npos : StringView(it, u32(end - it)).find(separator);
+	len = i == StringView::npos ? u32(end - it) : i;
+}
+
+StringSplit::Iterator &StringSplit::Iterator::operator++() {
+
+	//The last part ends at the end of the view; every other one ends at a separator
+	if (it + len == end)
+		it = nullptr;
+	else {
+		it += len + separator.size();
+		next();
+	}
+
+	return *this;
+}
+
+//Number checks
+
+bool StringView::isInt() const {
+	for (u32 i = 0; i < len; ++i)
+		if (!(str[i] >= '0' && str[i] <= '9') && !(str[i] == '-' && i == 0))
+			return false;
+	return true;
+}
+
+bool StringView::isUint() const {
+	for (u32 i = 0; i < len; ++i)
+		if (!(str[i] >= '0' && str[i] <= '9'))
+			return false;
+	return true;
+}
+
+bool StringView::isFloatNoExp() const {
+
+	if (len == 0)
+		return false;
+
+	bool containsDot = false;
+
+	for (u32 i = 0; i < len; ++i)
+		if (!(str[i] >= '0' && str[i] <= '9') && !(str[i] == '-' && i == 0)) {
+			if (str[i] == '.' && !containsDot)
+				containsDot = true;
+			else
+				return false;
+		}
+
+	return true;
+}
+
+bool StringView::isFloat() const {
+
+	u32 e = find('e');
+
+	if (e == npos)
+		e = find('E');
+
+	if (e == npos)
+		return isFloatNoExp();
+
+	StringView exp = cutBegin(e + 1);
+
+	if (exp.contains('e') || exp.contains('E'))
+		return false;
+
+	return cutEnd(e).isFloatNoExp() && exp.isFloatNoExp();
+}
+
+//Number parsing
+//std::from_chars doesn't allow whitespace or a leading '+', so strip those first
+//If whole is false, it parses as much as it can (like a stringstream would)
+
+static inline StringView numberView(StringView view) {
+
+	view = view.trim();
+
+	if (view.size() > 1 && view[0] == '+' && view[1] != '-')
+		view = view.cutBegin(1);
+
+	return view;
+}
+
+template<typename T>
+static inline bool parseInteger(StringView view, T &out, bool whole) {
+	view = numberView(view);
+	auto res = std::from_chars(view.begin(), view.end(), out);
+	return res.ec == std::errc() && (!whole || res.ptr == view.end());
+}
+
+template<typename T>
+static inline bool parseFloat(StringView view, T &out, bool whole) {
+
+	view = numberView(view);
+
+	#if defined(__cpp_lib_to_chars)
+
+		auto res = std::from_chars(view.begin(), view.end(), out);
+		return res.ec == std::errc() && (!whole || res.ptr == view.end());
+
+	#else
+
+		//Floating point from_chars isn't available on every standard library yet; strtod needs a null terminated string
+		char buf[128];
+
+		if (view.size() == 0 || view.size() >= sizeof(buf))
+			return false;
+
+		memcpy(buf, view.data(), view.size());
+		buf[view.size()] = '\0';
+
+		char *end;
+		f64 d = strtod(buf, &end);
+
+		if (end == buf || (whole && end != buf + view.size()))
+			return false;
+
+		out = T(d);
+		return true;
+
+	#endif
+}
+
+bool StringView::toLong(i64 &out) const { return parseInteger(*this, out, true); }
+bool StringView::toULong(u64 &out) const { return parseInteger(*this, out, true); }
+bool StringView::toUInt(u32 &out) const { return parseInteger(*this, out, true); }
+bool StringView::toFloat(f32 &out) const { return parseFloat(*this, out, true); }
+bool StringView::toDouble(f64 &out) const { return parseFloat(*this, out, true); }
+
+i64 StringView::toLong() const {
+	i64 out = 0;
+	return parseInteger(*this, out, false) ? out : 0;
+}
+
+f32 StringView::toFloat() const {
+	f32 out = 0;
+	return parseFloat(*this, out, false) ? out : 0;
+}
+
+String StringView::toString() const {
+	return len == 0 ? String() : String(const_cast<char*>(str), len);
+}
\ No newline at end of file
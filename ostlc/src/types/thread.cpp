@@ -0,0 +1,12 @@
+#include "types/threadpool.h"
+using namespace oi;
+
+void Thread::foreachCore(std::function<void (u32)> f) {
+
+	TaskGroup group;
+
+	for (u32 i = 0, j = cores(); i < j; ++i)
+		group.run([&f, i]() { f(i); });
+
+	group.wait();
+}
\ No newline at end of file
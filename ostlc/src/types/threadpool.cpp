@@ -0,0 +1,296 @@
+#include "types/threadpool.h"
+#include "utils/log.h"
+using namespace oi;
+
+//ThreadPool
+
+thread_local const ThreadPool *currentPool = nullptr;
+thread_local u32 currentWorker = u32_MAX;
+
+ThreadPool::ThreadPool(u32 threadCount) : workers(threadCount == 0 ? 1 : threadCount), pending(0), next(0), running(true) {
+
+	threads.reserve(workers.size());
+
+	for (u32 i = 0, j = (u32) workers.size(); i < j; ++i)
+		threads.push_back(std::thread(&ThreadPool::work, this, i));
+}
+
+ThreadPool::~ThreadPool() {
+
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		running = false;
+	}
+
+	wake.notify_all();
+
+	for (std::thread &thread : threads)
+		thread.join();
+}
+
+ThreadPool &ThreadPool::get() {
+	static ThreadPool pool;
+	return pool;
+}
+
+u32 ThreadPool::getThreads() const { return (u32) workers.size(); }
+u32 ThreadPool::getWorkerId() const { return currentPool == this ? currentWorker : u32_MAX; }
+
+void ThreadPool::submit(Job job) {
+
+	u32 worker = getWorkerId();
+
+	if (worker == u32_MAX)
+		worker = next++ % getThreads();
+
+	{
+		std::lock_guard<std::mutex> lock(workers[worker].mutex);
+		workers[worker].jobs.push_back(std::move(job));
+	}
+
+	++pending;
+
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+	}
+
+	wake.notify_one();
+}
+
+bool ThreadPool::pop(u32 worker, Job &job) {
+
+	Worker &w = workers[worker];
+	std::lock_guard<std::mutex> lock(w.mutex);
+
+	if (w.jobs.size() == 0)
+		return false;
+
+	job = std::move(w.jobs.back());
+	w.jobs.pop_back();
+	--pending;
+	return true;
+}
+
+bool ThreadPool::steal(u32 thief, Job &job) {
+
+	for (u32 i = 1, j = getThreads(); i <= j; ++i) {
+
+		Worker &w = workers[(thief + i) % j];
+		std::lock_guard<std::mutex> lock(w.mutex);
+
+		if (w.jobs.size() == 0)
+			continue;
+
+		job = std::move(w.jobs.front());
+		w.jobs.pop_front();
+		--pending;
+		return true;
+	}
+
+	return false;
+}
+
+bool ThreadPool::runOne() {
+
+	if (pending == 0)
+		return false;
+
+	u32 worker = getWorkerId();
+	Job job;
+
+	if ((worker != u32_MAX && pop(worker, job)) || steal(worker == u32_MAX ? 0 : worker, job)) {
+		job();
+		return true;
+	}
+
+	return false;
+}
+
+void ThreadPool::work(u32 worker) {
+
+	currentPool = this;
+	currentWorker = worker;
+
+	while (true) {
+
+		Job job;
+
+		if (pop(worker, job) || steal(worker, job)) {
+			job();
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(sleepMutex);
+		wake.wait(lock, [this]() -> bool { return !running || pending != 0; });
+
+		if (!running)
+			break;
+	}
+}
+
+void ThreadPool::parallelFor(u32 begin, u32 end, u32 grain, const std::function<void (u32)> &f) {
+
+	if (begin >= end)
+		return;
+
+	u32 count = end - begin;
+
+	if (grain == 0)
+		grain = std::max(count / (getThreads() * 4), 1U);
+
+	u32 chunks = u32((u64(count) + grain - 1) / grain);
+
+	//Run the first chunk on the calling thread, so a small range doesn't touch the pool
+
+	TaskGroup group(*this);
+
+	for (u32 i = 1; i < chunks; ++i) {
+
+		u32 chunkBegin = u32(begin + u64(i) * grain);
+		u32 chunkEnd = u32(std::min(u64(chunkBegin) + grain, u64(end)));
+
+		group.run([&f, chunkBegin, chunkEnd]() {
+			for (u32 j = chunkBegin; j < chunkEnd; ++j)
+				f(j);
+		});
+	}
+
+	for (u32 j = begin, k = std::min(count, grain) + begin; j < k; ++j)
+		f(j);
+
+	group.wait();
+}
+
+//TaskGroup
+
+TaskGroup::TaskGroup(ThreadPool &pool) : pool(pool), remaining(0) {}
+TaskGroup::~TaskGroup() { wait(); }
+
+bool TaskGroup::isDone() const { return remaining == 0; }
+
+void TaskGroup::run(Job job) {
+
+	++remaining;
+
+	pool.submit([this, job]() {
+		job();
+		finish();
+	});
+}
+
+void TaskGroup::then(Job job) {
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if (remaining == 0)
+		run(job);
+	else
+		continuations.push_back(job);
+}
+
+void TaskGroup::finish() {
+
+	//The lock keeps the group alive until the continuations are started; wait() takes it before returning
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if (--remaining != 0 || continuations.size() == 0)
+		return;
+
+	std::vector<Job> next;
+	next.swap(continuations);
+
+	for (Job &job : next)
+		run(job);
+}
+
+void TaskGroup::wait() {
+
+	while (true) {
+
+		while (remaining != 0)
+			if (!pool.runOne())
+				std::this_thread::yield();
+
+		//finish() might be starting continuations
+		std::lock_guard<std::mutex> lock(mutex);
+
+		if (remaining == 0)
+			return;
+	}
+}
+
+//JobGraph
+
+JobGraph::JobGraph(ThreadPool &pool) : pool(pool), remaining(0) {}
+
+u32 JobGraph::add(Job job) {
+	nodes.push_back({ job, {}, 0 });
+	return (u32) nodes.size() - 1;
+}
+
+void JobGraph::addEdge(u32 before, u32 after) {
+
+	if (before >= size() || after >= size() || before == after) {
+		Log::error("Couldn't add edge to JobGraph; invalid job");
+		return;
+	}
+
+	nodes[before].next.push_back(after);
+	++nodes[after].dependencies;
+}
+
+u32 JobGraph::size() const { return (u32) nodes.size(); }
+
+void JobGraph::schedule(u32 node) {
+
+	pool.submit([this, node]() {
+
+		nodes[node].job();
+
+		for (u32 next : nodes[node].next)
+			if (--waiting[next] == 0)
+				schedule(next);
+
+		--remaining;
+	});
+}
+
+bool JobGraph::run() {
+
+	u32 count = size();
+
+	//Check for cycles; if all nodes can be visited in topological order, there are none
+
+	std::vector<u32> order, dependencies(count);
+	order.reserve(count);
+
+	for (u32 i = 0; i < count; ++i)
+		if ((dependencies[i] = nodes[i].dependencies) == 0)
+			order.push_back(i);
+
+	for (u32 i = 0; i < (u32) order.size(); ++i)
+		for (u32 next : nodes[order[i]].next)
+			if (--dependencies[next] == 0)
+				order.push_back(next);
+
+	if (order.size() != count)
+		return Log::error("Couldn't run JobGraph; it contains a cycle");
+
+	waiting.reset(new std::atomic<u32>[count]);
+
+	for (u32 i = 0; i < count; ++i)
+		waiting[i] = nodes[i].dependencies;
+
+	remaining = count;
+
+	for (u32 i = 0; i < count; ++i)
+		if (nodes[i].dependencies == 0)
+			schedule(i);
+
+	while (remaining != 0)
+		if (!pool.runOne())
+			std::this_thread::yield();
+
+	return true;
+}
\ No newline at end of file
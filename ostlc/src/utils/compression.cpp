@@ -0,0 +1,513 @@
+#include "utils/compression.h"
+#include "types/threadpool.h"
+#include "utils/binaryhelper.h"
+#include "zlib/zlib.h"
+using namespace oi;
+
+//LZ4 block format; sequences of a token (literal length << 4 | match length - 4), literals, a 16-bit offset and the match
+//Lengths of 15 continue in extra bytes (255 means another byte follows)
+//The last 5 bytes are always literals and the last match starts at least 12 bytes before the end
+
+struct LZ4Block {
+
+	static constexpr u32 minMatch = 4, lastLiterals = 5, matchLimit = 12, maxOffset = 0xFFFF;
+	static constexpr u32 hashLog = 12;
+
+	static inline u32 read32(const u8 *ptr) {
+		u32 v;
+		memcpy(&v, ptr, 4);
+		return v;
+	}
+
+	static inline u64 read64(const u8 *ptr) {
+		u64 v;
+		memcpy(&v, ptr, 8);
+		return v;
+	}
+
+	//Hashes the first 5 bytes (little endian); this gives less collisions than 4 bytes
+	static inline u32 hash(const u8 *ptr) {
+		return u32(((read64(ptr) << 24) * 889523592379ULL) >> (64 - hashLog));
+	}
+
+	//How many bytes are equal, up to limit
+	static inline u32 count(const u8 *a, const u8 *b, const u8 *limit) {
+
+		const u8 *start = a;
+
+		while (a + 8 <= limit) {
+
+			u64 diff = read64(a) ^ read64(b);
+
+			if (diff != 0)
+				return u32(a - start) + (BinaryHelper::lsb(diff) >> 3);
+
+			a += 8;
+			b += 8;
+		}
+
+		while (a < limit && *a == *b) {
+			++a;
+			++b;
+		}
+
+		return u32(a - start);
+	}
+
+	static inline u8 *writeLength(u8 *op, u32 len) {
+
+		for (; len >= 255; len -= 255)
+			*op++ = 255;
+
+		*op++ = (u8) len;
+		return op;
+	}
+
+	static inline u8 *writeLiterals(u8 *op, u8 *token, const u8 *src, u32 len) {
+
+		if (len >= 15) {
+			*token = 15 << 4;
+			op = writeLength(op, len - 15);
+		} else
+			*token = u8(len << 4);
+
+		if (len != 0)
+			memcpy(op, src, len);
+
+		return op + len;
+	}
+
+	static u32 compress(const u8 *src, u32 size, u8 *dst, u32 capacity) {
+
+		const u8 *ip = src, *anchor = src, *end = src + size;
+		u8 *op = dst, *oend = dst + capacity;
+
+		if (size > matchLimit) {
+
+			const u8 *mflimit = end - matchLimit, *mlimit = end - lastLiterals;
+
+			u32 table[1 << hashLog];
+			memset(table, 0, sizeof(table));
+
+			while (ip < mflimit) {
+
+				u32 h = hash(ip);
+				const u8 *ref = src + table[h];
+				table[h] = u32(ip - src);
+
+				if (ref >= ip || u32(ip - ref) > maxOffset || read32(ref) != read32(ip)) {
+					ip += 1 + (u32(ip - anchor) >> 6);		//Skip faster through data that doesn't compress
+					continue;
+				}
+
+				while (ip > anchor && ref > src && ip[-1] == ref[-1]) {
+					--ip;
+					--ref;
+				}
+
+				u32 len = minMatch + count(ip + minMatch, ref + minMatch, mlimit);
+
+				u32 literals = u32(ip - anchor);
+
+				//Token, literals + their length, offset and match length
+				if (u64(oend - op) < 1ULL + literals + literals / 255 + 1 + 2 + len / 255 + 1)
+					return 0;
+
+				u8 *token = op++;
+				op = writeLiterals(op, token, anchor, literals);
+
+				u32 offset = u32(ip - ref);
+				*op++ = u8(offset);
+				*op++ = u8(offset >> 8);
+
+				if (len - minMatch >= 15) {
+					*token |= 15;
+					op = writeLength(op, len - minMatch - 15);
+				} else
+					*token |= u8(len - minMatch);
+
+				ip += len;
+				anchor = ip;
+
+				if (ip < mflimit)
+					table[hash(ip - 2)] = u32(ip - 2 - src);
+			}
+		}
+
+		u32 literals = u32(end - anchor);
+
+		if (u64(oend - op) < 1ULL + literals + literals / 255 + 1)
+			return 0;
+
+		u8 *token = op++;
+		op = writeLiterals(op, token, anchor, literals);
+
+		return u32(op - dst);
+	}
+
+	static inline bool readLength(const u8 *&ip, const u8 *iend, u32 &len) {
+
+		u8 b;
+
+		do {
+
+			if (ip >= iend)
+				return false;
+
+			b = *ip++;
+			len += b;
+
+		} while (b == 255);
+
+		return true;
+	}
+
+	//Copies len bytes in chunks of step bytes (so it can write up to step - 1 bytes past the end)
+	//If src is at least step bytes before dst, every chunk only reads bytes that were already written
+	template<u32 step>
+	static inline void wildCopy(u8 *dst, const u8 *src, u32 len) {
+		for (u8 *end = dst + len; dst < end; dst += step, src += step)
+			memcpy(dst, src, step);
+	}
+
+	static bool uncompress(const u8 *src, u32 size, u8 *dst, u32 outSize) {
+
+		const u8 *ip = src, *iend = src + size;
+		u8 *op = dst, *oend = dst + outSize;
+
+		while (ip < iend) {
+
+			u8 token = *ip++;
+			u32 literals = token >> 4;
+
+			//Fast path for short sequences (up to 14 literals and 18 bytes of match) with room to copy more than needed
+			if (literals != 15 && (token & 15) != 15 && iend - ip >= 18 && oend - op >= 32) {
+
+				memcpy(op, ip, 16);
+				ip += literals;
+				op += literals;
+
+				u32 offset = ip[0] | (u32(ip[1]) << 8);
+				ip += 2;
+
+				if (offset < 8 || offset > u32(op - dst)) {
+					ip -= 2;
+					goto match;
+				}
+
+				const u8 *match = op - offset;
+				memcpy(op, match, 8);
+				memcpy(op + 8, match + 8, 8);
+				memcpy(op + 16, match + 16, 2);
+
+				op += (token & 15) + minMatch;
+				continue;
+			}
+
+			if (literals == 15 && !readLength(ip, iend, literals))
+				return false;
+
+			if (literals > u32(iend - ip) || literals > u32(oend - op))
+				return false;
+
+			//Copy 16 bytes at a time if there's room for it
+			if (u32(iend - ip) >= literals + 16 && u32(oend - op) >= literals + 16)
+				wildCopy<16>(op, ip, literals);
+			else
+				memcpy(op, ip, literals);
+
+			ip += literals;
+			op += literals;
+
+			//The last sequence only has literals
+			if (ip == iend)
+				return op == oend;
+
+		match:
+
+			if (iend - ip < 2)
+				return false;
+
+			u32 offset = ip[0] | (u32(ip[1]) << 8);
+			ip += 2;
+
+			if (offset == 0 || offset > u32(op - dst))
+				return false;
+
+			u32 len = token & 15;
+
+			if (len == 15 && !readLength(ip, iend, len))
+				return false;
+
+			len += minMatch;
+
+			if (len > u32(oend - op))
+				return false;
+
+			const u8 *match = op - offset;
+			bool room = u32(oend - op) >= len + 16;
+
+			if (offset >= 16 && room)
+				wildCopy<16>(op, match, len);
+			else if (offset >= 8 && room)
+				wildCopy<8>(op, match, len);
+			else
+				for (u32 i = 0; i < len; ++i)				//Overlapping; repeats the last offset bytes
+					op[i] = match[i];
+
+			op += len;
+		}
+
+		return false;
+	}
+
+};
+
+//Single blocks
+
+u32 BlockCompression::getBound(CompressionCodec codec, u32 size) {
+
+	switch (codec.getValue()) {
+
+	case CompressionCodec::LZ4.value:
+		return size + size / 255 + 16;
+
+	case CompressionCodec::Zlib.value:
+		return (u32) compressBound((uLong) size);
+
+	default:
+		return size;
+	}
+}
+
+u32 BlockCompression::compressBlock(CompressionCodec codec, Buffer in, Buffer out) {
+
+	switch (codec.getValue()) {
+
+	case CompressionCodec::LZ4.value:
+		return LZ4Block::compress(in.addr(), in.size(), out.addr(), out.size());
+
+	case CompressionCodec::Zlib.value: {
+
+		uLongf outLen = (uLongf) out.size();
+
+		if (::compress((Bytef*) out.addr(), &outLen, (const Bytef*) in.addr(), (uLong) in.size()) != Z_OK)
+			return 0;
+
+		return (u32) outLen;
+	}
+
+	default:
+
+		if (in.size() > out.size())
+			return 0;
+
+		memcpy(out.addr(), in.addr(), in.size());
+		return in.size();
+	}
+}
+
+bool BlockCompression::uncompressBlock(CompressionCodec codec, Buffer in, Buffer out) {
+
+	switch (codec.getValue()) {
+
+	case CompressionCodec::LZ4.value:
+		return LZ4Block::uncompress(in.addr(), in.size(), out.addr(), out.size());
+
+	case CompressionCodec::Zlib.value: {
+
+		uLongf outLen = (uLongf) out.size();
+		return ::uncompress((Bytef*) out.addr(), &outLen, (const Bytef*) in.addr(), (uLong) in.size()) == Z_OK && (u32) outLen == out.size();
+	}
+
+	default:
+
+		if (in.size() != out.size())
+			return false;
+
+		memcpy(out.addr(), in.addr(), in.size());
+		return true;
+	}
+}
+
+//Block compressed buffers
+
+static constexpr u32 storedBlock = 1U << 31;
+static const char blockMagicNumber[] = { 'o', 'i', 'B', 'C' };
+
+Buffer BlockCompression::compress(Buffer data, CompressionCodec codec, u32 blockSize) {
+
+	u8 blockSizeLog2 = 10;
+
+	while (blockSizeLog2 < 31 && (1U << blockSizeLog2) < blockSize)
+		++blockSizeLog2;
+
+	blockSize = 1U << blockSizeLog2;
+
+	u32 blocks = (u32)((u64(data.size()) + blockSize - 1) >> blockSizeLog2);
+	u32 bound = getBound(codec, blockSize), tableSize = (u32) sizeof(BlockCompressionHeader) + blocks * 4;
+
+	if (u64(tableSize) + data.size() >= storedBlock) {
+		Log::error("Couldn't compress buffer; it's too big");
+		return {};
+	}
+
+	//A block never takes more than its own size (it's stored as is otherwise), so the output can't be bigger than this
+	Buffer output(tableSize + data.size());
+	std::vector<u32> ends(blocks);
+
+	//Blocks are compressed into temporary slots one batch at a time, so the temporary memory doesn't grow with the input
+	u32 batch = std::min(blocks, ThreadPool::get().getThreads() * 2);
+	Buffer temp = batch == 0 ? Buffer() : Buffer(bound * batch);
+	std::vector<u32> sizes(batch);
+
+	u8 *blockData = output.addr() + tableSize;
+	u32 end = 0;
+
+	for (u32 first = 0; first < blocks; first += batch) {
+
+		u32 count = std::min(batch, blocks - first);
+
+		ThreadPool::get().parallelFor(0, count, 1, [&](u32 j) {
+
+			u32 offset = (first + j) << blockSizeLog2;
+			u32 length = std::min(blockSize, data.size() - offset);
+
+			Buffer in = data.subbuffer(offset, length), out = temp.subbuffer(j * bound, bound);
+			u32 size = compressBlock(codec, in, out);
+
+			if (size == 0 || size >= length) {
+				memcpy(out.addr(), in.addr(), length);
+				size = length | storedBlock;
+			}
+
+			sizes[j] = size;
+		});
+
+		for (u32 j = 0; j < count; ++j) {
+			u32 size = sizes[j] & ~storedBlock;
+			memcpy(blockData + end, temp.addr() + j * bound, size);
+			end += size;
+			ends[first + j] = end | (sizes[j] & storedBlock);
+		}
+	}
+
+	temp.deconstruct();
+
+	BlockCompressionHeader header;
+	memcpy(header.magicNumber, blockMagicNumber, sizeof(blockMagicNumber));
+	header.version = (u8) BlockCompressionVersion::V0_0_1.value;
+	header.codec = (u8) codec.getValue();
+	header.blockSizeLog2 = blockSizeLog2;
+	header.size = data.size();
+	header.blocks = blocks;
+
+	memcpy(output.addr(), &header, sizeof(header));
+	if (blocks != 0)
+		memcpy(output.addr() + sizeof(header), ends.data(), blocks * 4);
+
+	//Only the used part is returned; deconstruct frees the whole allocation
+	return Buffer::construct(output.addr(), tableSize + end);
+}
+
+bool BlockCompression::isCompressed(Buffer data) {
+
+	if (data.size() < sizeof(BlockCompressionHeader))
+		return false;
+
+	BlockCompressionHeader header = data.get<BlockCompressionHeader>(0);
+
+	if (memcmp(header.magicNumber, blockMagicNumber, sizeof(blockMagicNumber)) != 0)
+		return false;
+
+	if (header.version != BlockCompressionVersion::V0_0_1.value || header.codec >= CompressionCodec::length || header.blockSizeLog2 > 31)
+		return false;
+
+	if (header.blocks != (u32)((u64(header.size) + (1ULL << header.blockSizeLog2) - 1) >> header.blockSizeLog2))
+		return false;
+
+	u64 tableSize = sizeof(header) + u64(header.blocks) * 4;
+
+	if (tableSize > data.size())
+		return false;
+
+	//The ends have to be increasing and the last one has to be in the buffer (bytes after it are ignored, like zlib does)
+	u32 prev = 0;
+
+	for (u32 i = 0; i < header.blocks; ++i) {
+
+		u32 end = data.get<u32>(u32(sizeof(header) + i * 4)) & ~storedBlock;
+
+		if (end < prev)
+			return false;
+
+		prev = end;
+	}
+
+	return tableSize + prev <= data.size();
+}
+
+u32 BlockCompression::getSize(Buffer data) {
+	return isCompressed(data) ? data.get<BlockCompressionHeader>(0).size : 0;
+}
+
+bool BlockCompression::uncompress(Buffer data, Buffer result) {
+
+	if (getSize(data) != result.size() || (result.size() == 0 && !isCompressed(data)))
+		return Log::error("Couldn't uncompress buffer; invalid block compressed buffer or result size");
+
+	return uncompress(data, result, 0);
+}
+
+bool BlockCompression::uncompress(Buffer data, Buffer result, u32 offset) {
+
+	if (!isCompressed(data))
+		return Log::error("Couldn't uncompress buffer; invalid block compressed buffer");
+
+	BlockCompressionHeader header = data.get<BlockCompressionHeader>(0);
+
+	if (u64(offset) + result.size() > header.size)
+		return Log::error("Couldn't uncompress buffer; the range is out of bounds");
+
+	if (result.size() == 0)
+		return true;
+
+	CompressionCodec codec = CompressionCodec(header.codec);
+	u32 blockSize = 1U << header.blockSizeLog2;
+
+	const u32 *ends = (const u32*)(data.addr() + sizeof(header));
+	u8 *blockData = data.addr() + sizeof(header) + header.blocks * 4;
+
+	u32 first = offset >> header.blockSizeLog2, last = (offset + result.size() - 1) >> header.blockSizeLog2;
+	std::atomic<bool> success = true;
+
+	ThreadPool::get().parallelFor(first, last + 1, 1, [&](u32 i) {
+
+		u32 start = i == 0 ? 0 : ends[i - 1] & ~storedBlock, end = ends[i] & ~storedBlock;
+		u32 blockStart = i << header.blockSizeLog2, length = std::min(blockSize, header.size - blockStart);
+
+		Buffer in = Buffer::construct(blockData + start, end - start);
+		CompressionCodec blockCodec = ends[i] & storedBlock ? CompressionCodec(CompressionCodec::None) : codec;
+
+		//Blocks that are completely in the range are uncompressed in place; the others through a temporary block
+		u32 from = std::max(offset, blockStart), to = std::min(offset + result.size(), blockStart + length);
+
+		if (from == blockStart && to == blockStart + length) {
+			if (!uncompressBlock(blockCodec, in, result.subbuffer(blockStart - offset, length)))
+				success = false;
+			return;
+		}
+
+		std::vector<u8> temp(length);
+
+		if (!uncompressBlock(blockCodec, in, Buffer::construct(temp.data(), length)))
+			success = false;
+		else
+			memcpy(result.addr() + (from - offset), temp.data() + (from - blockStart), to - from);
+	});
+
+	if (!success)
+		return Log::error("Couldn't uncompress buffer; invalid block");
+
+	return true;
+}
\ No newline at end of file
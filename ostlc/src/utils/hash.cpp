@@ -0,0 +1,71 @@
+#include "utils/hash.h"
+#include "types/buffer.h"
+#include <cstring>
+using namespace oi;
+
+static constexpr u64 prime0 = 0x9E3779B185EBCA87ULL, prime1 = 0xC2B2AE3D27D4EB4FULL, prime2 = 0x165667B19E3779F9ULL;
+static constexpr u64 prime3 = 0x85EBCA77C2B2AE63ULL, prime4 = 0x27D4EB2F165667C5ULL;
+
+static inline u64 rotl(u64 v, u32 r) { return (v << r) | (v >> (64 - r)); }
+
+static inline u64 read64(const u8 *data) { u64 v; memcpy(&v, data, 8); return v; }
+static inline u32 read32(const u8 *data) { u32 v; memcpy(&v, data, 4); return v; }
+
+static inline u64 round(u64 acc, u64 v) {
+	acc += v * prime1;
+	return rotl(acc, 31) * prime0;
+}
+
+static inline u64 merge(u64 acc, u64 v) {
+	acc ^= round(0, v);
+	return acc * prime0 + prime3;
+}
+
+u64 Hash::xx64(const u8 *data, size_t size, u64 seed) {
+
+	const u8 *end = data + size;
+	u64 h;
+
+	if (size >= 32) {
+
+		u64 v0 = seed + prime0 + prime1, v1 = seed + prime1, v2 = seed, v3 = seed - prime0;
+
+		for (const u8 *limit = end - 32; data <= limit; data += 32) {
+			v0 = round(v0, read64(data));
+			v1 = round(v1, read64(data + 8));
+			v2 = round(v2, read64(data + 16));
+			v3 = round(v3, read64(data + 24));
+		}
+
+		h = rotl(v0, 1) + rotl(v1, 7) + rotl(v2, 12) + rotl(v3, 18);
+		h = merge(h, v0);
+		h = merge(h, v1);
+		h = merge(h, v2);
+		h = merge(h, v3);
+
+	} else h = seed + prime4;
+
+	h += u64(size);
+
+	for (; data + 8 <= end; data += 8)
+		h = rotl(h ^ round(0, read64(data)), 27) * prime0 + prime3;
+
+	if (data + 4 <= end) {
+		h = rotl(h ^ (u64(read32(data)) * prime0), 23) * prime1 + prime2;
+		data += 4;
+	}
+
+	for (; data < end; ++data)
+		h = rotl(h ^ (u64(*data) * prime4), 11) * prime0;
+
+	h ^= h >> 33;
+	h *= prime1;
+	h ^= h >> 29;
+	h *= prime2;
+	h ^= h >> 32;
+	return h;
+}
+
+u64 Hash::xx64(const Buffer &buf, u64 seed) {
+	return xx64(buf.addr(), buf.size(), seed);
+}
\ No newline at end of file
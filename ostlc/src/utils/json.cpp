@@ -65,7 +65,7 @@ void JSONNode::reconstruct() {
 
 }
 
-JSONNode &JSONNode::operator[](String str) {
+JSONNode &JSONNode::operator[](const String &str) {
 
 	if (str.size() == 0)
 		return *this;
@@ -84,7 +84,7 @@ JSONNode &JSONNode::operator[](String str) {
 
 }
 
-const JSONNode &JSONNode::operator[](String str) const {
+const JSONNode &JSONNode::operator[](const String &str) const {
 
 	if (str.size() == 0)
 		return *this;
@@ -100,7 +100,7 @@ const JSONNode &JSONNode::operator[](String str) const {
 
 u32 JSONNode::getMembers() const { return (u32) children.size(); }
 
-bool JSONNode::exists(String var) const {
+bool JSONNode::exists(const String &var) const {
 
 	auto it = children.find(var);
 
@@ -111,7 +111,7 @@ bool JSONNode::exists(String var) const {
 
 }
 
-bool JSONNode::mkdir(String var) {
+bool JSONNode::mkdir(const String &var) {
 
 	if (!exists(var)) {
 
@@ -123,7 +123,8 @@ bool JSONNode::mkdir(String var) {
 			node.value = &json->FindMember(var.toCString())->value;
 		} else if (value->IsArray()) {
 
-			u32 j = (u32) var.toLong();
+			u32 j = 0;
+			StringView(var).toUInt(j);
 
 			auto arr = value->GetArray();
 
@@ -0,0 +1,221 @@
+#include "rapidjson/document.h"
+#include "rapidjson/error/en.h"
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/prettywriter.h"
+#define RAPIDJSON
+#include "utils/jsonstream.h"
+using namespace oi;
+
+//Reading
+
+JSONReadTarget JSONReadFrame::findMember(const char *key, u32 length) {
+
+	if (memberNames == nullptr)
+		return {};
+
+	//Members are usually written in order, so start at the member after the last one
+
+	u32 count = (u32) members.size();
+
+	for (u32 i = 0; i < count; ++i) {
+
+		u32 j = (index + i) % count;
+		const String &name = (*memberNames)[j];
+
+		if (name.size() == length && memcmp(name.toCString(), key, length) == 0) {
+			index = j + 1;
+			return members[j];
+		}
+	}
+
+	return {};
+}
+
+JSONReadTarget JSONReader::next() {
+
+	if (depth == 0) {
+
+		if (rootRead)
+			return {};
+
+		rootRead = true;
+		return root;
+	}
+
+	JSONReadFrame &frame = frames[depth - 1];
+
+	if (!frame.isArray) {
+		JSONReadTarget target = pending;
+		pending = {};
+		return target;
+	}
+
+	if (frame.target.type == nullptr)
+		return {};
+
+	JSONReadTarget target = frame.target.type->child(frame, nullptr, 0);
+	++frame.index;
+	return target;
+}
+
+bool JSONReader::value(const JSONReadValue &val) {
+
+	JSONReadTarget target = next();
+
+	if (target.type != nullptr)
+		target.type->value(target.ptr, val);
+
+	return true;
+}
+
+bool JSONReader::start(bool isArray) {
+
+	JSONReadTarget target = next();
+
+	//Frames are reused, so their member vectors don't have to be allocated again
+
+	if (depth == frames.size())
+		frames.emplace_back();
+
+	JSONReadFrame &frame = frames[depth];
+	++depth;
+
+	frame.target = target;
+	frame.isArray = isArray;
+	frame.index = 0;
+	frame.memberNames = nullptr;
+	frame.members.clear();
+
+	if (target.type != nullptr && !target.type->start(target.ptr, frame, isArray))
+		frame.target = {};
+
+	return true;
+}
+
+bool JSONReader::end() {
+	--depth;
+	return true;
+}
+
+bool JSONReader::key(const char *key, u32 length) {
+
+	JSONReadFrame &frame = frames[depth - 1];
+	pending = frame.target.type == nullptr ? JSONReadTarget{} : frame.target.type->child(frame, key, length);
+
+	return true;
+}
+
+//Forwards rapidjson's SAX events to a JSONReader
+struct JSONReaderHandler {
+
+	JSONReader &reader;
+
+	bool Null() { return reader.value(JSONReadValue()); }
+
+	bool Bool(bool b) {
+		JSONReadValue val;
+		val.type = JSONReadValue::Bool;
+		val.b = b;
+		return reader.value(val);
+	}
+
+	bool Int(int i) { return Int64(i); }
+	bool Uint(unsigned u) { return Uint64(u); }
+
+	bool Int64(int64_t i) {
+		JSONReadValue val;
+		val.type = JSONReadValue::Int;
+		val.i = i;
+		return reader.value(val);
+	}
+
+	bool Uint64(uint64_t u) {
+		JSONReadValue val;
+		val.type = JSONReadValue::UInt;
+		val.u = u;
+		return reader.value(val);
+	}
+
+	bool Double(double d) {
+		JSONReadValue val;
+		val.type = JSONReadValue::Float;
+		val.f = d;
+		return reader.value(val);
+	}
+
+	bool RawNumber(const char *str, rapidjson::SizeType length, bool copy) { return String(str, length, copy); }
+
+	bool String(const char *str, rapidjson::SizeType length, bool) {
+		JSONReadValue val;
+		val.type = JSONReadValue::Str;
+		val.str = str;
+		val.length = length;
+		return reader.value(val);
+	}
+
+	bool StartObject() { return reader.start(false); }
+	bool Key(const char *str, rapidjson::SizeType length, bool) { return reader.key(str, length); }
+	bool EndObject(rapidjson::SizeType) { return reader.end(); }
+
+	bool StartArray() { return reader.start(true); }
+	bool EndArray(rapidjson::SizeType) { return reader.end(); }
+
+};
+
+bool JSONReader::parse(const String &str) {
+
+	frames.clear();
+	depth = 0;
+	rootRead = false;
+	pending = {};
+
+	JSONReaderHandler handler{ *this };
+	rapidjson::Reader reader;
+	rapidjson::StringStream stream(str.toCString());
+
+	rapidjson::ParseResult result = reader.Parse(stream, handler);
+
+	if (result.IsError())
+		return Log::error(String("Couldn't parse JSON: ") + rapidjson::GetParseError_En(result.Code()) + " (at " + u32(result.Offset()) + ")");
+
+	return true;
+}
+
+//Writing
+
+struct JSONWriterImpl {
+
+	rapidjson::StringBuffer buffer;
+	rapidjson::Writer<rapidjson::StringBuffer> writer;
+	rapidjson::PrettyWriter<rapidjson::StringBuffer> prettyWriter;
+	bool pretty;
+
+	JSONWriterImpl(bool pretty) : writer(buffer), prettyWriter(buffer), pretty(pretty) {}
+
+	template<typename F>
+	void call(F f) {
+		if (pretty)
+			f(prettyWriter);
+		else
+			f(writer);
+	}
+
+};
+
+JSONWriter::JSONWriter(bool pretty) : impl(new JSONWriterImpl(pretty)) {}
+JSONWriter::~JSONWriter() { delete (JSONWriterImpl*) impl; }
+
+void JSONWriter::startObject() { ((JSONWriterImpl*) impl)->call([](auto &w) { w.StartObject(); }); }
+void JSONWriter::endObject() { ((JSONWriterImpl*) impl)->call([](auto &w) { w.EndObject(); }); }
+void JSONWriter::startArray() { ((JSONWriterImpl*) impl)->call([](auto &w) { w.StartArray(); }); }
+void JSONWriter::endArray() { ((JSONWriterImpl*) impl)->call([](auto &w) { w.EndArray(); }); }
+
+void JSONWriter::key(const String &name) { ((JSONWriterImpl*) impl)->call([&](auto &w) { w.Key(name.toCString(), name.size()); }); }
+
+void JSONWriter::writeUInt(u64 val) { ((JSONWriterImpl*) impl)->call([=](auto &w) { w.Uint64(val); }); }
+void JSONWriter::writeInt(i64 val) { ((JSONWriterImpl*) impl)->call([=](auto &w) { w.Int64(val); }); }
+void JSONWriter::writeFloat(f64 val) { ((JSONWriterImpl*) impl)->call([=](auto &w) { w.Double(val); }); }
+void JSONWriter::writeBool(bool val) { ((JSONWriterImpl*) impl)->call([=](auto &w) { w.Bool(val); }); }
+void JSONWriter::writeString(const String &val) { ((JSONWriterImpl*) impl)->call([&](auto &w) { w.String(val.toCString(), val.size()); }); }
+
+String JSONWriter::toString() const { return ((JSONWriterImpl*) impl)->buffer.GetString(); }
\ No newline at end of file
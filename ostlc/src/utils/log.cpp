@@ -1,29 +1,401 @@
 #include "utils/log.h"
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdio>
 using namespace oi;
 
+//LogArgs
+
+void LogArgs::append(const void *ptr, u32 size) {
+
+	u32 next = length + size;
+
+	if (next > localSize) {
+
+		if (length <= localSize)
+			heap.assign(local, local + length);
+
+		heap.insert(heap.end(), (const u8*) ptr, (const u8*) ptr + size);
+
+	} else
+		memcpy(local + length, ptr, size);
+
+	length = next;
+}
+
+void LogArgs::push(Type type, const void *ptr, u32 size) {
+	append(&type, 1);
+	append(ptr, size);
+}
+
+void LogArgs::addString(const char *str, u32 len) {
+	Type type = Str;
+	append(&type, 1);
+	append(&len, 4);
+	append(str, len);
+}
+
+String LogArgs::format(const char *format, const u8 *data, u32 size) {
+
+	std::string result;
+	const u8 *end = data + size;
+
+	for (const char *c = format; *c != '\0'; ++c) {
+
+		if (c[0] != '{' || c[1] != '}' || data >= end) {
+			result += *c;
+			continue;
+		}
+
+		++c;
+
+		Type type = Type(*data);
+		++data;
+
+		switch (type) {
+
+		case Int: {
+			i64 i;
+			memcpy(&i, data, 8);
+			result += std::to_string(i);
+			data += 8;
+			break;
+		}
+
+		case UInt: {
+			u64 u;
+			memcpy(&u, data, 8);
+			result += std::to_string(u);
+			data += 8;
+			break;
+		}
+
+		case Float: {
+			f64 f;
+			memcpy(&f, data, 8);
+			result += String::fromNumber(f).toStdString();
+			data += 8;
+			break;
+		}
+
+		case Float32: {
+			f32 f;
+			memcpy(&f, data, 4);
+			result += String::fromNumber(f).toStdString();
+			data += 4;
+			break;
+		}
+
+		case Bool:
+			result += *data ? "true" : "false";
+			++data;
+			break;
+
+		default: {
+			u32 len;
+			memcpy(&len, data, 4);
+			result.append((const char*) data + 4, len);
+			data += 4 + len;
+		}
+
+		}
+	}
+
+	return result;
+}
+
+//The log thread and the ring buffer it reads from
+//Producers claim a slot by incrementing the tail; a slot's sequence tells if it's free (index), written (index + 1) or being written
+
+namespace oi {
+
+	struct LogQueue {
+
+		static constexpr u32 slots = 4096, slotData = 208;
+
+		struct Slot {
+
+			std::atomic<u64> sequence;
+
+			LogLevel level;
+			bool lineEnd;
+			const char *format;
+
+			u8 *heap;			//If the message didn't fit into data
+			u32 size;
+
+			u8 data[slotData];
+		};
+
+		Slot slot[slots];
+
+		std::atomic<u64> tail, processed;
+		u64 head = 0, reportedDrops = 0;
+
+		std::atomic<bool> stop, sleeping;
+
+		std::once_flag started;
+		std::thread thread;
+		std::atomic<std::thread::id> threadId;
+
+		std::mutex mutex;
+		std::condition_variable wakeUp;
+
+		LogQueue();
+		~LogQueue();
+
+		bool push(LogLevel level, const char *format, const u8 *data, u32 size, bool lineEnd);
+		bool pop();
+		bool ready() const;
+
+		void start();
+		void wake();
+		void run();
+
+	};
+
+}
+
+//0 = not created, 1 = alive, 2 = destroyed (messages during static destruction are passed on directly)
+static std::atomic<u32> queueState(0);
+static std::atomic<u64> droppedMessages(0);
+static std::atomic<bool> asyncLog(true);
+
+static std::mutex fileMutex;
+static FILE *logFile = nullptr;
+
+static LogQueue &getQueue() {
+	static LogQueue queue;
+	return queue;
+}
+
+static const String &getLineEnd() {
+	static const String lineEnd = String::lineEnd();
+	return lineEnd;
+}
+
+static String toMessage(const char *format, const u8 *data, u32 size, bool lineEnd) {
+	String str = format != nullptr ? LogArgs::format(format, data, size) : String((char*) data, size);
+	return lineEnd ? str + getLineEnd() : str;
+}
+
+LogQueue::LogQueue() : tail(0), processed(0), stop(false), sleeping(false) {
+
+	for (u32 i = 0; i < slots; ++i) {
+		slot[i].sequence = i;
+		slot[i].heap = nullptr;
+	}
+
+	queueState = 1;
+}
+
+LogQueue::~LogQueue() {
+
+	if (thread.joinable()) {
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stop = true;
+		}
+
+		wakeUp.notify_one();
+		thread.join();
+	}
+
+	while (pop());
+
+	queueState = 2;
+}
+
+bool LogQueue::push(LogLevel level, const char *format, const u8 *data, u32 size, bool lineEnd) {
+
+	u64 pos = tail.load(std::memory_order_relaxed);
+	Slot *s;
+
+	for (;;) {
+
+		s = slot + (pos & (slots - 1));
+		i64 diff = i64(s->sequence.load(std::memory_order_acquire) - pos);
+
+		if (diff == 0) {
+			if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (diff < 0)
+			return false;
+		else
+			pos = tail.load(std::memory_order_relaxed);
+	}
+
+	s->level = level;
+	s->lineEnd = lineEnd;
+	s->format = format;
+	s->size = size;
+
+	if (size > slotData) {
+		s->heap = new u8[size];
+		memcpy(s->heap, data, size);
+	} else if (size != 0)
+		memcpy(s->data, data, size);
+
+	s->sequence.store(pos + 1, std::memory_order_release);
+	return true;
+}
+
+bool LogQueue::pop() {
+
+	Slot &s = slot[head & (slots - 1)];
+
+	if (s.sequence.load(std::memory_order_acquire) != head + 1)
+		return false;
+
+	//Format the message and free the slot before it's passed on
+
+	LogLevel level = s.level;
+	String str = toMessage(s.format, s.heap != nullptr ? s.heap : s.data, s.size, s.lineEnd);
+
+	delete[] s.heap;
+	s.heap = nullptr;
+
+	s.sequence.store(head + slots, std::memory_order_release);
+	++head;
+
+	Log::dispatch(level, str);
+	processed.fetch_add(1, std::memory_order_release);
+	return true;
+}
+
+void LogQueue::start() {
+	std::call_once(started, [this]() {
+		thread = std::thread([this]() { run(); });
+		threadId = thread.get_id();
+	});
+}
+
+bool LogQueue::ready() const {
+	return slot[head & (slots - 1)].sequence.load(std::memory_order_acquire) == head + 1;
+}
+
+void LogQueue::wake() {
+
+	//Pairs with the fence in run; either the log thread sees the pushed message or we see that it's sleeping
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	if (!sleeping)
+		return;
+
+	//The log thread holds the mutex until it's waiting, so the notify can't get lost in between
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+	}
+
+	wakeUp.notify_one();
+}
+
+void LogQueue::run() {
+
+	while (true) {
+
+		if (pop())
+			continue;
+
+		u64 dropped = droppedMessages;
+
+		if (dropped != reportedDrops) {
+			Log::dispatch(LogLevel::WARN, String("Log dropped ") + String(dropped - reportedDrops) + " messages; the buffer was full" + getLineEnd());
+			reportedDrops = dropped;
+		}
+
+		if (stop)
+			break;
+
+		//Sleep until a producer wakes us up
+
+		std::unique_lock<std::mutex> lock(mutex);
+		sleeping = true;
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		wakeUp.wait(lock, [this]() { return ready() || stop || droppedMessages != reportedDrops; });
+		sleeping = false;
+	}
+}
+
+//Log
+
+void Log::enqueue(LogLevel level, const char *format, const u8 *data, u32 size, bool lineEnd) {
+
+	if (!asyncLog || queueState == 2) {
+		dispatch(level, toMessage(format, data, size, lineEnd));
+		return;
+	}
+
+	LogQueue &queue = getQueue();
+
+	//The log thread can't wait on itself (a callback that logs)
+	if (std::this_thread::get_id() == queue.threadId) {
+		dispatch(level, toMessage(format, data, size, lineEnd));
+		return;
+	}
+
+	queue.start();
+
+	while (!queue.push(level, format, data, size, lineEnd)) {
+
+		//Prints and warnings are dropped if the buffer is full, errors wait for a free slot
+
+		if (level < LogLevel::ERROR) {
+			++droppedMessages;
+			queue.wake();
+			return;
+		}
+
+		queue.wake();
+		std::this_thread::yield();
+	}
+
+	queue.wake();
+}
+
+void Log::dispatch(LogLevel level, const String &str) {
+
+	if (level >= LogLevel::ERROR)
+		errorc.load()(str);
+	else if (level == LogLevel::WARN)
+		warningc.load()(str);
+	else
+		printc.load()(str);
+
+	std::lock_guard<std::mutex> lock(fileMutex);
+
+	if (logFile != nullptr)
+		fwrite(str.toCString(), 1, str.size(), logFile);
+}
+
 bool Log::warn(String what) {
-	#ifndef NO_LOG
-	warningc(what + String::lineEnd());
+	#if LOG_LEVEL <= 1
+	enqueue(LogLevel::WARN, nullptr, (const u8*) what.toCString(), what.size(), true);
 	#endif
 	return false;
 }
 
 bool Log::error(String what) {
-	#ifndef NO_LOG
-	errorc(what + String::lineEnd());
+	#if LOG_LEVEL <= 2
+	enqueue(LogLevel::ERROR, nullptr, (const u8*) what.toCString(), what.size(), true);
 	#endif
 	return false;
 }
 
 void Log::print(String what) {
-	#ifndef NO_LOG
-	printc(what);
+	#if LOG_LEVEL <= 0
+	enqueue(LogLevel::PRINT, nullptr, (const u8*) what.toCString(), what.size(), false);
 	#endif
 }
 
 void Log::println(String what) {
-	#ifndef NO_LOG
-	printc(what + String::lineEnd());
+	#if LOG_LEVEL <= 0
+	enqueue(LogLevel::PRINT, nullptr, (const u8*) what.toCString(), what.size(), true);
 	#endif
 }
 
@@ -34,7 +406,61 @@ void Log::print(String what, LogLevel level) {
 	else Log::println(what);
 }
 
+void Log::flush() {
+
+	if (queueState != 1)
+		return;
+
+	LogQueue &queue = getQueue();
+
+	if (std::this_thread::get_id() == queue.threadId)
+		return;
+
+	u64 target = queue.tail;
+
+	while (queue.processed.load(std::memory_order_acquire) < target) {
+		queue.wake();
+		std::this_thread::yield();
+	}
+
+	std::lock_guard<std::mutex> lock(fileMutex);
+
+	if (logFile != nullptr)
+		fflush(logFile);
+}
+
+void Log::setAsync(bool async) {
+	flush();
+	asyncLog = async;
+}
+
+bool Log::isAsync() { return asyncLog; }
+
+bool Log::setFile(String path) {
+
+	flush();
+
+	{
+		std::lock_guard<std::mutex> lock(fileMutex);
+
+		if (logFile != nullptr)
+			fclose(logFile);
+
+		logFile = path.size() == 0 ? nullptr : fopen(path.toCString(), "wb");
+
+		if (logFile != nullptr || path.size() == 0)
+			return true;
+	}
+
+	return Log::error(String("Couldn't open log file \"") + path + "\"");
+}
+
+u64 Log::getDropped() { return droppedMessages; }
+
 void Log::setCallback(LogCallback callback, LogLevel ll) {
+
+	flush();
+
 	switch (ll) {
 	case LogLevel::ERROR:
 		errorc = callback;
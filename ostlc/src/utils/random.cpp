@@ -1,60 +1,372 @@
 #include "utils/random.h"
 #include "utils/timer.h"
+#include "types/threadpool.h"
+
+#if defined(__AVX2__)
+	#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+	#include <emmintrin.h>
+#endif
+
 using namespace oi;
 
-const u32 RMAX_min = 0x7FFF;
-u32 Random::off = 0, Random::seed = 0;
+//Philox4x32-10 multipliers and Weyl sequence increments of the key
+static constexpr u32 philoxM0 = 0xD2511F53, philoxM1 = 0xCD9E8D57;
+static constexpr u32 philoxW0 = 0x9E3779B9, philoxW1 = 0xBB67AE85;
+static constexpr u32 philoxRounds = 10;
 
-void Random::setSeed(u32 newSeed) {
-	off = seed = newSeed;
-}
+//Arrays bigger than this are split over the ThreadPool in chunks of randomChunk values
+//The chunks don't depend on the number of threads, so neither does the result
+static constexpr u32 randomParallel = 1 << 16, randomChunk = 1 << 14;
 
-void Random::seedRandom() {
-	setSeed(u32(Timer::getGlobalTimer().getTime().time_since_epoch().count() % u32_MAX));
+//Maps a random u32 to beg->end (excluding end)
+struct RandomFloatMap {
+
+	f32 beg, range;
+
+	RandomFloatMap(f32 beg, f32 end) {
+
+		if (beg > end) {
+			f32 obeg = beg;
+			beg = end;
+			end = obeg;
+		}
+
+		this->beg = beg;
+		range = end - beg;
+	}
+
+	f32 operator()(u32 x) const { return beg + range * (f32(x >> 8) * (1.f / 16777216)); }
+
+};
+
+//Maps a random u32 to beg->end (including end) with a multiply instead of a modulo
+struct RandomIntMap {
+
+	u32 beg;
+	u64 range;
+
+	RandomIntMap(u32 beg, u32 end) {
+
+		if (beg > end) {
+			u32 obeg = beg;
+			beg = end;
+			end = obeg;
+		}
+
+		this->beg = beg;
+		range = u64(end) - beg + 1;
+	}
+
+	u32 operator()(u32 x) const { return range > u32_MAX ? x : beg + u32((u64(x) * range) >> 32); }
+
+};
+
+#if defined(__AVX2__)
+
+	//8 Philox blocks at once; one in every lane
+	struct PhiloxLanes {
+
+		static constexpr u32 width = 8;
+
+		typedef __m256i I;
+		typedef __m256 F;
+
+		static I seti(u32 a) { return _mm256_set1_epi32(i32(a)); }
+		static I ramp(u32 a) { return _mm256_add_epi32(seti(a), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)); }
+		static I xori(I a, I b) { return _mm256_xor_si256(a, b); }
+
+		//The high and low 32 bits of m * a
+		static void mulhilo(u32 m, I a, I &hi, I &lo) {
+			I mv = seti(m), low = _mm256_set1_epi64x(0xFFFFFFFF);
+			I even = _mm256_mul_epu32(a, mv), odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), mv);
+			lo = _mm256_or_si256(_mm256_and_si256(even, low), _mm256_slli_epi64(odd, 32));
+			hi = _mm256_or_si256(_mm256_srli_epi64(even, 32), _mm256_andnot_si256(low, odd));
+		}
+
+		static F mapFloat(I a, const RandomFloatMap &map) {
+			F r = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(a, 8)), _mm256_set1_ps(1.f / 16777216));
+			return _mm256_add_ps(_mm256_set1_ps(map.beg), _mm256_mul_ps(_mm256_set1_ps(map.range), r));
+		}
+
+		static I mapInt(I a, const RandomIntMap &map) {
+
+			if (map.range > u32_MAX)
+				return a;
+
+			I hi, lo;
+			mulhilo(u32(map.range), a, hi, lo);
+			return _mm256_add_epi32(seti(map.beg), hi);
+		}
+
+		static F cast(I a) { return _mm256_castsi256_ps(a); }
+
+		//Stores the values of all blocks in order (c0 has the first value of each block, c1 the second, etc.)
+		static void store(f32 *out, F c0, F c1, F c2, F c3) {
+
+			F t0 = _mm256_unpacklo_ps(c0, c1), t1 = _mm256_unpackhi_ps(c0, c1);
+			F t2 = _mm256_unpacklo_ps(c2, c3), t3 = _mm256_unpackhi_ps(c2, c3);
+
+			F b0 = _mm256_shuffle_ps(t0, t2, 0x44), b1 = _mm256_shuffle_ps(t0, t2, 0xEE);
+			F b2 = _mm256_shuffle_ps(t1, t3, 0x44), b3 = _mm256_shuffle_ps(t1, t3, 0xEE);
+
+			_mm256_storeu_ps(out, _mm256_permute2f128_ps(b0, b1, 0x20));
+			_mm256_storeu_ps(out + 8, _mm256_permute2f128_ps(b2, b3, 0x20));
+			_mm256_storeu_ps(out + 16, _mm256_permute2f128_ps(b0, b1, 0x31));
+			_mm256_storeu_ps(out + 24, _mm256_permute2f128_ps(b2, b3, 0x31));
+		}
+
+	};
+
+	#define PHILOX_LANES
+
+#elif defined(__SSE2__) || defined(_M_X64)
+
+	//4 Philox blocks at once; one in every lane
+	struct PhiloxLanes {
+
+		static constexpr u32 width = 4;
+
+		typedef __m128i I;
+		typedef __m128 F;
+
+		static I seti(u32 a) { return _mm_set1_epi32(i32(a)); }
+		static I ramp(u32 a) { return _mm_add_epi32(seti(a), _mm_setr_epi32(0, 1, 2, 3)); }
+		static I xori(I a, I b) { return _mm_xor_si128(a, b); }
+
+		//The high and low 32 bits of m * a
+		static void mulhilo(u32 m, I a, I &hi, I &lo) {
+			I mv = seti(m), low = _mm_set_epi32(0, -1, 0, -1);
+			I even = _mm_mul_epu32(a, mv), odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), mv);
+			lo = _mm_or_si128(_mm_and_si128(even, low), _mm_slli_epi64(odd, 32));
+			hi = _mm_or_si128(_mm_srli_epi64(even, 32), _mm_andnot_si128(low, odd));
+		}
+
+		static F mapFloat(I a, const RandomFloatMap &map) {
+			F r = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(a, 8)), _mm_set1_ps(1.f / 16777216));
+			return _mm_add_ps(_mm_set1_ps(map.beg), _mm_mul_ps(_mm_set1_ps(map.range), r));
+		}
+
+		static I mapInt(I a, const RandomIntMap &map) {
+
+			if (map.range > u32_MAX)
+				return a;
+
+			I hi, lo;
+			mulhilo(u32(map.range), a, hi, lo);
+			return _mm_add_epi32(seti(map.beg), hi);
+		}
+
+		static F cast(I a) { return _mm_castsi128_ps(a); }
+
+		//Stores the values of all blocks in order (c0 has the first value of each block, c1 the second, etc.)
+		static void store(f32 *out, F c0, F c1, F c2, F c3) {
+			_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+			_mm_storeu_ps(out, c0);
+			_mm_storeu_ps(out + 4, c1);
+			_mm_storeu_ps(out + 8, c2);
+			_mm_storeu_ps(out + 12, c3);
+		}
+
+	};
+
+	#define PHILOX_LANES
+
+#endif
+
+#ifdef PHILOX_LANES
+
+	typedef PhiloxLanes L;
+
+	//Philox of blocks [block, block + width) as lanes; the low 32 bits of the block can't wrap
+	static inline void philoxLanes(u64 seed, u32 stream, u64 block, L::I &c0, L::I &c1, L::I &c2, L::I &c3) {
+
+		u32 k0 = u32(seed), k1 = u32(seed >> 32);
+
+		c0 = L::ramp(u32(block));
+		c1 = L::seti(u32(block >> 32));
+		c2 = L::seti(stream);
+		c3 = L::seti(0);
+
+		for (u32 i = 0; i < philoxRounds; ++i) {
+
+			L::I hi0, lo0, hi1, lo1;
+			L::mulhilo(philoxM0, c0, hi0, lo0);
+			L::mulhilo(philoxM1, c2, hi1, lo1);
+
+			c0 = L::xori(L::xori(hi1, c1), L::seti(k0));
+			c2 = L::xori(L::xori(hi0, c3), L::seti(k1));
+			c1 = lo1;
+			c3 = lo0;
+
+			k0 += philoxW0;
+			k1 += philoxW1;
+		}
+	}
+
+	static inline void philoxStore(f32 *out, const RandomFloatMap &map, L::I c0, L::I c1, L::I c2, L::I c3) {
+		L::store(out, L::mapFloat(c0, map), L::mapFloat(c1, map), L::mapFloat(c2, map), L::mapFloat(c3, map));
+	}
+
+	static inline void philoxStore(u32 *out, const RandomIntMap &map, L::I c0, L::I c1, L::I c2, L::I c3) {
+		L::store((f32*) out, L::cast(L::mapInt(c0, map)), L::cast(L::mapInt(c1, map)), L::cast(L::mapInt(c2, map)), L::cast(L::mapInt(c3, map)));
+	}
+
+#endif
+
+//Fills values [first, first + size) of a stream
+template<typename T, typename Map>
+static void philoxFill(u64 seed, u32 stream, u64 first, T *arr, u32 size, const Map &map) {
+
+	u32 block[4];
+
+	//Values before the first whole block
+
+	u32 i = 0;
+
+	if ((first & 3) != 0) {
+
+		RandomStream::generate(seed, stream, first >> 2, block);
+
+		for (u32 j = u32(first & 3); j < 4 && i < size; ++j, ++i)
+			arr[i] = map(block[j]);
+	}
+
+	u64 b = (first + i) >> 2;
+
+	#ifdef PHILOX_LANES
+
+		for (; i + L::width * 4 <= size; i += L::width * 4, b += L::width) {
+
+			//Lanes only have 32-bit adds; wrapping blocks go through the scalar path
+			if (u32(b) > u32_MAX - L::width)
+				break;
+
+			L::I c0, c1, c2, c3;
+			philoxLanes(seed, stream, b, c0, c1, c2, c3);
+			philoxStore(arr + i, map, c0, c1, c2, c3);
+		}
+
+	#endif
+
+	for (; i < size; ++b) {
+
+		RandomStream::generate(seed, stream, b, block);
+
+		for (u32 j = 0; j < 4 && i < size; ++j, ++i)
+			arr[i] = map(block[j]);
+	}
 }
 
-u32 Random::getSeed() { return seed; }
-u32 Random::getOffset() { return off - seed; }
+template<typename T, typename Map>
+static void philoxFillParallel(u64 seed, u32 stream, u64 first, T *arr, u32 size, const Map &map) {
+
+	if (size < randomParallel)
+		return philoxFill(seed, stream, first, arr, size, map);
 
-u32 Random::randU32() {
-	u32 a = off;
-	a = (a ^ 61) ^ (a >> 16);
-	a = a + (a << 3);
-	a = a ^ (a >> 4);
-	a = a * 0x27d4eb2d;
-	a = a ^ (a >> 15);
-	++off;
-	return a;
+	ThreadPool::get().parallelFor(0, (size + randomChunk - 1) / randomChunk, 1, [&](u32 i) {
+		u32 begin = i * randomChunk;
+		philoxFill(seed, stream, first + begin, arr + begin, std::min(size - begin, randomChunk), map);
+	});
 }
 
-u32 Random::randInt(u32 beg, u32 end) {
-	if (beg == end) return beg;
-	if (beg > end) {
-		u32 obeg = beg;
-		beg = end;
-		end = obeg;
+//RandomStream
+
+RandomStream::RandomStream(u64 seed, u32 stream) : seed(seed), stream(stream) {}
+
+void RandomStream::generate(u64 seed, u32 stream, u64 block, u32 out[4]) {
+
+	u32 k0 = u32(seed), k1 = u32(seed >> 32);
+	u32 c0 = u32(block), c1 = u32(block >> 32), c2 = stream, c3 = 0;
+
+	for (u32 i = 0; i < philoxRounds; ++i) {
+
+		u64 p0 = u64(philoxM0) * c0, p1 = u64(philoxM1) * c2;
+
+		c0 = u32(p1 >> 32) ^ c1 ^ k0;
+		c2 = u32(p0 >> 32) ^ c3 ^ k1;
+		c1 = u32(p1);
+		c3 = u32(p0);
+
+		k0 += philoxW0;
+		k1 += philoxW1;
 	}
-	if (end - beg <= RMAX_min) return randU32() % (end - beg + 1) + beg;
-	return randU32() % (end - beg + 1) + beg;
+
+	out[0] = c0;
+	out[1] = c1;
+	out[2] = c2;
+	out[3] = c3;
 }
 
-f32 Random::randFloat(f32 beg, f32 end) {
-	if (beg == end) return beg;
-	if (beg > end) {
-		f32 obeg = beg;
-		beg = end;
-		end = obeg;
-	}
-	f64 ri = (f64)randU32() / u32_MAX;
-	return (f32)(beg + (end - beg) * ri);
+u32 RandomStream::get(u64 i) const {
+	u32 block[4];
+	generate(seed, stream, i >> 2, block);
+	return block[i & 3];
+}
+
+u32 RandomStream::randU32() { return get(counter++); }
+u32 RandomStream::randInt(u32 beg, u32 end) { return RandomIntMap(beg, end)(get(counter++)); }
+f32 RandomStream::randFloat(f32 beg, f32 end) { return RandomFloatMap(beg, end)(get(counter++)); }
+
+void RandomStream::randomizeFloat(f32 *arr, u32 size, f32 beg, f32 end) {
+	fillFloat(counter, arr, size, beg, end);
+	counter += size;
+}
+
+void RandomStream::randomizeInt(u32 *arr, u32 size, u32 beg, u32 end) {
+	fillInt(counter, arr, size, beg, end);
+	counter += size;
+}
+
+void RandomStream::fillFloat(u64 first, f32 *arr, u32 size, f32 beg, f32 end) const {
+	philoxFillParallel(seed, stream, first, arr, size, RandomFloatMap(beg, end));
+}
+
+void RandomStream::fillInt(u64 first, u32 *arr, u32 size, u32 beg, u32 end) const {
+	philoxFillParallel(seed, stream, first, arr, size, RandomIntMap(beg, end));
+}
+
+RandomStream RandomStream::getStream(u32 id) const { return RandomStream(seed, id); }
+
+u64 RandomStream::getSeed() const { return seed; }
+u32 RandomStream::getStreamId() const { return stream; }
+
+u64 RandomStream::getCounter() const { return counter; }
+void RandomStream::setCounter(u64 c) { counter = c; }
+
+//Random
+
+RandomStream Random::stream;
+std::atomic<u64> Random::off(0);
+u32 Random::seed = 0;
+
+void Random::setSeed(u32 newSeed) {
+	seed = newSeed;
+	stream = RandomStream(newSeed);
+	off = 0;
 }
 
+void Random::seedRandom() {
+	setSeed(u32(Timer::getGlobalTimer().getTime().time_since_epoch().count() % u32_MAX));
+}
+
+u32 Random::getSeed() { return seed; }
+u32 Random::getOffset() { return u32(off); }
+
+u32 Random::randU32() { return stream.get(off++); }
+u32 Random::randInt(u32 beg, u32 end) { return RandomIntMap(beg, end)(stream.get(off++)); }
+f32 Random::randFloat(f32 beg, f32 end) { return RandomFloatMap(beg, end)(stream.get(off++)); }
+
 void Random::randomizeFloat(f32 *arr, u32 len, f32 beg, f32 end) {
-	for (u32 i = 0; i < len; ++i)
-		arr[i] = randFloat(beg, end);
+	stream.fillFloat(off.fetch_add(len), arr, len, beg, end);
 }
 
 void Random::randomizeInt(u32 *arr, u32 len, u32 beg, u32 end) {
-	for (u32 i = 0; i < len; ++i)
-		arr[i] = randInt(beg, end);
+	stream.fillInt(off.fetch_add(len), arr, len, beg, end);
+}
+
+RandomStream Random::getStream() {
+	RandomStream s = stream;
+	s.setCounter(off);
+	return s;
 }
\ No newline at end of file
@@ -64,6 +64,11 @@ namespace oi {
 			bool write(String path, String &s) const;
 			bool write(String path, Buffer b) const;
 
+			//Map a file into memory; the buffer is read-only and has to be released through unmap (not deconstruct)
+			//This avoids copying the file where the platform allows it (falls back to read otherwise)
+			bool map(String path, Buffer &b) const;
+			void unmap(Buffer &b) const;
+
 			bool mkdir(String path) const;
 			bool exists(String path) const;
 			bool fileExists(String path) const;
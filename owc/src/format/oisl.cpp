@@ -31,15 +31,17 @@ u32 SLFile::add(String name) {
 bool oiSL::read(String path, SLFile &file) {
 
 	Buffer buf;
-	FileManager::get()->read(path, buf);
+	FileManager::get()->map(path, buf);
 
 	if (buf.size() == 0)
 		return Log::error("Couldn't open file");
 
-	if (!read(buf, file))
+	if (!read(buf, file)) {
+		FileManager::get()->unmap(buf);
 		return Log::error("Couldn't read file");
+	}
 
-	buf.deconstruct();
+	FileManager::get()->unmap(buf);
 	return true;
 }
 
@@ -166,6 +166,10 @@ bool write(String path, T &t, const FileManager *fm) {
 bool FileManager::read(String path, String &s) const { return ::read(path, s, param, this); }
 bool FileManager::read(String path, Buffer &b) const { return ::read(path, b, param, this); }
 
+//Assets are stored in the apk; so they are copied instead of mapped
+bool FileManager::map(String path, Buffer &b) const { return ::read(path, b, param, this); }
+void FileManager::unmap(Buffer &b) const { b.deconstruct(); }
+
 bool FileManager::write(String path, String &s) const { return ::write(path, s, this); }
 bool FileManager::write(String path, Buffer b) const { return ::write(path, b, this); }
 
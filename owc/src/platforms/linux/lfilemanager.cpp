@@ -0,0 +1,282 @@
+#ifdef __LINUX__
+
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <cstring>
+#include <errno.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <unistd.h>
+#include "types/string.h"
+#include "types/buffer.h"
+#include "utils/log.h"
+#include "file/filemanager.h"
+using namespace oi::wc;
+using namespace oi;
+
+//Resources are loose files next to the executable (res/); mod/ refers to the same folder
+
+void FileManager::init() {}
+
+String FileManager::getAbsolutePath(String path) const {
+	return (path == "" ? "" : (path.startsWith("mod") ? String("res") + path.cutBegin(3) : path));
+}
+
+bool FileManager::canModifyAssets() const { return true; }
+
+bool FileManager::dirExists(String path) const {
+
+	if (!validate(path, FileAccess::QUERY)) return Log::error("Couldn't open folder for query");
+
+	struct stat attr;
+	return stat(getAbsolutePath(path).toCString(), &attr) == 0 && S_ISDIR(attr.st_mode);
+}
+
+bool FileManager::fileExists(String path) const {
+
+	if (!validate(path, FileAccess::QUERY)) return Log::error("Couldn't open file for query");
+
+	struct stat attr;
+	return stat(getAbsolutePath(path).toCString(), &attr) == 0 && S_ISREG(attr.st_mode);
+}
+
+bool FileManager::mkdir(String path) const {
+
+	if (!validate(path, FileAccess::WRITE)) return Log::error("Mkdir requires write access");
+
+	std::vector<String> split = getAbsolutePath(path).split("/");
+	String current;
+
+	for (String &s : split) {
+
+		if (current == "") current = s;
+		else current = current + "/" + s;
+
+		if (current != "" && ::mkdir(current.toCString(), 0755) < 0) {
+
+			if (errno == EEXIST) continue;
+
+			Log::error(strerror(errno));
+			return Log::error(String("Couldn't mkdir \"") + current + "\"");
+		}
+	}
+
+	return true;
+}
+
+//Open a file and query its size
+static int openFile(const FileManager *fm, String path, u32 &size) {
+
+	String apath = fm->getAbsolutePath(path);
+
+	int file = open(apath.toCString(), O_RDONLY);
+
+	if (file < 0) {
+		Log::error(String("Couldn't open file: ") + apath);
+		return -1;
+	}
+
+	struct stat attr;
+
+	if (fstat(file, &attr) != 0 || u64(attr.st_size) > u64(u32_MAX)) {
+		close(file);
+		Log::error(String("Couldn't read file; it's too big (") + apath + ")");
+		return -1;
+	}
+
+	size = u32(attr.st_size);
+	return file;
+}
+
+static bool readFile(int file, u8 *data, u32 size) {
+
+	for (u32 offset = 0; offset < size; ) {
+
+		ssize_t count = ::read(file, data + offset, size - offset);
+
+		if (count < 0 && errno == EINTR)
+			continue;
+
+		if (count <= 0)
+			return false;
+
+		offset += u32(count);
+	}
+
+	return true;
+}
+
+static bool writeFile(const FileManager *fm, String path, const u8 *data, u32 size) {
+
+	if (!fm->validate(path, FileAccess::WRITE)) return Log::error("Couldn't open file for write");
+	if (!fm->mkdir(path.getPath())) return Log::error("Can't write to file; mkdir failed");
+
+	String apath = fm->getAbsolutePath(path);
+	int file = open(apath.toCString(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+	if (file < 0)
+		return Log::error(String("Couldn't open file for write: ") + apath);
+
+	for (u32 offset = 0; offset < size; ) {
+
+		ssize_t count = ::write(file, data + offset, size - offset);
+
+		if (count < 0 && errno == EINTR)
+			continue;
+
+		if (count <= 0) {
+			close(file);
+			return Log::error(String("Couldn't write to file: ") + apath);
+		}
+
+		offset += u32(count);
+	}
+
+	close(file);
+	return true;
+}
+
+bool FileManager::read(String path, String &s) const {
+
+	if (!validate(path, FileAccess::READ)) return Log::error("Couldn't open file for read");
+
+	u32 size;
+	int file = openFile(this, path, size);
+
+	if (file < 0)
+		return Log::error("Couldn't open file for read");
+
+	s = String(size, '\0');
+	bool success = readFile(file, (u8*) s.toCString(), size);
+	close(file);
+
+	if (!success)
+		return Log::error(String("Couldn't read from file ") + path);
+
+	return true;
+}
+
+bool FileManager::read(String path, Buffer &b) const {
+
+	if (!validate(path, FileAccess::READ)) return Log::error("Couldn't open file for read");
+
+	u32 size;
+	int file = openFile(this, path, size);
+
+	if (file < 0)
+		return Log::error("Couldn't open file for read");
+
+	b = Buffer(size);
+
+	if (!readFile(file, b.addr(), size)) {
+		close(file);
+		b.deconstruct();
+		return Log::error(String("Couldn't read from file ") + path);
+	}
+
+	close(file);
+	return true;
+}
+
+bool FileManager::map(String path, Buffer &b) const {
+
+	if (!validate(path, FileAccess::READ)) return Log::error("Couldn't open file for map");
+
+	u32 size;
+	int file = openFile(this, path, size);
+
+	if (file < 0)
+		return Log::error("Couldn't open file for map");
+
+	//Can't map 0 bytes
+	if (size == 0) {
+		close(file);
+		b = {};
+		return true;
+	}
+
+	void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+
+	if (data == MAP_FAILED)
+		return Log::error(String("Couldn't map file ") + path);
+
+	//Files are generally parsed front to back; start reading them in and allow aggressive read-ahead
+	madvise(data, size, MADV_SEQUENTIAL);
+	madvise(data, size, MADV_WILLNEED);
+
+	b = Buffer::construct((u8*) data, size);
+	return true;
+}
+
+void FileManager::unmap(Buffer &b) const {
+
+	if (b.addr() != nullptr)
+		munmap(b.addr(), b.size());
+
+	b = {};
+}
+
+bool FileManager::write(String path, String &s) const { return writeFile(this, path, (const u8*) s.toCString(), s.size()); }
+bool FileManager::write(String path, Buffer b) const { return writeFile(this, path, b.addr(), b.size()); }
+
+bool FileManager::foreachFile(String path, FileCallback callback) const {
+
+	if (!validate(path, FileAccess::QUERY)) return Log::error("Couldn't open folder for query");
+	if (!dirExists(path)) return Log::error("Couldn't find the specified folder");
+
+	DIR *dir = opendir(getAbsolutePath(path).toCString());
+
+	if (dir == nullptr)
+		return Log::error("Couldn't find directory");
+
+	struct dirent *subdir;
+
+	while ((subdir = readdir(dir)) != nullptr) {
+
+		String fileName = subdir->d_name;
+
+		if (fileName == "." || fileName == "..")
+			continue;
+
+		String filePath = path + "/" + fileName;
+
+		//d_type isn't filled in by every file system; stat is needed for the size and time anyways
+		struct stat attr;
+
+		if (stat(getAbsolutePath(filePath).toCString(), &attr) != 0)
+			continue;
+
+		bool isDir = S_ISDIR(attr.st_mode);
+
+		if (!isDir && !S_ISREG(attr.st_mode))	//Only allow actual files
+			continue;
+
+		FileInfo info = FileInfo(isDir, filePath, attr.st_mtime, isDir ? 0 : (u64) attr.st_size);
+
+		if (callback(info))
+			break;
+
+	}
+
+	closedir(dir);
+	return true;
+}
+
+FileInfo FileManager::getFile(String path) const {
+
+	if (!validate(path, FileAccess::QUERY)) { Log::error("Couldn't open file for query"); return {}; }
+
+	struct stat attr;
+
+	if (stat(getAbsolutePath(path).toCString(), &attr) != 0 || (!S_ISDIR(attr.st_mode) && !S_ISREG(attr.st_mode))) {
+		Log::error("Couldn't find the specified file");
+		return {};
+	}
+
+	bool isFolder = S_ISDIR(attr.st_mode);
+	return FileInfo(isFolder, path, attr.st_mtime, isFolder ? 0 : (u64) attr.st_size);
+
+}
+
+#endif
\ No newline at end of file
@@ -195,6 +195,74 @@ bool FileManager::read(String file, Buffer &b) const {
 	return true;
 }
 
+bool FileManager::map(String file, Buffer &b) const {
+
+	if (!validate(file, FileAccess::READ)) return Log::error("Couldn't open file for map");
+
+	//Resources are already in memory; so they don't have to be copied
+
+	if (file.startsWith("res")) {
+
+		HRSRC data = FindResourceA(nullptr, file.toCString(), RT_RCDATA);
+
+		if (data == nullptr)
+			return Log::error("Couldn't find resource");
+
+		u32 size = (u32) SizeofResource(nullptr, data);
+		HGLOBAL handle = LoadResource(nullptr, data);
+
+		if (handle == nullptr)
+			return Log::error("Couldn't load resource");
+
+		b = Buffer::construct((u8*) LockResource(handle), size);
+		return true;
+	}
+
+	HANDLE handle = CreateFileA(getAbsolutePath(file).toCString(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+	if (handle == INVALID_HANDLE_VALUE)
+		return Log::error(String("Couldn't open file: ") + file);
+
+	LARGE_INTEGER size;
+
+	if (!GetFileSizeEx(handle, &size) || u64(size.QuadPart) > u64(u32_MAX)) {
+		CloseHandle(handle);
+		return Log::error(String("Couldn't map file; it's too big (") + file + ")");
+	}
+
+	//Can't map 0 bytes
+	if (size.QuadPart == 0) {
+		CloseHandle(handle);
+		b = {};
+		return true;
+	}
+
+	HANDLE mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(handle);
+
+	if (mapping == nullptr)
+		return Log::error(String("Couldn't map file ") + file);
+
+	//The view keeps the mapping alive
+	void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+
+	if (data == nullptr)
+		return Log::error(String("Couldn't map file ") + file);
+
+	b = Buffer::construct((u8*) data, u32(size.QuadPart));
+	return true;
+}
+
+void FileManager::unmap(Buffer &b) const {
+
+	//Resources aren't views; UnmapViewOfFile fails on those and they don't have to be freed
+	if (b.addr() != nullptr)
+		UnmapViewOfFile(b.addr());
+
+	b = {};
+}
+
 bool FileManager::write(String file, String &s) const {
 
 	if (!validate(file, FileAccess::WRITE)) return Log::error("Couldn't open file for write");